@@ -6,17 +6,25 @@
 #include <algorithm>    // transform
 #include <stdexcept>    // runtime_error
 #include <memory>       // shared_ptr     
+#include <future>       // future
 
 #include "Game.h"
 #include "Chess_API_vars.h"
 #include "Human_Player.h"
 #include "Computer_Player.h"
+#include "Cancellation_Token.h"
+#include "Thread_Pool.h"
+#include "Game_Record.h"
 
 namespace Chess_API {
     class Chess {
     private:
         Game * game = nullptr;                                          // Object containing the game details such as board and game pieces
-        std::vector<std::pair<std::string, std::string>> played_moves;  // Past moves played - allows for showing a play-by-play of how the game has gone as well as serializing the game to play later
+        std::vector<board_move> played_moves;                           // Past moves played - allows for showing a play-by-play of how the game has gone as well as serializing the game to play later
+        std::string start_fen;                                          // Position played_moves start from - empty for the standard starting position
+        std::shared_ptr<Computer_Player> computer_player;               // The computer opponent - nullptr when two humans are playing
+        std::future<std::pair<std::string, std::string>> pending_turn;  // Move of the turn started by start_turn - invalid when no turn is being played
+        std::shared_ptr<Cancellation_Token> pending_token;              // Token of the turn started by start_turn
 
         /* Determines if the provided input is a valid player input or not - used in conjunction with the player class to get player input
         *  The correct format for player input should be a string pair, indicating the starting position and the ending postion
@@ -24,6 +32,16 @@ namespace Chess_API {
         *  This functions determines if the correct formatting was used for the player input
         */
         bool is_valid_player_input(std::pair<std::string, std::string>) const;
+
+        // Validates the players move and plays it - throws a runtime_error for badly formatted input or an invalid move
+        void play_player_move(const std::pair<std::string, std::string>& new_move);
+
+        // Converts player input such as {e2, e4} into board positions - the input must already be valid
+        static board_move parse_player_input(const std::pair<std::string, std::string>& input);
+
+        // Sets up the starting position of the record and plays its moves straight through make_move - the game takes over the moves
+        // Nothing is validated so the moves must have come from a game that was actually played such as one read by decode_game_record
+        void replay_record(game_record& record);
     public:
         // Default constructor to start a blank new game with a human vs a computer of default difficulty
         Chess();
@@ -37,14 +55,45 @@ namespace Chess_API {
         // Destructor that deletes all game data
         ~Chess();
 
-        // Constructor that can regenerate the game from the game_in and past_moves
+        // Constructor that can regenerate the game from the game_in and past_moves - both are moved from so pass them with std::move to avoid copies
+        // game_in holds the players and the position past_moves start from - the moves are replayed on it so the board always matches the history
+        // Throws a runtime_error if a move isn't valid player input - the moves themselves are trusted like any other record
         Chess(Game game_in, std::vector<std::pair<std::string, std::string>> past_moves);
 
+        // Restores a suspended game between two human players by replaying its record - pass the record with std::move to avoid copying the moves
+        // The moves are trusted rather than validated - they must come from a game that was actually played
+        Chess(game_record record, std::string player_name1, std::string player_name2);
+
+        // Restores a suspended game against the computer by replaying its record - the human has the white pieces as with a new game
+        // The moves are trusted rather than validated - they must come from a game that was actually played
+        Chess(game_record record, std::string player_name, DIFFICULTY difficulty);
+
         /*  Plays the next turn of the game - allows for the next determined player to input their moves into the game
         *   Plays out the moves, assuming they are valid, and changes the game state accordingly
         */ 
         void play_turn();
 
+        /*  Starts the next turn without waiting for the player - the move is played by poll_turn once the player has decided
+        *   The token lets the caller cancel the turn or give it a deadline - a new token without a deadline is used if none is given
+        *   Throws a runtime_error if the last turn is still being played
+        */
+        void start_turn(std::shared_ptr<Cancellation_Token> token = nullptr);
+
+        /*  Checks on the turn started by start_turn without blocking - returns true once the move has been played
+        *   Once the token is cancelled or past its deadline the player is asked to finish - a human without a move ends the turn with a runtime_error
+        *   Rethrows the runtime_error of a cancelled turn or an invalid move - the turn is over either way
+        */
+        bool poll_turn();
+
+        // Cancels the turn started by start_turn - poll_turn reports how it ended
+        void cancel_turn();
+
+        // Determines if a turn started by start_turn is still waiting to be polled
+        bool is_turn_pending() const {return pending_turn.valid();}
+
+        // Shares a thread pool for the computer player to think on so many games can be driven by a few threads
+        void set_thread_pool(std::shared_ptr<Thread_Pool> thread_pool);
+
         // Determines if the game is currently in a state of check
         bool is_in_check() const;
 
@@ -54,11 +103,20 @@ namespace Chess_API {
         // Determines if the game is currently in a check mate state - indicating the game is over
         bool is_in_check_mate() const;
 
+        // Determines if the game is drawn - by stalemate, threefold repetition or the fifty move rule
+        bool is_draw() const;
+
+        // Determines if the game is over - either by check mate or a draw
+        bool is_game_over() const;
+
         // Returns the current player
         const std::shared_ptr<Player> get_current_player() const;
 
         // Displays the board to the console
         void show_board() const;
+
+        // Returns the moves played so far with the position they started from and the result as a record for encode_game_record
+        game_record get_game_record() const;
     };
 }
     
@@ -1,7 +1,15 @@
 #include "Chess.h"
+#include "Evaluation_Tuner.h"
+#include "Tournament.h"
+#include "PGN_Pipeline.h"
+#include "Data_Generator.h"
+#include "EPD_Suite.h"
+#include "Position_Index.h"
+#include "Opening_Tree.h"
 #include "Play_Chess_Config.h"
 
 #include <iostream>
+#include <filesystem>   // create_directories
 
 #ifdef RUN_TESTS
 #   include "Chess_test.h"
@@ -54,6 +62,16 @@ int main(int argc, const char **argv) {
     if (argc == 1) {
         std::cout << "Chess version " << Play_Chess_VERSION_MAJOR << "." << Play_Chess_VERSION_MINOR << std::endl;
         std::cout << "Usage: Chess {Play} -> Launches the chess game... (More options to come...)" << std::endl;
+        std::cout << "       Chess {Bitbase} [directory] -> Generates the endgame bitbases used by the computer player into the directory (default \"" << DEFAULT_BITBASE_DIRECTORY << "\")" << std::endl;
+        std::cout << "       Chess {Playouts} [threads] [milliseconds] -> Benchmarks the Monte Carlo engine from the opening position (default every core for 5000 ms)" << std::endl;
+        std::cout << "       Chess {Tune} {positions file} [iterations] [threads] -> Fits the evaluation weights to the results of the labelled positions (default 1000 iterations on every core)" << std::endl;
+        std::cout << "       Chess {Tournament} [games] [first difficulty] [second difficulty] [threads] -> Plays the two difficulties against each other until the games run out or the SPRT decides (default 1000 games of 1 vs 0 on every core)" << std::endl;
+        std::cout << "       Chess {Pgn} {games file} [threads] -> Replays every game of the PGN file and counts the results and the games that can't be played (default every core)" << std::endl;
+        std::cout << "       Chess {Epd} {suite file} [milliseconds] [threads] -> Solves every bm and am position of the EPD suite and reports the solved count and time to solution (default 1000 ms a position on every core)" << std::endl;
+        std::cout << "       Chess {Index} {games file} {index file} -> Replays every game of the PGN file and writes an index of the positions reached to the games they were reached in" << std::endl;
+        std::cout << "       Chess {Lookup} {index file} {FEN} -> Shows how often the position was reached in the indexed games and how those games ended" << std::endl;
+        std::cout << "       Chess {Tree} {games file} {tree file} [plies] [threads] -> Writes the moves played from each position of the games openings with how often and how well they scored - read by the computer player as a book (default 20 plies on every core)" << std::endl;
+        std::cout << "       Chess {Datagen} {output file} [games] [nodes] [threads] -> Plays the engine against itself and writes the packed positions with their scores and results - one file per thread (default 1000 games of 5000 nodes a move on every core)" << std::endl;
     } else {
         std::string input = argv[1];
 
@@ -63,6 +81,142 @@ int main(int argc, const char **argv) {
         if (input == "play") {
             Chess new_game;
             std::cout << "New chess game made successfully!" << std::endl;
+        } else if (input == "bitbase") {
+            std::string directory = argc > 2 ? argv[2] : DEFAULT_BITBASE_DIRECTORY;
+            std::filesystem::create_directories(directory);
+
+            // Uses every core available - KBNK is by far the largest and takes the bulk of the time
+            Bitbase_Generator generator;
+            generator.generate_all(directory);
+            std::cout << "Bitbases generated in " << directory << std::endl;
+        } else if (input == "playouts") {
+            std::shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+            std::shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            Game game(player1, player2);
+            game.setup_default_board_state();
+
+            monte_carlo_limits limits;
+            limits.threads = argc > 2 ? std::stoi(argv[2]) : 0;
+            limits.move_time_ms = argc > 3 ? std::stoi(argv[3]) : 5000;
+
+            Monte_Carlo_Searcher searcher;
+            monte_carlo_result result = searcher.search(game, limits);
+            std::cout << "Playouts: " << result.playouts << " on " << result.threads << " threads in " << result.elapsed_ms << " ms" << std::endl;
+            std::cout << "Playouts per second: " << result.playouts_per_second << std::endl;
+            std::cout << "Playouts per second per thread: " << result.playouts_per_second_per_thread << std::endl;
+            std::cout << "Tree nodes: " << result.tree_nodes << std::endl;
+        } else if (input == "tune" && argc > 2) {
+            tuning_limits limits;
+            limits.iterations = argc > 3 ? std::stoi(argv[3]) : limits.iterations;
+            limits.threads = argc > 4 ? std::stoi(argv[4]) : 0;
+
+            Evaluation_Tuner tuner;
+            size_t loaded = tuner.load_positions(argv[2]);
+            std::cout << "Positions: " << loaded << std::endl;
+
+            double scaling = tuner.fit_scaling(limits.threads);
+            double start_error = tuner.compute_error(tuner.get_weights(), limits.threads);
+            tuning_weights weights = tuner.tune(limits);
+            std::cout << "Scaling: " << scaling << std::endl;
+            std::cout << "Error: " << start_error << " -> " << tuner.compute_error(weights, limits.threads) << std::endl;
+
+            // Printed as the values to copy into EVALUATION_WEIGHTS
+            for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+                std::cout << EVALUATION_TERM_NAMES[i] << ": " << EVALUATION_WEIGHTS[i] << " -> " << static_cast<int>(weights[i] + (weights[i] < 0 ? -0.5 : 0.5)) << std::endl;
+            }
+        } else if (input == "tournament") {
+            tournament_limits limits;
+            limits.games = argc > 2 ? std::stoi(argv[2]) : limits.games;
+            limits.threads = argc > 5 ? std::stoi(argv[5]) : 0;
+
+            // Difficulties are given by their number - 0 is VERY_EASY
+            tournament_engine first;
+            tournament_engine second;
+            first.difficulty = static_cast<DIFFICULTY>(argc > 3 ? std::stoi(argv[3]) : DIFFICULTY::EASY);
+            second.difficulty = static_cast<DIFFICULTY>(argc > 4 ? std::stoi(argv[4]) : DIFFICULTY::VERY_EASY);
+
+            Tournament tournament(first, second);
+            tournament_result result = tournament.run(limits, [](const tournament_result& standing) {
+                std::cout << "Games: " << standing.wins + standing.draws + standing.losses << " +" << standing.wins << " =" << standing.draws << " -" << standing.losses
+                    << " Elo: " << standing.elo << " +/- " << standing.elo_error << " LLR: " << standing.llr
+                    << " (" << standing.lower_bound << ", " << standing.upper_bound << ")" << std::endl;
+            });
+
+            std::string verdict = result.sprt_result == SPRT_ACCEPT_H1 ? "H1 accepted - the first engine is stronger"
+                : (result.sprt_result == SPRT_ACCEPT_H0 ? "H0 accepted - the first engine is not stronger" : "No decision");
+            std::cout << "SPRT: " << verdict << " after " << result.elapsed_ms << " ms" << std::endl;
+        } else if (input == "pgn" && argc > 2) {
+            pgn_pipeline_limits limits;
+            limits.threads = argc > 3 ? std::stoi(argv[3]) : 0;
+
+            int64_t start_ms = steady_time_ms();
+            PGN_Pipeline pipeline(argv[2]);
+            pgn_chunk_result total = pipeline.run(limits);
+            std::cout << "Games: " << total.games << " with " << total.moves << " moves in " << steady_time_ms() - start_ms << " ms" << std::endl;
+            std::cout << "Results: +" << total.white_wins << " =" << total.draws << " -" << total.black_wins << " unfinished " << total.no_results << std::endl;
+            std::cout << "Games with a move that can't be played: " << total.unplayable_games << std::endl;
+        } else if (input == "epd" && argc > 2) {
+            epd_limits limits;
+            limits.move_time_ms = argc > 3 ? std::stoi(argv[3]) : limits.move_time_ms;
+            limits.threads = argc > 4 ? std::stoi(argv[4]) : 0;
+
+            EPD_Suite suite;
+            size_t loaded = suite.load(argv[2]);
+            std::cout << "Positions: " << loaded << std::endl;
+            epd_summary summary = suite.run(limits, [](const epd_position& position, const epd_result& result) {
+                std::string name = position.id.empty() ? "#" + std::to_string(result.index + 1) : position.id;
+                std::cout << name << ": " << (result.solved ? "solved" : "failed") << " with "
+                    << (result.best_move.first.first != -1 ? move_to_string(result.best_move) : "no move")
+                    << " depth " << result.depth;
+                if (result.solved) {
+                    std::cout << " - found at depth " << result.solve_depth << " after " << result.solve_nodes << " nodes and " << result.solve_ms << " ms";
+                }
+                std::cout << std::endl;
+            });
+            std::cout << "Solved: " << summary.solved << " / " << summary.positions << " - " << summary.solve_ms << " ms and "
+                << summary.solve_nodes << " nodes to solution in total - " << summary.elapsed_ms << " ms overall" << std::endl;
+        } else if (input == "index" && argc > 3) {
+            int64_t start_ms = steady_time_ms();
+            Position_Index_Builder builder;
+            size_t games = builder.add_pgn(argv[2]);
+            builder.write(argv[3]);
+            std::cout << "Indexed " << games << " games in " << steady_time_ms() - start_ms << " ms" << std::endl;
+        } else if (input == "lookup" && argc > 3) {
+            Position_Index index(argv[2]);
+            std::shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+            std::shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            Game game(player1, player2);
+            game.from_fen(argv[3]);
+
+            position_stats stats;
+            if (index.find(game.get_hash_key(), stats)) {
+                std::cout << "Games: " << stats.games << " +" << stats.white_wins << " =" << stats.draws << " -" << stats.black_wins << std::endl;
+            } else {
+                std::cout << "The position isn't in any of the " << index.get_position_count() << " indexed positions" << std::endl;
+            }
+        } else if (input == "tree" && argc > 3) {
+            opening_tree_limits limits;
+            limits.max_plies = argc > 4 ? std::stoi(argv[4]) : limits.max_plies;
+            limits.threads = argc > 5 ? std::stoi(argv[5]) : 0;
+
+            int64_t start_ms = steady_time_ms();
+            size_t games = Opening_Tree::build(argv[2], argv[3], limits);
+            Opening_Tree tree(argv[3]);
+            std::cout << "Read " << games << " games into " << tree.get_entry_count() << " moves in " << steady_time_ms() - start_ms << " ms" << std::endl;
+        } else if (input == "datagen" && argc > 2) {
+            datagen_limits limits;
+            limits.games = argc > 3 ? std::stoi(argv[3]) : limits.games;
+            limits.nodes = argc > 4 ? std::stoull(argv[4]) : limits.nodes;
+            limits.threads = argc > 5 ? std::stoi(argv[5]) : 0;
+
+            Data_Generator generator(argv[2]);
+            datagen_result result = generator.run(limits, [](const datagen_result& progress) {
+                if (progress.games % 100 == 0) {
+                    std::cout << "Games: " << progress.games << " Positions: " << progress.positions << " in " << progress.elapsed_ms << " ms" << std::endl;
+                }
+            });
+            std::cout << "Games: " << result.games << " +" << result.white_wins << " =" << result.draws << " -" << result.black_wins << std::endl;
+            std::cout << "Positions: " << result.positions << " in " << result.elapsed_ms << " ms written to " << Data_Generator::get_shard_path(argv[2], 0) << " and on" << std::endl;
         }
     }
 
@@ -0,0 +1,140 @@
+#include "Batch_Analyzer.h"
+
+#include <atomic>               // std::atomic
+#include <condition_variable>   // std::condition_variable
+#include <exception>            // std::exception_ptr
+
+namespace Chess_API {
+    // Everything the workers of a single batch share - lives on the stack of analyze_batch until every worker has finished
+    struct batch_state {
+        const std::vector<Game> * positions = nullptr;
+        search_limits limits;
+        std::atomic<size_t> next_position;              // Next position a worker may claim
+        std::atomic<bool> abandoned;                    // Set once the batch has failed - workers stop claiming positions
+        std::mutex results_mutex;                       // Guards everything below
+        std::condition_variable result_ready;           // Signalled when a result is stored or a worker finishes
+        std::vector<search_result> results;
+        std::vector<char> ready;                        // Whether each result has been stored
+        std::vector<std::exception_ptr> errors;         // Exception thrown while searching each position
+        unsigned int workers_running = 0;
+    };
+
+    // Runs on the thread pool - nullptr creates a pool with one worker per core
+    Batch_Analyzer::Batch_Analyzer(std::shared_ptr<Thread_Pool> thread_pool_in, size_t table_entries_in)
+        : thread_pool(thread_pool_in), bitbases(Bitbase_Set::get_default()), table_entries(table_entries_in) {
+        if (thread_pool == nullptr) {
+            thread_pool = std::make_shared<Thread_Pool>();
+        }
+    }
+
+    // Replaces the bitbases probed by every worker - nullptr disables probing - not safe while a batch is running
+    void Batch_Analyzer::set_bitbases(std::shared_ptr<const Bitbase_Set> bitbases_in) {
+        std::lock_guard<std::mutex> lock(batch_mutex);
+        bitbases = bitbases_in;
+        for (int i = 0; i < workers.size(); ++i) {
+            workers[i]->searcher->set_bitbases(bitbases_in);
+        }
+    }
+
+    // Searches every position within the limits and hands each result to on_result in the order of the positions
+    // on_result runs on the calling thread as soon as the next result in order is ready - later results wait until then
+    // Each position is searched with a cleared table so a result never depends on which worker searched it
+    // Throws whatever a search or on_result threw once the workers have stopped - the rest of the batch is abandoned
+    void Batch_Analyzer::analyze_batch(const std::vector<Game>& positions, const search_limits& limits, analysis_callback on_result) {
+        std::lock_guard<std::mutex> batch_lock(batch_mutex);
+        if (positions.empty()) {
+            return;
+        }
+
+        while (workers.size() < thread_pool->get_thread_count()) {
+            std::unique_ptr<analysis_worker> worker(new analysis_worker());
+            worker->table = std::make_shared<Transposition_Table>(table_entries);
+            worker->searcher.reset(new Searcher(worker->table, bitbases));
+            workers.push_back(std::move(worker));
+        }
+
+        batch_state state;
+        state.positions = &positions;
+        state.limits = limits;
+        state.next_position = 0;
+        state.abandoned = false;
+        state.results.resize(positions.size());
+        state.ready.assign(positions.size(), 0);
+        state.errors.resize(positions.size());
+
+        // No more workers than positions - each one pulls positions until none are left
+        unsigned int worker_count = positions.size() < workers.size() ? positions.size() : workers.size();
+        state.workers_running = worker_count;
+        for (unsigned int w = 0; w < worker_count; ++w) {
+            analysis_worker * worker = workers[w].get();
+            thread_pool->submit([&state, worker]() {
+                while (!state.abandoned) {
+                    size_t index = state.next_position++;
+                    if (index >= state.positions->size()) {
+                        break;
+                    }
+
+                    search_result result;
+                    std::exception_ptr error;
+                    try {
+                        // The other workers already keep every core busy so the table is cleared on this thread alone
+                        worker->table->clear(1);
+                        result = worker->searcher->search((*state.positions)[index], state.limits);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+
+                    std::lock_guard<std::mutex> lock(state.results_mutex);
+                    state.results[index] = std::move(result);
+                    state.errors[index] = error;
+                    state.ready[index] = 1;
+                    state.result_ready.notify_all();
+                }
+
+                // The batch state may go away as soon as the last worker is counted out
+                std::lock_guard<std::mutex> lock(state.results_mutex);
+                --state.workers_running;
+                state.result_ready.notify_all();
+            });
+        }
+
+        // Results are handed out in order as they become ready
+        std::exception_ptr failure;
+        for (size_t index = 0; index < positions.size() && failure == nullptr; ++index) {
+            search_result result;
+            {
+                std::unique_lock<std::mutex> lock(state.results_mutex);
+                state.result_ready.wait(lock, [&state, index]() {return state.ready[index] != 0;});
+                failure = state.errors[index];
+                result = std::move(state.results[index]);
+            }
+
+            if (failure == nullptr) {
+                try {
+                    on_result(index, result);
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+
+        if (failure != nullptr) {
+            state.abandoned = true;
+        }
+
+        std::unique_lock<std::mutex> lock(state.results_mutex);
+        state.result_ready.wait(lock, [&state]() {return state.workers_running == 0;});
+        if (failure != nullptr) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // Searches every position within the limits and returns the results in the order of the positions
+    std::vector<search_result> Batch_Analyzer::analyze_batch(const std::vector<Game>& positions, const search_limits& limits) {
+        std::vector<search_result> results(positions.size());
+        analyze_batch(positions, limits, [&results](size_t index, const search_result& result) {
+            results[index] = result;
+        });
+        return results;
+    }
+}
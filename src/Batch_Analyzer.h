@@ -0,0 +1,62 @@
+#ifndef CPLUSPLUS_CHESS_BATCH_ANALYZER
+#define CPLUSPLUS_CHESS_BATCH_ANALYZER
+
+#include <vector>
+#include <memory>       // std::shared_ptr, std::unique_ptr
+#include <functional>   // std::function
+#include <mutex>        // std::mutex
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Bitbase.h"
+#include "Search.h"
+#include "Transposition_Table.h"
+#include "Thread_Pool.h"
+
+namespace Chess_API {
+    // Entries in the transposition table of each analysis worker
+    const size_t DEFAULT_ANALYSIS_TABLE_ENTRIES = size_t(1) << 16;
+
+    // Called with the index of the position in the batch and its result
+    typedef std::function<void(size_t, const search_result&)> analysis_callback;
+
+    // Searches many positions at once by fanning them out over a persistent thread pool
+    // Every pool thread gets its own searcher and transposition table which are kept between batches
+    // so a box is kept busy without anyone writing their own threading around Game
+    class Batch_Analyzer {
+    public:
+        // Runs on the thread pool - nullptr creates a pool with one worker per core
+        Batch_Analyzer(std::shared_ptr<Thread_Pool> thread_pool_in = nullptr, size_t table_entries_in = DEFAULT_ANALYSIS_TABLE_ENTRIES);
+
+        // Searches every position within the limits and hands each result to on_result in the order of the positions
+        // on_result runs on the calling thread as soon as the next result in order is ready - later results wait until then
+        // Each position is searched with a cleared table so a result never depends on which worker searched it
+        // Throws whatever a search or on_result threw once the workers have stopped - the rest of the batch is abandoned
+        // Must not be called from one of the pool's own threads or the batch may wait on itself
+        void analyze_batch(const std::vector<Game>& positions, const search_limits& limits, analysis_callback on_result);
+
+        // Searches every position within the limits and returns the results in the order of the positions
+        std::vector<search_result> analyze_batch(const std::vector<Game>& positions, const search_limits& limits);
+
+        // Replaces the bitbases probed by every worker - nullptr disables probing - not safe while a batch is running
+        void set_bitbases(std::shared_ptr<const Bitbase_Set> bitbases_in);
+
+        // Returns the number of workers positions are spread over
+        unsigned int get_worker_count() const {return thread_pool->get_thread_count();}
+
+    private:
+        // Search state owned by a single worker
+        struct analysis_worker {
+            std::shared_ptr<Transposition_Table> table;     // Cleared before each position
+            std::unique_ptr<Searcher> searcher;             // Keeps its scratch memory between positions
+        };
+
+        std::shared_ptr<Thread_Pool> thread_pool;                   // Runs the workers
+        std::shared_ptr<const Bitbase_Set> bitbases;                // Endgame bitbases probed by every worker
+        size_t table_entries;                                       // Entries in each workers table
+        std::vector<std::unique_ptr<analysis_worker>> workers;      // One per pool thread - created on the first batch
+        std::mutex batch_mutex;                                     // Lets only one batch use the workers at a time
+    };
+}
+
+#endif
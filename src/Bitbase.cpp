@@ -0,0 +1,484 @@
+#include "Bitbase.h"
+#include "Thread_Pool.h"
+
+#include <atomic>       // std::atomic
+#include <fstream>      // std::ofstream
+#include <cstring>      // memcpy, memcmp
+
+namespace Chess_API {
+    // The non-king pieces held by the strong side for each endgame - in the order they are stored in the index
+    static const std::vector<GAME_PIECE_TYPE> BITBASE_PIECES[BITBASE_ENDGAME_COUNT] = {
+        {PAWN},
+        {ROOK},
+        {QUEEN},
+        {BISHOP, KNIGHT}
+    };
+
+    static const int BITBASE_MAX_PIECES = 2;                        // Most pieces the strong side holds besides its king in any endgame
+    static const char BITBASE_MAGIC[4] = {'C', 'B', 'B', '1'};      // Identifies a bitbase file
+    static const size_t BITBASE_HEADER_SIZE = 16;                   // Magic, endgame and entry count
+    static const uint64_t BITBASE_POSITIONS_PER_BLOCK = 4096;       // Positions a generator thread claims at a time
+    static const unsigned char BITBASE_UNRESOLVED = 4;              // In-memory marker for positions not yet proven won or lost
+
+    // Returns the number of squares stored per position - both kings plus the strong sides pieces
+    static int bitbase_square_count(BITBASE_ENDGAME endgame) {
+        return 2 + static_cast<int>(BITBASE_PIECES[endgame].size());
+    }
+
+    // Returns the number of positions in the endgame
+    // The index is the side to move (0 for the strong side) followed by six bits per square - strong king, weak king, then each piece
+    // Squares are numbered x * 8 + y to match the game boards rows and columns
+    static uint64_t bitbase_entries(BITBASE_ENDGAME endgame) {
+        return uint64_t(2) << (6 * bitbase_square_count(endgame));
+    }
+
+    // Splits the index back into the side to move and the squares of each piece
+    static int decode_bitbase_index(BITBASE_ENDGAME endgame, uint64_t index, int * squares) {
+        int square_count = bitbase_square_count(endgame);
+        for (int k = square_count - 1; k >= 0; --k) {
+            squares[k] = static_cast<int>(index & 63);
+            index >>= 6;
+        }
+        return static_cast<int>(index);
+    }
+
+    // Builds the index from the side to move and the squares of each piece
+    static uint64_t encode_bitbase_index(BITBASE_ENDGAME endgame, int side, const int * squares) {
+        uint64_t index = side;
+        for (int k = 0; k < bitbase_square_count(endgame); ++k) {
+            index = (index << 6) | squares[k];
+        }
+        return index;
+    }
+
+    // Reads a result out of the packed results - four results to a byte
+    static BITBASE_RESULT read_packed_result(const unsigned char * packed, uint64_t index) {
+        return static_cast<BITBASE_RESULT>((packed[index >> 2] >> ((index & 3) * 2)) & 3);
+    }
+
+    // Determines which endgame the game is in and the index of its position
+    // The board is mirrored when black is the strong side so that the strong side always plays up the board as white does
+    // Probed at every node of a search so the pieces are gathered into fixed arrays rather than anything that allocates
+    // Returns false if the material does not match any endgame
+    static bool read_bitbase_position(const Game& game, BITBASE_ENDGAME& endgame, uint64_t& index) {
+        std::pair<int, int> kings[2] = {std::make_pair(-1, -1), std::make_pair(-1, -1)};
+        std::pair<GAME_PIECE_TYPE, std::pair<int, int>> pieces[2][BITBASE_MAX_PIECES];
+        int piece_counts[2] = {0, 0};
+
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece piece = game.get_location(std::make_pair(i, j));
+                if (!game.validate_game_piece(piece)) {
+                    continue;
+                }
+
+                int color_index = piece.color == WHITE ? 0 : 1;
+                if (piece.type == KING) {
+                    kings[color_index] = std::make_pair(i, j);
+                } else if (piece_counts[color_index] == BITBASE_MAX_PIECES) {
+                    // More material than any endgame holds
+                    return false;
+                } else {
+                    pieces[color_index][piece_counts[color_index]++] = std::make_pair(piece.type, std::make_pair(i, j));
+                }
+            }
+        }
+
+        // Exactly one side may hold pieces other than its king
+        if (kings[0].first == -1 || kings[1].first == -1 || (piece_counts[0] == 0) == (piece_counts[1] == 0)) {
+            return false;
+        }
+
+        int strong = piece_counts[0] == 0 ? 1 : 0;
+        int strong_count = piece_counts[strong];
+
+        // Find the endgame with the same material - ordering the pieces as they are stored in the index
+        int matched = -1;
+        std::pair<GAME_PIECE_TYPE, std::pair<int, int>> ordered[BITBASE_MAX_PIECES];
+        for (int e = 0; e < BITBASE_ENDGAME_COUNT && matched == -1; ++e) {
+            const std::vector<GAME_PIECE_TYPE>& endgame_pieces = BITBASE_PIECES[e];
+            if (endgame_pieces.size() != strong_count) {
+                continue;
+            }
+
+            int ordered_count = 0;
+            bool used[BITBASE_MAX_PIECES] = {};
+            for (int k = 0; k < endgame_pieces.size(); ++k) {
+                for (int l = 0; l < strong_count; ++l) {
+                    if (!used[l] && pieces[strong][l].first == endgame_pieces[k]) {
+                        used[l] = true;
+                        ordered[ordered_count++] = pieces[strong][l];
+                        break;
+                    }
+                }
+            }
+
+            if (ordered_count == endgame_pieces.size()) {
+                matched = e;
+            }
+        }
+
+        if (matched == -1) {
+            return false;
+        }
+
+        // Mirroring the rows when black is the strong side
+        auto to_square = [strong](const std::pair<int, int>& position) {
+            int x = strong == 0 ? position.first : DEFAULT_CHESS_BOARD_SIZE - 1 - position.first;
+            return x * DEFAULT_CHESS_BOARD_SIZE + position.second;
+        };
+
+        int squares[2 + BITBASE_MAX_PIECES];
+        squares[0] = to_square(kings[strong]);
+        squares[1] = to_square(kings[1 - strong]);
+        for (int k = 0; k < strong_count; ++k) {
+            squares[2 + k] = to_square(ordered[k].second);
+        }
+
+        GAME_PIECE_COLOR strong_color = strong == 0 ? WHITE : BLACK;
+        int side = game.get_current_player()->get_player_color() == strong_color ? 0 : 1;
+
+        endgame = static_cast<BITBASE_ENDGAME>(matched);
+        index = encode_bitbase_index(endgame, side, squares);
+        return true;
+    }
+
+    // A thread count of 0 uses every hardware thread available
+    Bitbase_Generator::Bitbase_Generator(unsigned int thread_count_in) : thread_count(Thread_Pool::resolve_thread_count(thread_count_in)) {}
+
+    // Runs the work function once for every generator thread on the shared pool - each call is handed its own scratch game
+    // The calls claim blocks of positions from a shared counter so they never wait on each other and the caller can run any the workers don't get to
+    template <typename Work>
+    void Bitbase_Generator::run_on_threads(Work work) const {
+        Thread_Pool::get_default()->run_shares(thread_count, [&work](unsigned int share) {
+            Game scratch_game = Game::make_scratch_board();
+            work(scratch_game, share);
+        });
+    }
+
+    // Sets up the position at index on the scratch game - returns false if the pieces overlap or a pawn sits on a back row
+    bool Bitbase_Generator::setup_position(Game& game, std::vector<std::pair<int, int>>& placed, BITBASE_ENDGAME endgame, uint64_t index) const {
+        // Clearing the previous position off the scratch board
+        for (int k = 0; k < placed.size(); ++k) {
+            game.remove_piece(placed[k]);
+        }
+        placed.clear();
+
+        int squares[4];
+        int side = decode_bitbase_index(endgame, index, squares);
+        int square_count = bitbase_square_count(endgame);
+
+        for (int k = 0; k < square_count; ++k) {
+            for (int l = k + 1; l < square_count; ++l) {
+                if (squares[k] == squares[l]) {
+                    return false;
+                }
+            }
+        }
+
+        const std::vector<GAME_PIECE_TYPE>& pieces = BITBASE_PIECES[endgame];
+        for (int k = 0; k < pieces.size(); ++k) {
+            int x = squares[2 + k] / DEFAULT_CHESS_BOARD_SIZE;
+            if (pieces[k] == PAWN && (x == 0 || x == DEFAULT_CHESS_BOARD_SIZE - 1)) {
+                return false;
+            }
+        }
+
+        for (int k = 0; k < square_count; ++k) {
+            std::pair<int, int> location = std::make_pair(squares[k] / DEFAULT_CHESS_BOARD_SIZE, squares[k] % DEFAULT_CHESS_BOARD_SIZE);
+            GAME_PIECE_TYPE type = k < 2 ? KING : pieces[k - 2];
+            GAME_PIECE_COLOR color = k == 1 ? BLACK : WHITE;
+            game.add_piece(type, color, location);
+            placed.push_back(location);
+        }
+
+        GAME_PIECE_COLOR side_color = side == 0 ? WHITE : BLACK;
+        if (game.get_current_player()->get_player_color() != side_color) {
+            game.swap_current_player();
+        }
+
+        return true;
+    }
+
+    // Returns the valid moves for the position on the scratch game - castling and pawn double moves off their starting row are removed
+    // Pieces are placed fresh on the board so Game would otherwise treat every king, rook and pawn as never having moved
+    std::vector<board_move> Bitbase_Generator::get_bitbase_moves(Game& game) const {
+        std::vector<board_move> valid_moves = game.get_valid_moves();
+        std::vector<board_move> bitbase_moves;
+
+        for (int k = 0; k < valid_moves.size(); ++k) {
+            const std::pair<int, int>& start_pos = valid_moves[k].first;
+            const std::pair<int, int>& end_pos = valid_moves[k].second;
+            game_piece piece = game.get_location(start_pos);
+
+            if (piece.type == KING && abs(end_pos.second - start_pos.second) == 2) {
+                continue;
+            }
+
+            if (piece.type == PAWN && abs(end_pos.first - start_pos.first) == 2) {
+                int pawn_start_x = piece.pawn_move_positive_x ? 1 : DEFAULT_CHESS_BOARD_SIZE - 2;
+                if (start_pos.first != pawn_start_x) {
+                    continue;
+                }
+            }
+
+            bitbase_moves.push_back(valid_moves[k]);
+        }
+
+        return bitbase_moves;
+    }
+
+    // Generates the bitbase for the endgame and returns it bit packed - four positions to a byte
+    // Positions are first resolved by looking forward once - mates, stalemates, captures and promotions
+    // The resolved wins and losses are then walked backwards with Game's retro moves one ply at a time until nothing new is resolved
+    // Any position left unresolved can never be forced either way and is a draw
+    std::vector<unsigned char> Bitbase_Generator::generate(BITBASE_ENDGAME endgame) {
+        if (endgame == KPK && kqk_packed.empty()) {
+            kqk_packed = generate(KQK);
+        }
+
+        uint64_t entries = bitbase_entries(endgame);
+        std::vector<std::atomic<unsigned char>> results(entries);
+        std::vector<std::atomic<unsigned char>> remaining_moves(entries);   // Weak side only - moves not yet known to lose
+        std::vector<std::vector<uint64_t>> thread_frontiers(thread_count);
+        std::atomic<uint64_t> next_block(0);
+
+        // First pass - resolve every position that can be decided by looking one move ahead
+        run_on_threads([&](Game& game, unsigned int thread_id) {
+            std::vector<std::pair<int, int>> placed;
+            std::vector<uint64_t>& frontier = thread_frontiers[thread_id];
+
+            for (uint64_t block = next_block++; block * BITBASE_POSITIONS_PER_BLOCK < entries; block = next_block++) {
+                uint64_t block_end = std::min(entries, (block + 1) * BITBASE_POSITIONS_PER_BLOCK);
+
+                for (uint64_t index = block * BITBASE_POSITIONS_PER_BLOCK; index < block_end; ++index) {
+                    if (!setup_position(game, placed, endgame, index) || game.is_opponent_in_check()) {
+                        results[index] = BITBASE_INVALID;
+                        continue;
+                    }
+
+                    std::vector<board_move> moves = get_bitbase_moves(game);
+                    bool weak_side_to_move = game.get_current_player()->get_player_color() == BLACK;
+                    unsigned char result = BITBASE_UNRESOLVED;
+
+                    if (weak_side_to_move) {
+                        if (moves.empty()) {
+                            game.update_game_state();
+                            result = game.get_current_game_state() == Game::CHECKMATE ? BITBASE_LOSS : BITBASE_DRAW;
+                        } else {
+                            // Capturing any piece leaves a lone king or a lone minor piece - always a draw
+                            for (int k = 0; k < moves.size() && result == BITBASE_UNRESOLVED; ++k) {
+                                if (game.validate_game_piece(game.get_location(moves[k].second))) {
+                                    result = BITBASE_DRAW;
+                                }
+                            }
+                            remaining_moves[index] = static_cast<unsigned char>(moves.size());
+                        }
+                    } else {
+                        // The strong side can never be mated - having no moves is a stalemate
+                        if (moves.empty()) {
+                            result = BITBASE_DRAW;
+                        }
+
+                        // Promotions leave the bitbase - they win if the queen wins the resulting KQK position
+                        for (int k = 0; k < moves.size() && endgame == KPK; ++k) {
+                            if (game.get_location(moves[k].first).type == PAWN && moves[k].second.first == DEFAULT_CHESS_BOARD_SIZE - 1) {
+                                int squares[4];
+                                decode_bitbase_index(endgame, index, squares);
+                                squares[2] = moves[k].second.first * DEFAULT_CHESS_BOARD_SIZE + moves[k].second.second;
+
+                                if (read_packed_result(kqk_packed.data(), encode_bitbase_index(KQK, 1, squares)) == BITBASE_LOSS) {
+                                    result = BITBASE_WIN;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+
+                    results[index] = result;
+                    if (result == BITBASE_WIN || result == BITBASE_LOSS) {
+                        frontier.push_back(index);
+                    }
+                }
+            }
+        });
+
+        std::vector<uint64_t> frontier;
+        for (int t = 0; t < thread_count; ++t) {
+            frontier.insert(frontier.end(), thread_frontiers[t].begin(), thread_frontiers[t].end());
+            thread_frontiers[t].clear();
+        }
+
+        // Retrograde passes - every predecessor of a lost position is won and a weak side position whose every move is won for the strong side is lost
+        while (!frontier.empty()) {
+            next_block = 0;
+
+            run_on_threads([&](Game& game, unsigned int thread_id) {
+                std::vector<std::pair<int, int>> placed;
+                std::vector<uint64_t>& next_frontier = thread_frontiers[thread_id];
+                int square_count = bitbase_square_count(endgame);
+
+                for (uint64_t block = next_block++; block * BITBASE_POSITIONS_PER_BLOCK < frontier.size(); block = next_block++) {
+                    uint64_t block_end = std::min(static_cast<uint64_t>(frontier.size()), (block + 1) * BITBASE_POSITIONS_PER_BLOCK);
+
+                    for (uint64_t f = block * BITBASE_POSITIONS_PER_BLOCK; f < block_end; ++f) {
+                        uint64_t index = frontier[f];
+                        unsigned char result = results[index];
+                        setup_position(game, placed, endgame, index);
+
+                        int squares[4];
+                        int side = decode_bitbase_index(endgame, index, squares);
+                        std::vector<board_move> retro_moves = game.get_retro_moves();
+
+                        for (int k = 0; k < retro_moves.size(); ++k) {
+                            int from_square = retro_moves[k].first.first * DEFAULT_CHESS_BOARD_SIZE + retro_moves[k].first.second;
+                            int to_square = retro_moves[k].second.first * DEFAULT_CHESS_BOARD_SIZE + retro_moves[k].second.second;
+
+                            int previous_squares[4];
+                            for (int l = 0; l < square_count; ++l) {
+                                previous_squares[l] = squares[l] == to_square ? from_square : squares[l];
+                            }
+                            uint64_t previous_index = encode_bitbase_index(endgame, 1 - side, previous_squares);
+
+                            if (result == BITBASE_LOSS) {
+                                unsigned char expected = BITBASE_UNRESOLVED;
+                                if (results[previous_index].compare_exchange_strong(expected, BITBASE_WIN)) {
+                                    next_frontier.push_back(previous_index);
+                                }
+                            } else if (results[previous_index] == BITBASE_UNRESOLVED) {
+                                // Only the thread that removes the last escape marks the position as lost
+                                if (remaining_moves[previous_index].fetch_sub(1) == 1) {
+                                    results[previous_index] = BITBASE_LOSS;
+                                    next_frontier.push_back(previous_index);
+                                }
+                            }
+                        }
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (int t = 0; t < thread_count; ++t) {
+                frontier.insert(frontier.end(), thread_frontiers[t].begin(), thread_frontiers[t].end());
+                thread_frontiers[t].clear();
+            }
+        }
+
+        // Packing the results - anything still unresolved is a draw
+        std::vector<unsigned char> packed((entries + 3) / 4, 0);
+        for (uint64_t index = 0; index < entries; ++index) {
+            unsigned char result = results[index];
+            if (result == BITBASE_UNRESOLVED) {
+                result = BITBASE_DRAW;
+            }
+            packed[index >> 2] |= result << ((index & 3) * 2);
+        }
+
+        if (endgame == KQK) {
+            kqk_packed = packed;
+        }
+
+        return packed;
+    }
+
+    // Generates the bitbase for the endgame and writes it to file_path in the format read by Bitbase
+    void Bitbase_Generator::generate_to_file(BITBASE_ENDGAME endgame, const std::string& file_path) {
+        std::vector<unsigned char> packed = generate(endgame);
+
+        unsigned char header[BITBASE_HEADER_SIZE] = {};
+        uint32_t endgame_id = endgame;
+        uint64_t entries = bitbase_entries(endgame);
+        memcpy(header, BITBASE_MAGIC, sizeof(BITBASE_MAGIC));
+        memcpy(header + 4, &endgame_id, sizeof(endgame_id));
+        memcpy(header + 8, &entries, sizeof(entries));
+
+        std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            throw std::runtime_error("Unable to write the bitbase to " + file_path);
+        }
+        output.write(reinterpret_cast<const char *>(header), BITBASE_HEADER_SIZE);
+        output.write(reinterpret_cast<const char *>(packed.data()), packed.size());
+    }
+
+    // Generates every supported endgame into the directory - named by BITBASE_ENDGAME_NAMES with BITBASE_FILE_EXTENSION
+    void Bitbase_Generator::generate_all(const std::string& directory) {
+        // KQK first so that KPK can reuse it for promotions
+        BITBASE_ENDGAME order[BITBASE_ENDGAME_COUNT] = {KQK, KRK, KPK, KBNK};
+        for (int e = 0; e < BITBASE_ENDGAME_COUNT; ++e) {
+            generate_to_file(order[e], directory + "/" + BITBASE_ENDGAME_NAMES[order[e]] + BITBASE_FILE_EXTENSION);
+        }
+    }
+
+    // Maps the bitbase stored at file_path
+    Bitbase::Bitbase(const std::string& file_path) : file(file_path) {
+        if (file.size() < BITBASE_HEADER_SIZE || memcmp(file.data(), BITBASE_MAGIC, sizeof(BITBASE_MAGIC)) != 0) {
+            throw std::runtime_error(file_path + " is not a bitbase");
+        }
+
+        uint32_t endgame_id;
+        uint64_t entries;
+        memcpy(&endgame_id, file.data() + 4, sizeof(endgame_id));
+        memcpy(&entries, file.data() + 8, sizeof(entries));
+
+        if (endgame_id >= BITBASE_ENDGAME_COUNT || entries != bitbase_entries(static_cast<BITBASE_ENDGAME>(endgame_id))
+            || file.size() < BITBASE_HEADER_SIZE + (entries + 3) / 4) {
+            throw std::runtime_error(file_path + " is a corrupt bitbase");
+        }
+
+        endgame = static_cast<BITBASE_ENDGAME>(endgame_id);
+        results = file.data() + BITBASE_HEADER_SIZE;
+    }
+
+    // Returns the result for the current player of the game - BITBASE_INVALID if the game is not this endgame
+    BITBASE_RESULT Bitbase::probe(const Game& game) const {
+        BITBASE_ENDGAME game_endgame;
+        uint64_t index;
+        if (!read_bitbase_position(game, game_endgame, index) || game_endgame != endgame) {
+            return BITBASE_INVALID;
+        }
+        return probe_index(index);
+    }
+
+    // Returns the result stored for the index - see Bitbase_Generator for the index layout
+    BITBASE_RESULT Bitbase::probe_index(uint64_t index) const {
+        return read_packed_result(results, index);
+    }
+
+    // Loads each endgame's bitbase from the directory if it exists
+    Bitbase_Set::Bitbase_Set(const std::string& directory) {
+        for (int e = 0; e < BITBASE_ENDGAME_COUNT; ++e) {
+            try {
+                bitbases[e].reset(new Bitbase(directory + "/" + BITBASE_ENDGAME_NAMES[e] + BITBASE_FILE_EXTENSION));
+            // Missing bitbases are expected - the engine simply searches those endgames instead
+            } catch (const std::runtime_error&) {
+                bitbases[e].reset();
+            }
+        }
+    }
+
+    // Returns the result for the current player of the game - BITBASE_INVALID if no loaded bitbase covers the game
+    BITBASE_RESULT Bitbase_Set::probe(const Game& game) const {
+        BITBASE_ENDGAME endgame;
+        uint64_t index;
+        if (!read_bitbase_position(game, endgame, index) || bitbases[endgame] == nullptr) {
+            return BITBASE_INVALID;
+        }
+        return bitbases[endgame]->probe_index(index);
+    }
+
+    // Determines if no bitbases were found
+    bool Bitbase_Set::empty() const {
+        for (int e = 0; e < BITBASE_ENDGAME_COUNT; ++e) {
+            if (bitbases[e] != nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns the bitbases found in DEFAULT_BITBASE_DIRECTORY - loaded once and shared by every computer player
+    std::shared_ptr<const Bitbase_Set> Bitbase_Set::get_default() {
+        static std::shared_ptr<const Bitbase_Set> default_set(new Bitbase_Set(DEFAULT_BITBASE_DIRECTORY));
+        return default_set;
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef CPLUSPLUS_CHESS_BITBASE
+#define CPLUSPLUS_CHESS_BITBASE
+
+#include <string>
+#include <vector>
+#include <memory>       // std::unique_ptr, std::shared_ptr
+#include <cstdint>      // uint64_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Endgames that bitbases can be generated for - the strong side holds the named pieces alongside its king while the weak side holds a lone king
+    enum BITBASE_ENDGAME {
+        KPK,
+        KRK,
+        KQK,
+        KBNK,
+        BITBASE_ENDGAME_COUNT
+    };
+
+    // Names of each endgame - also used as the file name of the generated bitbase
+    const std::string BITBASE_ENDGAME_NAMES[BITBASE_ENDGAME_COUNT] = {"KPK", "KRK", "KQK", "KBNK"};
+
+    // Results stored in a bitbase - always from the perspective of the player on move
+    // Invalid positions are positions that can never be reached in play - such as the player not on move being in check
+    enum BITBASE_RESULT {
+        BITBASE_INVALID,
+        BITBASE_DRAW,
+        BITBASE_WIN,
+        BITBASE_LOSS
+    };
+
+    // Generates win / draw / loss bitbases by retrograde analysis - every position is set up on a Game so the chess rules are never duplicated
+    // Work is spread over a number of threads that each own their own scratch Game
+    class Bitbase_Generator {
+    public:
+        // A thread count of 0 uses every hardware thread available
+        Bitbase_Generator(unsigned int thread_count_in = 0);
+
+        // Generates the bitbase for the endgame and returns it bit packed - four positions to a byte
+        // KPK requires KQK to resolve promotions so KQK is generated along the way if it hasn't been already
+        std::vector<unsigned char> generate(BITBASE_ENDGAME endgame);
+
+        // Generates the bitbase for the endgame and writes it to file_path in the format read by Bitbase
+        void generate_to_file(BITBASE_ENDGAME endgame, const std::string& file_path);
+
+        // Generates every supported endgame into the directory - named by BITBASE_ENDGAME_NAMES with BITBASE_FILE_EXTENSION
+        void generate_all(const std::string& directory);
+
+    private:
+        // Sets up the position at index on the scratch game - returns false if the pieces overlap or a pawn sits on a back row
+        bool setup_position(Game& game, std::vector<std::pair<int, int>>& placed, BITBASE_ENDGAME endgame, uint64_t index) const;
+
+        // Returns the valid moves for the position on the scratch game - castling and pawn double moves off their starting row are removed
+        // Pieces are placed fresh on the board so Game would otherwise treat every king, rook and pawn as never having moved
+        std::vector<board_move> get_bitbase_moves(Game& game) const;
+
+        // Runs the work function once for every generator thread on the shared pool - each call is handed its own scratch game
+        template <typename Work>
+        void run_on_threads(Work work) const;
+
+        unsigned int thread_count;              // Number of threads used for each pass of the generation
+        std::vector<unsigned char> kqk_packed;  // Cached KQK results used to resolve pawn promotions in KPK
+    };
+
+    // A read-only bitbase mapped into memory from a file made by Bitbase_Generator - probing is a single memory lookup
+    // Throws a runtime_error if the file is missing or is not a valid bitbase
+    class Bitbase {
+    public:
+        // Maps the bitbase stored at file_path
+        Bitbase(const std::string& file_path);
+
+        // Returns which endgame this bitbase covers
+        BITBASE_ENDGAME get_endgame() const {return endgame;}
+
+        // Returns the result for the current player of the game - BITBASE_INVALID if the game is not this endgame
+        BITBASE_RESULT probe(const Game& game) const;
+
+        // Returns the result stored for the index - see Bitbase_Generator for the index layout
+        BITBASE_RESULT probe_index(uint64_t index) const;
+
+    private:
+        Mapped_File file;               // The mapped file - header followed by the packed results
+        BITBASE_ENDGAME endgame;        // The endgame read from the header
+        const unsigned char * results;  // The packed results past the header
+    };
+
+    // Every bitbase found in a directory - missing files are skipped so a partial set can still be probed
+    class Bitbase_Set {
+    public:
+        // Loads each endgame's bitbase from the directory if it exists
+        Bitbase_Set(const std::string& directory);
+
+        // Returns the result for the current player of the game - BITBASE_INVALID if no loaded bitbase covers the game
+        BITBASE_RESULT probe(const Game& game) const;
+
+        // Determines if no bitbases were found
+        bool empty() const;
+
+        // Returns the bitbases found in DEFAULT_BITBASE_DIRECTORY - loaded once and shared by every computer player
+        static std::shared_ptr<const Bitbase_Set> get_default();
+
+    private:
+        std::unique_ptr<Bitbase> bitbases[BITBASE_ENDGAME_COUNT];  // Loaded bitbases indexed by endgame - nullptr if the file was missing
+    };
+}
+
+#endif
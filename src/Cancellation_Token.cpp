@@ -0,0 +1,35 @@
+#include "Cancellation_Token.h"
+
+namespace Chess_API {
+    // Creates a token whose deadline is time_limit_ms from now
+    Cancellation_Token::Cancellation_Token(int time_limit_ms) : cancelled(false), deadline_ms(0) {
+        set_deadline(time_limit_ms);
+    }
+
+    // Cancels the turn - safe to call from any thread
+    void Cancellation_Token::cancel() {
+        cancelled = true;
+    }
+
+    // Sets the deadline to time_limit_ms from now - a value of 0 or less removes the deadline
+    void Cancellation_Token::set_deadline(int time_limit_ms) {
+        deadline_ms = time_limit_ms > 0 ? steady_time_ms() + time_limit_ms : 0;
+    }
+
+    // Determines if the deadline has passed - always false without a deadline
+    bool Cancellation_Token::is_past_deadline() const {
+        int64_t deadline = deadline_ms;
+        return deadline != 0 && steady_time_ms() >= deadline;
+    }
+
+    // Returns the milliseconds left until the deadline - 0 once it has passed and -1 without a deadline
+    int Cancellation_Token::get_remaining_ms() const {
+        int64_t deadline = deadline_ms;
+        if (deadline == 0) {
+            return -1;
+        }
+
+        int64_t remaining = deadline - steady_time_ms();
+        return remaining > 0 ? static_cast<int>(remaining) : 0;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CPLUSPLUS_CHESS_CANCELLATION_TOKEN
+#define CPLUSPLUS_CHESS_CANCELLATION_TOKEN
+
+#include <atomic>       // std::atomic
+#include <cstdint>      // int64_t
+#include <chrono>       // std::chrono::steady_clock
+
+namespace Chess_API {
+    // Returns the steady clock in milliseconds - used for every deadline so they can be compared with each other
+    inline int64_t steady_time_ms() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Shared between whoever asked for a turn and the player taking it - lets the turn be cancelled or given a deadline from any thread
+    class Cancellation_Token {
+    public:
+        // Creates a token with no deadline
+        Cancellation_Token() : cancelled(false), deadline_ms(0) {}
+
+        // Creates a token whose deadline is time_limit_ms from now
+        Cancellation_Token(int time_limit_ms);
+
+        // Cancels the turn - safe to call from any thread
+        void cancel();
+
+        // Determines if the turn has been cancelled
+        bool is_cancelled() const {return cancelled;}
+
+        // Sets the deadline to time_limit_ms from now - a value of 0 or less removes the deadline
+        void set_deadline(int time_limit_ms);
+
+        // Determines if the deadline has passed - always false without a deadline
+        bool is_past_deadline() const;
+
+        // Determines if the turn has to stop - either cancelled or past the deadline
+        bool should_stop() const {return is_cancelled() || is_past_deadline();}
+
+        // Returns the milliseconds left until the deadline - 0 once it has passed and -1 without a deadline
+        int get_remaining_ms() const;
+
+    private:
+        std::atomic<bool> cancelled;        // Set once cancel is called
+        std::atomic<int64_t> deadline_ms;   // Steady clock time the turn must finish by - 0 for no deadline
+    };
+}
+
+#endif
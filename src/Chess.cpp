@@ -41,33 +41,90 @@ namespace Chess_API {
     Chess::Chess() {
         // Default game, computer player and player
         std::shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::COLORMIN));
-        std::shared_ptr<Player> player2(new Computer_Player(game, GAME_PIECE_COLOR::COLORMAX, DEFAULT_COMPUTER_DIFFICULTY));
+        std::shared_ptr<Computer_Player> player2(new Computer_Player(nullptr, GAME_PIECE_COLOR::COLORMAX, DEFAULT_COMPUTER_DIFFICULTY));
         game = new Game(player1, player2);
+        game->setup_default_board_state();
+
+        // The computer can only reference the game once it exists
+        player2->set_internal_game(game);
+        computer_player = player2;
     }
 
     // Main constructor for taking the players name as well as the difficulty to play on 
     Chess::Chess(std::string player_name, DIFFICULTY difficulty) {
         std::shared_ptr<Player> player1(new Human_Player(player_name, GAME_PIECE_COLOR::COLORMIN));
-        std::shared_ptr<Player> player2(new Computer_Player(game, GAME_PIECE_COLOR::COLORMAX, difficulty));
+        std::shared_ptr<Computer_Player> player2(new Computer_Player(nullptr, GAME_PIECE_COLOR::COLORMAX, difficulty));
         game = new Game(player1, player2);
+        game->setup_default_board_state();
+
+        // The computer can only reference the game once it exists
+        player2->set_internal_game(game);
+        computer_player = player2;
     }
 
     // Multiplayer constructor to play with two human players
     Chess::Chess(std::string player_name1, std::string player_name2) {
         std::shared_ptr<Player> player1(new Human_Player(player_name1, GAME_PIECE_COLOR::COLORMIN));
-        std::shared_ptr<Player> player2(new Human_Player(player_name2, GAME_PIECE_COLOR::COLORMIN));
+        std::shared_ptr<Player> player2(new Human_Player(player_name2, GAME_PIECE_COLOR::COLORMAX));
         game = new Game(player1, player2);
+        game->setup_default_board_state();
     }
 
     // Constructor that can use serialized data to generate the game up to the current point based on past moves
+    // game_in holds the players and the position past_moves start from - the moves are replayed on it through replay_record so the board always matches the history
+    // Both arguments were already copied or moved in by the caller so they are moved on rather than copied again
+    // Throws a runtime_error if a move isn't valid player input - the moves themselves are trusted like any other record
     Chess::Chess(Game game_in, std::vector<std::pair<std::string, std::string>> past_moves) {
-        // Copies all of the serialized data to recreate the game as it was
-        game = new Game(game_in);
-        played_moves = past_moves;
+        game = new Game(std::move(game_in));
+
+        game_record record;
+        record.start_fen = game->to_fen();
+        record.moves.reserve(past_moves.size());
+        for (int i = 0; i < past_moves.size(); ++i) {
+            if (!is_valid_player_input(past_moves[i])) {
+                delete game;
+                throw std::runtime_error(INVALID_INPUT_ERROR_MSG);
+            }
+            record.moves.push_back(parse_player_input(past_moves[i]));
+        }
+
+        replay_record(record);
+
+        // Games from the standard starting position keep an empty start_fen just like new games
+        if (start_fen == STARTING_POSITION_FEN) {
+            start_fen.clear();
+        }
+    }
+
+    // Restores a suspended game between two human players by replaying its record - pass the record with std::move to avoid copying the moves
+    // The moves are trusted rather than validated - they must come from a game that was actually played
+    Chess::Chess(game_record record, std::string player_name1, std::string player_name2) {
+        std::shared_ptr<Player> player1(new Human_Player(player_name1, GAME_PIECE_COLOR::COLORMIN));
+        std::shared_ptr<Player> player2(new Human_Player(player_name2, GAME_PIECE_COLOR::COLORMAX));
+        game = new Game(player1, player2);
+        replay_record(record);
+    }
+
+    // Restores a suspended game against the computer by replaying its record - the human has the white pieces as with a new game
+    // The moves are trusted rather than validated - they must come from a game that was actually played
+    Chess::Chess(game_record record, std::string player_name, DIFFICULTY difficulty) {
+        std::shared_ptr<Player> player1(new Human_Player(player_name, GAME_PIECE_COLOR::COLORMIN));
+        std::shared_ptr<Computer_Player> player2(new Computer_Player(nullptr, GAME_PIECE_COLOR::COLORMAX, difficulty));
+        game = new Game(player1, player2);
+        replay_record(record);
+
+        // The computer only starts reading the game once it is fully restored
+        player2->set_internal_game(game);
+        computer_player = player2;
     }
 
     // Destructor that deletes all game data
+    // A turn still being played is cancelled and waited for as the player may be reading the game
     Chess::~Chess() {
+        if (pending_turn.valid()) {
+            cancel_turn();
+            pending_turn.wait();
+        }
         delete game;
     }
 
@@ -75,45 +132,133 @@ namespace Chess_API {
     *   Plays out the moves, assuming they are valid, and changes the game state accordingly
     */ 
     void Chess::play_turn() {
-        // Determining that the move is valid per the chess board
-        std::pair<std::string, std::string> new_move = game->get_current_player()->take_turn();
+        if (pending_turn.valid()) {
+            throw std::runtime_error(TURN_PENDING_ERROR_MSG);
+        }
+
+        play_player_move(game->get_current_player()->take_turn());
+    }
+
+    /*  Starts the next turn without waiting for the player - the move is played by poll_turn once the player has decided
+    *   The token lets the caller cancel the turn or give it a deadline - a new token without a deadline is used if none is given
+    *   Throws a runtime_error if the last turn is still being played
+    */
+    void Chess::start_turn(std::shared_ptr<Cancellation_Token> token) {
+        if (pending_turn.valid()) {
+            throw std::runtime_error(TURN_PENDING_ERROR_MSG);
+        }
+
+        pending_token = token != nullptr ? token : std::make_shared<Cancellation_Token>();
+        pending_turn = game->get_current_player()->take_turn_async(pending_token);
+    }
+
+    /*  Checks on the turn started by start_turn without blocking - returns true once the move has been played
+    *   Once the token is cancelled or past its deadline the player is asked to finish - a human without a move ends the turn with a runtime_error
+    *   Rethrows the runtime_error of a cancelled turn or an invalid move - the turn is over either way
+    */
+    bool Chess::poll_turn() {
+        if (!pending_turn.valid()) {
+            throw std::runtime_error(NO_TURN_PENDING_ERROR_MSG);
+        }
+
+        if (pending_turn.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (pending_token->should_stop()) {
+                game->get_current_player()->cancel_turn();
+            }
+            return false;
+        }
+
+        // Getting the move leaves the future invalid - so the turn is over even if the move turns out to be invalid
+        pending_token.reset();
+        play_player_move(pending_turn.get());
+        return true;
+    }
+
+    // Cancels the turn started by start_turn - poll_turn reports how it ended
+    void Chess::cancel_turn() {
+        if (!pending_turn.valid()) {
+            return;
+        }
 
+        pending_token->cancel();
+        game->get_current_player()->cancel_turn();
+    }
+
+    // Shares a thread pool for the computer player to think on so many games can be driven by a few threads
+    void Chess::set_thread_pool(std::shared_ptr<Thread_Pool> thread_pool) {
+        if (computer_player != nullptr) {
+            computer_player->set_thread_pool(thread_pool);
+        }
+    }
+
+    // Validates the players move and plays it - throws a runtime_error for badly formatted input or an invalid move
+    void Chess::play_player_move(const std::pair<std::string, std::string>& new_move) {
+        // Determining that the move is valid per the chess board
         if (!is_valid_player_input(new_move)) {
             throw std::runtime_error(INVALID_INPUT_ERROR_MSG);
         }
 
+        board_move move = parse_player_input(new_move);
+        std::pair<int, int> start_pos = move.first;
+        std::pair<int, int> end_pos = move.second;
+
+        // Determining if the move provided is within the confines of chess ruling
+        if (game->is_valid_move(start_pos, end_pos) != Game::VALID_MOVE) {
+            throw std::runtime_error(INVALID_MOVE_ERROR_MSG);
+        }
+
+        // Finally - if this is a valid move to be played per the input parameters and is a valid chess move then the move is recorded and played
+        // Playing through make_move also switches the current player and remembers the position for finding repetitions
+        played_moves.push_back(move);
+        game->make_move(start_pos, end_pos);
+        game->update_game_state();
+
+        // Nobody is left to ponder for once the game is over
+        if (computer_player != nullptr && is_game_over()) {
+            computer_player->stop_pondering();
+        }
+    }
+
+    // Sets up the starting position of the record and plays its moves straight through make_move - the game takes over the moves
+    // Nothing is validated so the moves must have come from a game that was actually played such as one read by decode_game_record
+    // Only the final position needs its state worked out - generating every move after each one is what made replaying slow
+    void Chess::replay_record(game_record& record) {
+        start_fen = std::move(record.start_fen);
+        if (start_fen.empty()) {
+            game->setup_default_board_state();
+        } else {
+            game->from_fen(start_fen);
+        }
+
+        for (int i = 0; i < record.moves.size(); ++i) {
+            game->make_move(record.moves[i].first, record.moves[i].second);
+        }
+        game->update_game_state();
+        played_moves = std::move(record.moves);
+    }
+
+    // Converts player input such as {e2, e4} into board positions - the input must already be valid
+    // The letters are not case sensitive just like in is_valid_player_input
+    board_move Chess::parse_player_input(const std::pair<std::string, std::string>& input) {
         // Parsing the move into usable int values to determine what the start and end locations are on the chess board
         // calculating the index of the 2D grid based on the position in the valid chars array
         int start_y = std::distance(VALID_CHARS.cbegin(),
                                     std::find(VALID_CHARS.cbegin(), VALID_CHARS.cend(), 
-                                              std::get<0>(new_move).at(0)));
+                                              static_cast<char>(std::tolower(static_cast<unsigned char>(std::get<0>(input).at(0))))));
         int start_x = std::distance(VALID_NUMS.cbegin(),
                                     std::find(VALID_NUMS.cbegin(), VALID_NUMS.cend(), 
-                                              std::get<0>(new_move).at(1)));
+                                              std::get<0>(input).at(1)));
         
         // Repeating calculations for the end position
         int end_y = std::distance(VALID_CHARS.cbegin(),
                                     std::find(VALID_CHARS.cbegin(), VALID_CHARS.cend(), 
-                                              std::get<1>(new_move).at(0)));
+                                              static_cast<char>(std::tolower(static_cast<unsigned char>(std::get<1>(input).at(0))))));
         int end_x = std::distance(VALID_NUMS.cbegin(),
                                     std::find(VALID_NUMS.cbegin(), VALID_NUMS.cend(), 
-                                              std::get<1>(new_move).at(1)));
+                                              std::get<1>(input).at(1)));
         
         // Creating the move pairs to indicate which position on the grid to start in and which position to end in
-        std::pair<int, int> start_pos(start_x, start_y);
-        std::pair<int, int> end_pos(end_x, end_y);
-
-        // Determining if the move provided is within the confines of chess ruling
-        if (!game->is_valid_move(start_pos, end_pos)) {
-            throw std::runtime_error(INVALID_MOVE_ERROR_MSG);
-        }
-
-        // Finally - if this is a valid move to be played per the input parameters and is a valid chess move then the move is recorded and played
-        played_moves.push_back(new_move);
-        game->play_move(start_pos, end_pos);
-
-        // Switch which player is the new current player
-        game->swap_current_player();
+        return std::make_pair(std::make_pair(start_x, start_y), std::make_pair(end_x, end_y));
     }
 
     // Determines if the game is currently in a state of check
@@ -134,6 +279,17 @@ namespace Chess_API {
         }
     }
 
+    // Determines if the game is drawn - by stalemate, threefold repetition or the fifty move rule
+    bool Chess::is_draw() const {
+        Game::GAME_STATE state = game->get_current_game_state();
+        return state == Game::STALEMATE || state == Game::THREEFOLD_REPETITION || state == Game::FIFTY_MOVE_RULE;
+    }
+
+    // Determines if the game is over - either by check mate or a draw
+    bool Chess::is_game_over() const {
+        return is_in_check_mate() || is_draw();
+    }
+
     // Determines if the game is currently in a check mate state - indicating the game is over
     bool Chess::is_in_check_mate() const {
         if (game->get_current_game_state() == Game::CHECKMATE) {
@@ -152,4 +308,18 @@ namespace Chess_API {
     void Chess::show_board() const {
         game->show_board();
     }
+
+    // Returns the moves played so far with the position they started from and the result as a record for encode_game_record
+    game_record Chess::get_game_record() const {
+        game_record record;
+        record.start_fen = start_fen;
+        record.moves = played_moves;
+        if (is_in_check_mate()) {
+            // The player to move is the one who was mated
+            record.white_half_points = game->get_current_player()->get_player_color() == GAME_PIECE_COLOR::WHITE ? 0 : 2;
+        } else if (is_draw()) {
+            record.white_half_points = 1;
+        }
+        return record;
+    }
 }
\ No newline at end of file
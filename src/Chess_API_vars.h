@@ -2,9 +2,11 @@
 #define CPLUSPLUS_CHESS_API_VARS
 
 #include <string>
+#include <vector>
 #include <tuple>
 #include <unordered_map>
 #include <map>
+#include <cstdint>      // uint8_t, uint64_t
 
 namespace Chess_API {
     const std::string VALID_CHARS = "abcdefgh";                                                             // Valid characters referring to the places on the chess board
@@ -17,6 +19,9 @@ namespace Chess_API {
     const wchar_t CHESS_BOARD_SEPERATOR_CHAR = '|';                                                         // Default seperator between each element on the boards
     const wchar_t CHESS_BOARD_SPACE_CHAR = ' ';                                                             // Default char denoting spaces on the chess board
     const wchar_t CHESS_BOARD_LINE_CHAR = *L"\u2500";                                                       // Default char to separate lines on the chess board
+    const std::string DEFAULT_BITBASE_DIRECTORY = "bitbases";                                               // Default directory the endgame bitbases are generated into and loaded from
+    const std::string BITBASE_FILE_EXTENSION = ".bb";                                                       // File extension for the generated endgame bitbases
+    const std::string STARTING_POSITION_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";                  // FEN of the position every standard game starts from
 
     // Difficulties for the computer players
     enum DIFFICULTY {
@@ -30,12 +35,90 @@ namespace Chess_API {
 
     const DIFFICULTY DEFAULT_COMPUTER_DIFFICULTY = DIFFICULTY::MEDIUM;       
 
+    // How many plies ahead the computer searches for each difficulty - indexed by DIFFICULTY
+    const int DIFFICULTY_SEARCH_DEPTHS[] = {1, 2, 3, 4, 5, 6};
+
+    // How long the computer may think per move for each difficulty in milliseconds - indexed by DIFFICULTY
+    const int DIFFICULTY_MOVE_TIMES_MS[] = {100, 250, 500, 1000, 2500, 5000};
+
+    // Search used by the computer players
+    enum COMPUTER_ENGINE {
+        ALPHA_BETA,     // Iterative deepening alpha-beta - the strongest engine
+        MONTE_CARLO     // Monte Carlo tree search with random playouts - plays a looser, more human style at the weaker difficulties
+    };
+
+    // How many playouts the Monte Carlo engine may run for each difficulty - indexed by DIFFICULTY
+    const int DIFFICULTY_PLAYOUTS[] = {200, 1000, 4000, 15000, 50000, 150000};
+
+    // Positions the computer may visit per move for each difficulty - 0 leaves the move to the depth and time - indexed by DIFFICULTY
+    // The first iteration always finishes so the weak difficulties stop after a few hundred positions rather than running out their time
+    const int DIFFICULTY_NODE_LIMITS[] = {200, 2000, 0, 0, 0, 0};
+
+    // Chance out of 100 that the computer plays a random move instead of searching for each difficulty - indexed by DIFFICULTY
+    const int DIFFICULTY_BLUNDER_PERCENTS[] = {25, 10, 0, 0, 0, 0};
+
+    // Number of entries in each computer players transposition table
+    const size_t DEFAULT_TRANSPOSITION_TABLE_ENTRIES = size_t(1) << 18;
+
+    // Number of entries in the transposition table of a computer player created with each difficulty - indexed by DIFFICULTY
+    // The node limits of the weak difficulties never fill a full size table so they don't pay to allocate and clear one
+    const size_t DIFFICULTY_TABLE_ENTRIES[] = {size_t(1) << 10, size_t(1) << 12, DEFAULT_TRANSPOSITION_TABLE_ENTRIES, DEFAULT_TRANSPOSITION_TABLE_ENTRIES,
+        DEFAULT_TRANSPOSITION_TABLE_ENTRIES, DEFAULT_TRANSPOSITION_TABLE_ENTRIES};
+
+    // Moves without a capture or a pawn move before the game is drawn by the fifty move rule - each players move counts as one
+    const int FIFTY_MOVE_RULE_HALFMOVES = 100;
+
+    // Most moves a player can ever have in one position - sizes the move buffers filled by Game::get_valid_moves
+    const int MAX_POSITION_MOVES = 256;
+
+    // Bytes of game records gathered in memory before they are written out
+    const size_t GAME_RECORD_BUFFER_BYTES = size_t(1) << 20;
+
+    // Hash keys each game remembers for finding repetitions - covers the fifty move rule plus a deep search on top of it
+    const int HASH_HISTORY_SIZE = 256;
+
     // Error message for typing in the wrong input in the game
     const std::string INVALID_INPUT_ERROR_MSG = "That isn't valid input, type your move in {{char}{num} {char}{num}} format using \"" + VALID_CHARS + "\" as the valid characters and \"" + VALID_NUMS + "\" as the valid numbers";
 
     // Error message for typing in an invalid move
     const std::string INVALID_MOVE_ERROR_MSG = "This isn't a valid move - ensure that the move you are typing is feasible for the piece you are using.";
 
+    // Error message for a turn that was cancelled before the player moved
+    const std::string TURN_CANCELLED_ERROR_MSG = "The turn was cancelled before a move was made.";
+
+    // Error message for a turn that ran past its deadline before the player moved
+    const std::string TURN_DEADLINE_ERROR_MSG = "The turn ran out of time before a move was made.";
+
+    // Error message for starting a turn while the last one is still being played
+    const std::string TURN_PENDING_ERROR_MSG = "The current turn has to finish before another one can start.";
+
+    // Error message for polling a turn that was never started
+    const std::string NO_TURN_PENDING_ERROR_MSG = "There is no turn being played - start a turn before polling it.";
+
+    // Error message for asking a computer player for a move before it was given a game
+    const std::string NO_GAME_ERROR_MSG = "The computer player has no game to choose a move in.";
+
+    // Error message for asking a computer player for a move in a position without one
+    const std::string NO_LEGAL_MOVE_ERROR_MSG = "There is no legal move to play - the game is already over.";
+
+    // Error message for asking the mate solver for a mate length it can't look for
+    const std::string INVALID_MATE_LENGTH_ERROR_MSG = "The mate solver can only look for mates from 1 to 32 moves long.";
+
+    // Error message for a transposition table size the machine doesn't have the memory for
+    const std::string TABLE_ALLOCATION_ERROR_MSG = "Unable to allocate the memory for a transposition table of that size.";
+
+    // Error message for a game record that is cut short or holds a move that can't be played
+    const std::string INVALID_GAME_RECORD_ERROR_MSG = "The game record is damaged or holds a move that can't be played.";
+
+    // Error message for a position index whose game ids or moves run past the end of the file
+    const std::string INVALID_POSITION_INDEX_ERROR_MSG = "The position index is damaged - its game ids or moves run past the end of the file.";
+
+    // Error message for a packed position that doesn't describe a position
+    const std::string INVALID_PACKED_POSITION_ERROR_MSG = "That isn't a valid packed position - expected at most 32 pieces with one king each.";
+
+    // Error message for a FEN string that doesn't describe a position
+    const std::string INVALID_FEN_ERROR_MSG = "That isn't a valid FEN - expected eight rows of pieces with one king each followed by the side to move, castling rights, en passant square and move counters.";
+
     // Different types of game pieces for chess
     enum GAME_PIECE_TYPE {
         PAWN = 1,
@@ -58,6 +141,9 @@ namespace Chess_API {
         COLORMAX = BLACK
     };
 
+    // A move on the board described by its {start_pos, end_pos} - each position is {row, column}
+    typedef std::pair<std::pair<int, int>, std::pair<int, int>> board_move;
+
     // Representation of a game piece - simple mechanics to set some rules for the piece
     struct game_piece {
         // Default values to indicate an invalidly defined piece
@@ -87,6 +173,27 @@ namespace Chess_API {
         }
     };
 
+    // A position packed into 32 bytes for training data - written and read straight as bytes so files are in the order of the machine that wrote them
+    // Each set bit of occupancy is a square holding a piece - square index is row * 8 + column
+    // pieces holds a nibble per occupied square from the lowest square up - piece type - 1 with 8 added for black
+    struct packed_position {
+        uint64_t occupancy = 0;         // Squares holding a piece
+        uint8_t pieces[16] = {};        // Two pieces per byte - the lower nibble comes first
+        int16_t score = 0;              // Score of the position in centipawns for the side to move
+        uint8_t flags = 0;              // Black to move in bit 0 - KQkq castling rights in bits 1 to 4 - result in bits 5 and 6
+        uint8_t en_passant = 0xFF;      // Square behind a pawn that just moved two rows - 0xFF if there isn't one
+        uint8_t halfmove_clock = 0;     // Moves since the last capture or pawn move - stops counting at 255
+        uint8_t reserved = 0;
+        uint16_t fullmove_number = 1;
+
+        // Returns the half points white scored in the game the position came from - -1 if it isn't known
+        int get_white_half_points() const {return ((flags >> 5) & 3) - 1;}
+
+        // Sets the half points white scored - 0, 1 or 2 - or -1 if it isn't known
+        void set_white_half_points(int white_half_points) {flags = static_cast<uint8_t>((flags & 0x9F) | (((white_half_points + 1) & 3) << 5));}
+    };
+    static_assert(sizeof(packed_position) == 32, "packed_position must stay 32 bytes");
+
     // Symbols for each game piece when printing to the console
     const std::unordered_map<GAME_PIECE_TYPE, wchar_t> GAME_PIECE_SYMBOLS = {
         {PAWN, *L"\u2659"},
@@ -1,10 +1,329 @@
 #include "Computer_Player.h"
+#include "Human_Player.h"
+
+#include <random>       // std::mt19937_64
+#include <atomic>       // std::atomic
 
 namespace Chess_API {
+    // The ponder search waiting for or running on the thread pool
+    // Whichever thread claims it first runs it - the turn runs it itself when no worker got to it so waiting on the pool can never deadlock
+    struct ponder_job {
+        std::packaged_task<search_result()> search;     // Runs the prepared search of the expected position
+        std::atomic<bool> claimed;                      // Set by the thread that runs or abandons the search
+
+        ponder_job(std::function<search_result()> search_in) : search(search_in), claimed(false) {}
+    };
+
+    // Looks up the current position in the opening book and picks one of the moves played from it
+    // Returns false if there is no book or the position isn't in it
+    bool Computer_Player::probe_opening_book(board_move& book_move) const {
+        if (opening_book == nullptr) {
+            return false;
+        }
+        book_move = opening_book->choose_move(*game, blunder_seed);
+        return book_move.first.first != -1;
+    }
+
+    // Looks up the position in the bitbases and keeps every move that holds on to the best result - the search picks between them
+    // Bitbases only know win / draw / loss so choosing among the winning moves is left to the search which also steers away from repetitions
+    // Returns false if the position isn't covered by any loaded bitbase
+    bool Computer_Player::probe_bitbases(const Game& position, std::vector<board_move>& best_moves) const {
+        best_moves.clear();
+        if (bitbases == nullptr || bitbases->empty()) {
+            return false;
+        }
+
+        Game scratch_game(position);
+        if (bitbases->probe(scratch_game) == BITBASE_INVALID) {
+            return false;
+        }
+
+        board_move moves[MAX_POSITION_MOVES];
+        int move_count = scratch_game.get_valid_moves(moves);
+        int best_rank = -1;
+
+        for (int i = 0; i < move_count; ++i) {
+            Game::move_record record = scratch_game.make_move(moves[i].first, moves[i].second);
+
+            // Ranking from the opponents result - their loss is our win
+            // Moves leaving the bitbase are captures of our last pieces or promotions without a KQK bitbase - treat them as draws
+            BITBASE_RESULT result = bitbases->probe(scratch_game);
+            scratch_game.unmake_move(record);
+            int rank = 1;
+            if (result == BITBASE_LOSS) {
+                rank = 2;
+            } else if (result == BITBASE_WIN) {
+                rank = 0;
+            }
+
+            if (rank > best_rank) {
+                best_rank = rank;
+                best_moves.clear();
+            }
+            if (rank == best_rank) {
+                best_moves.push_back(moves[i]);
+            }
+        }
+
+        return best_rank != -1;
+    }
+
+    // Waits for any asynchronous turn and stops pondering before the computer player goes away
+    Computer_Player::~Computer_Player() {
+        {
+            std::unique_lock<std::mutex> lock(turn_mutex);
+            turn_finished.wait(lock, [this]() {return !turn_running;});
+        }
+        stop_pondering();
+    }
+
+    // Replaces the bitbases probed in endgames - nullptr disables probing
+    void Computer_Player::set_bitbases(std::shared_ptr<const Bitbase_Set> bitbases_in) {
+        stop_pondering();
+        bitbases = bitbases_in;
+        searcher.set_bitbases(bitbases_in);
+    }
+
+    // Turns thinking on the opponents time on or off
+    void Computer_Player::set_pondering(bool pondering_in) {
+        if (!pondering_in) {
+            stop_pondering();
+        }
+        pondering_enabled = pondering_in;
+    }
+
+    // Chooses the search used to pick moves - threads_in only applies to MONTE_CARLO where 0 uses every hardware thread
+    // The Monte Carlo engine never ponders
+    void Computer_Player::set_engine(COMPUTER_ENGINE engine_in, unsigned int threads_in) {
+        stop_pondering();
+        engine = engine_in;
+        monte_carlo_threads = threads_in;
+    }
+
+    // Resizes the transposition table to the largest that fits in megabytes - everything the table learned is forgotten
+    // Throws a runtime_error if the memory cannot be allocated - the old table is kept in that case
+    void Computer_Player::set_hash_size(size_t megabytes) {
+        stop_pondering();
+        table->resize_megabytes(megabytes);
+    }
+
+    // Builds the search limits for the computers difficulty
+    search_limits Computer_Player::get_search_limits() const {
+        search_limits limits;
+        limits.depth = DIFFICULTY_SEARCH_DEPTHS[difficulty];
+        limits.move_time_ms = DIFFICULTY_MOVE_TIMES_MS[difficulty];
+        limits.on_info = on_info;
+        limits.multi_pv = multi_pv;
+        limits.nodes = DIFFICULTY_NODE_LIMITS[difficulty];
+        return limits;
+    }
+
+    // Decides from the seed and the position whether the weak difficulties throw this move away - picks the random move played instead
+    // Returns false if the difficulty never blunders or the roll says to search
+    bool Computer_Player::choose_blunder(board_move& blunder_move) const {
+        if (DIFFICULTY_BLUNDER_PERCENTS[difficulty] == 0) {
+            return false;
+        }
+
+        std::mt19937_64 random(blunder_seed ^ game->get_hash_key());
+        if (random() % 100 >= static_cast<uint64_t>(DIFFICULTY_BLUNDER_PERCENTS[difficulty])) {
+            return false;
+        }
+
+        // The scratch board is only allocated on the first blunder - later ones copy the position onto its pieces
+        if (blunder_game == nullptr) {
+            blunder_players[0].reset(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+            blunder_players[1].reset(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            blunder_game.reset(new Game(Game::make_scratch_board()));
+        }
+        *blunder_game = *game;
+        blunder_game->set_players(blunder_players[0], blunder_players[1]);
+        board_move moves[MAX_POSITION_MOVES];
+        int move_count = blunder_game->get_valid_moves(moves);
+        if (move_count == 0) {
+            return false;
+        }
+        blunder_move = moves[random() % move_count];
+        return true;
+    }
+
+    // Builds the Monte Carlo limits for the computers difficulty
+    monte_carlo_limits Computer_Player::get_monte_carlo_limits() const {
+        monte_carlo_limits limits;
+        limits.playouts = DIFFICULTY_PLAYOUTS[difficulty];
+        limits.move_time_ms = DIFFICULTY_MOVE_TIMES_MS[difficulty];
+        limits.threads = monte_carlo_threads;
+        return limits;
+    }
+
+    // Returns the pool the asynchronous turns and the ponder search run on - the shared default pool unless one was set
+    std::shared_ptr<Thread_Pool> Computer_Player::get_thread_pool() const {
+        return thread_pool != nullptr ? thread_pool : Thread_Pool::get_default();
+    }
+
+    // Starts searching the position expected after best_move and the predicted reply while the opponent thinks
+    // The ponder search uses the limits of the computers own turns without the time limit - it runs until it reaches the difficulty depth or the opponent moves
+    // The ponder game gets stand-in players so the pool never holds on to this computer or its opponent
+    void Computer_Player::start_pondering(const board_move& best_move, const board_move& ponder_move) const {
+        Game ponder_game(*game);
+        ponder_game.set_players(std::shared_ptr<Player>(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE)),
+                                std::shared_ptr<Player>(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK)));
+        ponder_game.make_move(best_move.first, best_move.second);
+        ponder_game.make_move(ponder_move.first, ponder_move.second);
+        ponder_key = ponder_game.get_hash_key();
+
+        search_limits limits = get_search_limits();
+        limits.move_time_ms = 0;
+        probe_bitbases(ponder_game, limits.root_moves);
+        searcher.prepare(limits);
+
+        ponder = std::make_shared<ponder_job>([this, ponder_game]() {
+            return searcher.run(ponder_game);
+        });
+        ponder_future = ponder->search.get_future();
+
+        std::shared_ptr<ponder_job> job = ponder;
+        get_thread_pool()->submit([job]() {
+            if (!job->claimed.exchange(true)) {
+                job->search();
+            }
+        });
+    }
+
+    // Stops any ponder search that is running and waits for it to finish - called once the game is over so the search doesn't run on
+    // A search no worker has started yet is abandoned without running
+    void Computer_Player::stop_pondering() const {
+        if (ponder == nullptr) {
+            return;
+        }
+
+        if (ponder->claimed.exchange(true)) {
+            searcher.stop();
+            ponder_future.wait();
+        }
+        ponder.reset();
+        ponder_future = std::future<search_result>();
+    }
+
     // Prompts the computer to come up with their move
+    // Throws a runtime_error if the computer has no game or no legal move to play
     std::pair<std::string, std::string> Computer_Player::take_turn() const {
-        // TODO - Implement
-        return std::make_pair("a2", "a3");
+        return choose_move(nullptr);
+    }
+
+    // Searches for the move on the thread pool without blocking - the game must not change until the future is ready
+    // Only one turn may be played at a time - throws a runtime_error if the last asynchronous turn hasn't finished
+    std::future<std::pair<std::string, std::string>> Computer_Player::take_turn_async(std::shared_ptr<const Cancellation_Token> token) const {
+        {
+            std::lock_guard<std::mutex> lock(turn_mutex);
+            if (turn_running) {
+                throw std::runtime_error(TURN_PENDING_ERROR_MSG);
+            }
+            turn_running = true;
+        }
+
+        std::shared_ptr<std::promise<std::pair<std::string, std::string>>> promise = std::make_shared<std::promise<std::pair<std::string, std::string>>>();
+        std::future<std::pair<std::string, std::string>> future = promise->get_future();
+
+        std::function<void()> task = [this, promise, token]() {
+            try {
+                promise->set_value(choose_move(token.get()));
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+
+            // Nothing belonging to the computer player may be touched once the destructor is allowed to continue
+            std::lock_guard<std::mutex> lock(turn_mutex);
+            turn_running = false;
+            turn_finished.notify_all();
+        };
+
+        get_thread_pool()->submit(task);
+        return future;
+    }
+
+    // Decides on the move for the current position - stops early once the token is cancelled or past its deadline
+    // When the opponent played the predicted reply the ponder search simply carries on with the normal time limit
+    // Otherwise the ponder search is abandoned - its work stays in the transposition table for the fresh search
+    // Throws a runtime_error if the token was cancelled or there is no move to play - token may be nullptr
+    std::pair<std::string, std::string> Computer_Player::choose_move(const Cancellation_Token * token) const {
+        if (game == nullptr) {
+            throw std::runtime_error(NO_GAME_ERROR_MSG);
+        }
+
+        search_limits limits = get_search_limits();
+        limits.token = token;
+        search_result result;
+        last_result = search_result();
+        bool ponder_hit = ponder != nullptr && ponder_key == game->get_hash_key();
+
+        if (ponder_hit) {
+            searcher.set_token(token);
+            searcher.set_move_time(limits.move_time_ms);
+
+            // No worker got to the ponder search - this thread runs it with the normal time limit instead
+            if (!ponder->claimed.exchange(true)) {
+                ponder->search();
+            }
+            result = ponder_future.get();
+            ponder.reset();
+            searcher.set_token(nullptr);
+        } else {
+            stop_pondering();
+        }
+
+        if (token != nullptr && token->is_cancelled()) {
+            throw std::runtime_error(TURN_CANCELLED_ERROR_MSG);
+        }
+
+        // Openings the book knows are played without searching
+        board_move book_move;
+        if (probe_opening_book(book_move)) {
+            return std::make_pair(position_to_string(book_move.first), position_to_string(book_move.second));
+        }
+
+        // Endgames covered by the bitbases only search the moves that keep the best result - the ponder search was limited to them already
+        bool in_bitbase = probe_bitbases(*game, limits.root_moves);
+
+        // The weak difficulties sometimes skip the search altogether
+        board_move blunder_move;
+        if (!in_bitbase && choose_blunder(blunder_move)) {
+            return std::make_pair(position_to_string(blunder_move.first), position_to_string(blunder_move.second));
+        }
+
+        if (engine == MONTE_CARLO && !in_bitbase) {
+            monte_carlo_limits playout_limits = get_monte_carlo_limits();
+            playout_limits.token = token;
+            monte_carlo_result playout_result = monte_carlo.search(*game, playout_limits);
+
+            if (token != nullptr && token->is_cancelled()) {
+                throw std::runtime_error(TURN_CANCELLED_ERROR_MSG);
+            }
+            if (playout_result.best_move.first.first == -1) {
+                throw std::runtime_error(NO_LEGAL_MOVE_ERROR_MSG);
+            }
+            return std::make_pair(position_to_string(playout_result.best_move.first), position_to_string(playout_result.best_move.second));
+        }
+
+        if (!ponder_hit) {
+            result = searcher.search(*game, limits);
+        }
+
+        if (token != nullptr && token->is_cancelled()) {
+            throw std::runtime_error(TURN_CANCELLED_ERROR_MSG);
+        }
+
+        if (result.best_move.first.first == -1) {
+            throw std::runtime_error(NO_LEGAL_MOVE_ERROR_MSG);
+        }
+        last_result = result;
+
+        // Node limited difficulties would spend more thinking on the opponents time than on their own moves
+        if (pondering_enabled && DIFFICULTY_NODE_LIMITS[difficulty] == 0 && result.ponder_move.first.first != -1) {
+            start_pondering(result.best_move, result.ponder_move);
+        }
+
+        return std::make_pair(position_to_string(result.best_move.first), position_to_string(result.best_move.second));
     }
 
 }
\ No newline at end of file
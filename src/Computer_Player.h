@@ -3,27 +3,138 @@
 
 #include "Player.h"
 #include "Game.h"
+#include "Bitbase.h"
+#include "Search.h"
+#include "Monte_Carlo_Searcher.h"
+#include "Transposition_Table.h"
+#include "Thread_Pool.h"
+#include "Opening_Tree.h"
+
+#include <memory>               // std::shared_ptr
+#include <future>               // std::future
+#include <mutex>                // std::mutex
+#include <condition_variable>   // std::condition_variable
 
 namespace Chess_API {
+    // The ponder search waiting for or running on the thread pool
+    struct ponder_job;
+
     class Computer_Player: public Player {
     private:
         const Game * game = nullptr; // A const reference to the game to make a determinination on what to do
+        std::shared_ptr<const Bitbase_Set> bitbases;    // Endgame bitbases probed before searching - shared between every computer player
+        std::shared_ptr<Transposition_Table> table;     // Search results kept between turns and shared with the ponder search
+        mutable Searcher searcher;                      // Searches both the computers own turns and the opponents time
+        mutable Monte_Carlo_Searcher monte_carlo;       // Searches the computers turns when the engine is MONTE_CARLO
+        COMPUTER_ENGINE engine = ALPHA_BETA;            // Search used to choose moves
+        unsigned int monte_carlo_threads = 1;           // Threads running playouts for the Monte Carlo engine
+        mutable std::shared_ptr<ponder_job> ponder;     // Search of the expected position while the opponent thinks - nullptr when not pondering
+        mutable std::future<search_result> ponder_future;   // Result of the ponder search - only valid while pondering
+        mutable uint64_t ponder_key = 0;                // Hash key of the position being pondered
+        bool pondering_enabled = true;                  // Whether the computer thinks on the opponents time
+        std::shared_ptr<Thread_Pool> thread_pool;       // Runs the turns started by take_turn_async and the ponder search - nullptr runs them on the default pool
+        mutable std::mutex turn_mutex;                  // Guards turn_running
+        mutable std::condition_variable turn_finished;  // Signalled when an asynchronous turn finishes
+        mutable bool turn_running = false;              // Set while a turn started by take_turn_async is being played
+        mutable search_result last_result;              // Result of the alpha-beta search behind the last move - empty if the move didn't come from one
+        search_info_callback on_info;                   // Receives the info line of each iteration of the computers own searches
+        int multi_pv = 1;                               // Number of best moves the computers own searches find a line for
+        uint64_t blunder_seed = 0;                      // Mixed with the hash key of the position to decide the blunders of the weak difficulties
+        std::shared_ptr<const Opening_Tree> opening_book;   // Moves played in the openings of other games - nullptr searches from the first move
+        mutable std::unique_ptr<Game> blunder_game;     // Copy of the position the blunder moves are listed on - kept between turns so its board and pieces are reused
+        mutable std::shared_ptr<Player> blunder_players[2]; // White and black stand-ins for the players of blunder_game so it never keeps the real players alive
+
+        // Looks up the position in the bitbases and keeps every move that holds on to the best result - the search picks between them
+        // Returns false if the position isn't covered by any loaded bitbase
+        bool probe_bitbases(const Game& position, std::vector<board_move>& best_moves) const;
+
+        // Looks up the current position in the opening book and picks one of the moves played from it
+        // Returns false if there is no book or the position isn't in it
+        bool probe_opening_book(board_move& book_move) const;
+
+        // Builds the search limits for the computers difficulty
+        search_limits get_search_limits() const;
+
+        // Builds the Monte Carlo limits for the computers difficulty
+        monte_carlo_limits get_monte_carlo_limits() const;
+
+        // Decides from the seed and the position whether the weak difficulties throw this move away - picks the random move played instead
+        // Returns false if the difficulty never blunders or the roll says to search
+        bool choose_blunder(board_move& blunder_move) const;
+
+        // Returns the pool the asynchronous turns and the ponder search run on - the shared default pool unless one was set
+        std::shared_ptr<Thread_Pool> get_thread_pool() const;
+
+        // Starts searching the position expected after best_move and the predicted reply while the opponent thinks
+        void start_pondering(const board_move& best_move, const board_move& ponder_move) const;
+
+        // Decides on the move for the current position - stops early once the token is cancelled or past its deadline
+        // Throws a runtime_error if the token was cancelled or there is no move to play - token may be nullptr
+        std::pair<std::string, std::string> choose_move(const Cancellation_Token * token) const;
 
     public:
         DIFFICULTY difficulty;    
 
         // Default Constructor for the computer player - computer must always have a game to reference to make descisions from
-        Computer_Player(const Game * game_in) : game(game_in), Player(), difficulty(DEFAULT_COMPUTER_DIFFICULTY) {}
+        Computer_Player(const Game * game_in) : Player(), game(game_in), bitbases(Bitbase_Set::get_default()),
+            table(new Transposition_Table(DEFAULT_TRANSPOSITION_TABLE_ENTRIES)), searcher(table, bitbases), difficulty(DEFAULT_COMPUTER_DIFFICULTY) {}
 
         // Constructor for determining the computers level of difficulty
-        Computer_Player(const Game * game_in, GAME_PIECE_COLOR color_in, DIFFICULTY difficulty_in) : game(game_in), Player(DEFAULT_COMPUTER_NAME, color_in), difficulty(difficulty_in) {}
+        Computer_Player(const Game * game_in, GAME_PIECE_COLOR color_in, DIFFICULTY difficulty_in) : Player(DEFAULT_COMPUTER_NAME, color_in), game(game_in), bitbases(Bitbase_Set::get_default()),
+            table(new Transposition_Table(DIFFICULTY_TABLE_ENTRIES[difficulty_in])), searcher(table, bitbases), difficulty(difficulty_in) {}
+
+        // Waits for any asynchronous turn and stops pondering before the computer player goes away
+        ~Computer_Player();
 
         // Sets a copy of the game to the computer players memory
         void set_internal_game(const Game * game_in) {game = game_in;}
 
+        // Replaces the bitbases probed in endgames - nullptr disables probing
+        void set_bitbases(std::shared_ptr<const Bitbase_Set> bitbases_in);
+
+        // Turns thinking on the opponents time on or off
+        void set_pondering(bool pondering_in);
+
+        // Stops any ponder search that is running and waits for it to finish - called once the game is over so the search doesn't run on
+        void stop_pondering() const;
+
+        // Chooses the search used to pick moves - threads_in only applies to MONTE_CARLO where 0 uses every hardware thread
+        // The Monte Carlo engine never ponders
+        void set_engine(COMPUTER_ENGINE engine_in, unsigned int threads_in = 1);
+
+        // Sends the info line of each completed iteration of the computers own searches to on_info_in - an empty callback turns them off
+        // on_info_in runs on whichever thread plays the turn or ponders
+        void set_search_info_callback(search_info_callback on_info_in) {on_info = on_info_in;}
+
+        // Sets how many of the best moves the computers own searches find a line for - the lines are in get_last_search_result
+        // Every extra line costs a search of the root that would otherwise have gone into the best move
+        void set_multi_pv(int multi_pv_in) {multi_pv = multi_pv_in > 1 ? multi_pv_in : 1;}
+
+        // Returns the result of the alpha-beta search behind the last move including its statistics - empty if the move came from the opening book, a blunder or another engine
+        // After take_turn_async the result is only ready once the future is
+        search_result get_last_search_result() const {return last_result;}
+
+        // Seeds the blunders of the weak difficulties - the same seed always plays the same move in the same position
+        void set_blunder_seed(uint64_t seed_in) {blunder_seed = seed_in;}
+
+        // Plays moves from the opening tree while the position is in it - picked by how often each was played using the blunder seed
+        // nullptr turns the book off - the tree can be shared between every computer player
+        void set_opening_book(std::shared_ptr<const Opening_Tree> opening_book_in) {opening_book = opening_book_in;}
+
+        // Resizes the transposition table to the largest that fits in megabytes - everything the table learned is forgotten
+        // Throws a runtime_error if the memory cannot be allocated - the old table is kept in that case
+        void set_hash_size(size_t megabytes);
+
+        // Shares a thread pool to run the turns started by take_turn_async and the ponder search on - nullptr runs them on the default pool
+        void set_thread_pool(std::shared_ptr<Thread_Pool> thread_pool_in) {thread_pool = thread_pool_in;}
+
         // Uses the provided game object to make a turn
+        // Throws a runtime_error if the computer has no game or no legal move to play
         std::pair<std::string, std::string> take_turn() const;
 
+        // Searches for the move on the thread pool without blocking - the game must not change until the future is ready
+        std::future<std::pair<std::string, std::string>> take_turn_async(std::shared_ptr<const Cancellation_Token> token) const;
+
     };
 }
 
@@ -0,0 +1,127 @@
+#include "Data_Generator.h"
+#include "Search.h"
+#include "Tournament.h"
+#include "Thread_Pool.h"
+
+#include <mutex>        // std::mutex
+#include <atomic>       // std::atomic
+#include <random>       // std::random_device
+
+namespace Chess_API {
+    // Positions are written to output_path with the number of the thread appended - see get_shard_path
+    Data_Generator::Data_Generator(const std::string& output_path_in) : output_path(output_path_in) {}
+
+    // Returns the file the thread at thread_index writes its positions to
+    std::string Data_Generator::get_shard_path(const std::string& output_path, unsigned int thread_index) {
+        return output_path + "." + std::to_string(thread_index);
+    }
+
+    // Plays games until the limits are reached - on_game may be empty
+    // Throws a runtime_error if a file cannot be written
+    // Each thread keeps the positions of its current game until the result is known then hands them to its own buffered writer
+    datagen_result Data_Generator::run(const datagen_limits& limits, datagen_callback on_game) const {
+        int64_t start_ms = steady_time_ms();
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+
+        std::random_device device;
+        uint64_t seed = limits.seed != 0 ? limits.seed : (uint64_t(device()) << 32) | device();
+
+        // Every file is opened up front so a bad path fails before any game is played
+        std::vector<std::unique_ptr<Packed_Position_Writer>> writers;
+        for (unsigned int t = 0; t < thread_count; ++t) {
+            writers.push_back(std::unique_ptr<Packed_Position_Writer>(new Packed_Position_Writer(get_shard_path(output_path, t))));
+        }
+
+        std::atomic<int> next_game(0);
+        std::atomic<bool> failed(false);
+        std::mutex result_mutex;
+        datagen_result result;
+
+        auto play_games = [&](unsigned int thread_index) {
+            try {
+                Packed_Position_Writer& writer = *writers[thread_index];
+                std::shared_ptr<Transposition_Table> table = std::make_shared<Transposition_Table>(DEFAULT_DATAGEN_TABLE_ENTRIES);
+                Searcher searcher(table, Bitbase_Set::get_default());
+                search_limits search;
+                search.nodes = limits.nodes;
+
+                Game game = Game::make_scratch_board();
+                std::vector<packed_position> positions;
+
+                while (!failed) {
+                    int game_index = next_game++;
+                    if (game_index >= limits.games) {
+                        break;
+                    }
+
+                    std::vector<board_move> opening = Tournament::make_opening(seed + game_index, limits.opening_plies);
+                    game.from_fen(STARTING_POSITION_FEN);
+                    for (int i = 0; i < opening.size(); ++i) {
+                        game.make_move(opening[i].first, opening[i].second);
+                    }
+                    game.update_game_state();
+
+                    // Games share nothing through the table so each one plays the same however the games are spread over the threads
+                    table->clear(1);
+                    positions.clear();
+                    int white_half_points = 1;
+                    for (int ply = 0; ply < limits.max_plies; ++ply) {
+                        Game::GAME_STATE state = game.get_current_game_state();
+                        if (state == Game::CHECKMATE) {
+                            white_half_points = game.get_current_player()->get_player_color() == GAME_PIECE_COLOR::WHITE ? 0 : 2;
+                            break;
+                        } else if (state == Game::STALEMATE || state == Game::THREEFOLD_REPETITION || state == Game::FIFTY_MOVE_RULE) {
+                            break;
+                        }
+
+                        search_result found = searcher.search(game, search);
+                        if (found.best_move.first.first == -1) {
+                            break;
+                        }
+
+                        // Mate scores don't fit the packed score and say nothing about how good the position looks
+                        bool noisy = state == Game::CHECK || game.is_capture_or_promotion(found.best_move);
+                        bool mate = found.score >= MATE_SCORE - MAX_SEARCH_PLY || found.score <= -MATE_SCORE + MAX_SEARCH_PLY;
+                        if (ply >= limits.skip_plies && !mate && !(limits.skip_noisy && noisy)) {
+                            packed_position position;
+                            game.to_packed(position);
+                            position.score = static_cast<int16_t>(found.score);
+                            positions.push_back(position);
+                        }
+
+                        game.make_move(found.best_move.first, found.best_move.second);
+                        game.update_game_state();
+                    }
+
+                    for (int i = 0; i < positions.size(); ++i) {
+                        positions[i].set_white_half_points(white_half_points);
+                        writer.write(positions[i]);
+                    }
+
+                    std::lock_guard<std::mutex> lock(result_mutex);
+                    ++result.games;
+                    result.white_wins += white_half_points == 2 ? 1 : 0;
+                    result.draws += white_half_points == 1 ? 1 : 0;
+                    result.black_wins += white_half_points == 0 ? 1 : 0;
+                    result.positions += positions.size();
+                    result.elapsed_ms = steady_time_ms() - start_ms;
+                    if (on_game) {
+                        on_game(result);
+                    }
+                }
+
+                // Flushed here rather than left to the destructor so a file that can't be written fails the run
+                writer.flush();
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+        };
+
+        // The calling thread plays games alongside the workers - the first error any thread hit is thrown once they have all stopped
+        Thread_Pool::get_default()->run_shares(thread_count, play_games);
+
+        result.elapsed_ms = steady_time_ms() - start_ms;
+        return result;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef CPLUSPLUS_CHESS_DATA_GENERATOR
+#define CPLUSPLUS_CHESS_DATA_GENERATOR
+
+#include <string>
+#include <functional>   // std::function
+#include <cstdint>      // uint64_t, int64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Packed_Position.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Entries in the transposition table of each data generation thread
+    const size_t DEFAULT_DATAGEN_TABLE_ENTRIES = size_t(1) << 16;
+
+    // Settings for generating training positions through self-play
+    struct datagen_limits {
+        int games = 1000;               // Games to play
+        unsigned int threads = 0;       // Games played at once - 0 plays one game per hardware thread
+        int opening_plies = 8;          // Random moves played from the start position so the games don't all repeat each other
+        int max_plies = 400;            // Games still going after this many plies are drawn
+        uint64_t nodes = 5000;          // Positions each move is searched for
+        int skip_plies = 8;             // Positions this early in a game are not written - counted after the opening
+        bool skip_noisy = true;         // Whether to leave out positions in check or whose best move is a capture or promotion
+        uint64_t seed = 0;              // Seeds the openings - 0 picks a random seed
+    };
+
+    // Totals of a data generation run
+    struct datagen_result {
+        int games = 0;
+        int white_wins = 0;
+        int draws = 0;
+        int black_wins = 0;
+        uint64_t positions = 0;         // Positions written over every file
+        int64_t elapsed_ms = 0;
+    };
+
+    // Called with the totals after every finished game - calls never overlap but come from the threads playing the games
+    typedef std::function<void(const datagen_result&)> datagen_callback;
+
+    // Plays the engine against itself from random openings and writes the positions of the games with their search scores and results
+    // Every thread writes its own file through its own buffer so no thread ever waits on another to write
+    class Data_Generator {
+    public:
+        // Positions are written to output_path with the number of the thread appended - see get_shard_path
+        Data_Generator(const std::string& output_path_in);
+
+        // Plays games until the limits are reached - on_game may be empty
+        // Throws a runtime_error if a file cannot be written
+        datagen_result run(const datagen_limits& limits, datagen_callback on_game = nullptr) const;
+
+        // Returns the file the thread at thread_index writes its positions to
+        static std::string get_shard_path(const std::string& output_path, unsigned int thread_index);
+
+    private:
+        std::string output_path;    // Start of the path of every file written
+    };
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "EPD_Suite.h"
+#include "Search.h"
+#include "Thread_Pool.h"
+
+#include <fstream>      // std::ifstream
+#include <mutex>        // std::mutex
+#include <atomic>       // std::atomic
+#include <algorithm>    // std::find
+
+namespace Chess_API {
+    // Reads every test position of the EPD file - returns the number of positions added
+    // Lines that aren't a position or have neither a bm nor an am move that can be played are skipped
+    // Throws a runtime_error if the file cannot be opened
+    size_t EPD_Suite::load(const std::string& file_path) {
+        std::ifstream input(file_path);
+        if (!input) {
+            throw std::runtime_error("Unable to open " + file_path);
+        }
+
+        // One scratch game is refilled for every line
+        Game board = Game::make_scratch_board();
+
+        size_t loaded = 0;
+        std::string line;
+        epd_position position;
+        while (std::getline(input, line)) {
+            if (parse_line(line, board, position)) {
+                positions.push_back(position);
+                ++loaded;
+            }
+        }
+        return loaded;
+    }
+
+    // Reads one EPD line into position with board as scratch space - returns false if the line isn't a test position
+    // The four position fields are followed by operations ended by semicolons - bm and am list moves in standard algebraic notation
+    bool EPD_Suite::parse_line(std::string_view line, Game& board, epd_position& position) {
+        // Hands out the next space separated field from index - empty once the text runs out
+        auto next_field = [](std::string_view text, size_t& index) {
+            while (index < text.size() && (text[index] == ' ' || text[index] == '\t' || text[index] == '\r')) {
+                ++index;
+            }
+            size_t start = index;
+            while (index < text.size() && text[index] != ' ' && text[index] != '\t' && text[index] != '\r') {
+                ++index;
+            }
+            return text.substr(start, index - start);
+        };
+
+        size_t index = 0;
+        std::string_view fields[4];
+        for (int i = 0; i < 4; ++i) {
+            fields[i] = next_field(line, index);
+            if (fields[i].empty()) {
+                return false;
+            }
+        }
+
+        position.fen.assign(fields[0]);
+        for (int i = 1; i < 4; ++i) {
+            position.fen.push_back(' ');
+            position.fen.append(fields[i]);
+        }
+        try {
+            board.from_fen(position.fen);
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+        board.update_game_state();
+
+        position.id.clear();
+        position.best_moves.clear();
+        position.avoid_moves.clear();
+        while (index < line.size()) {
+            // A semicolon inside a quoted operand doesn't end the operation
+            size_t end = index;
+            bool quoted = false;
+            while (end < line.size() && (quoted || line[end] != ';')) {
+                quoted = line[end] == '"' ? !quoted : quoted;
+                ++end;
+            }
+            std::string_view operation = line.substr(index, end - index);
+            index = end + 1;
+
+            size_t operand_index = 0;
+            std::string_view opcode = next_field(operation, operand_index);
+            if (opcode == "id") {
+                std::string_view id = operation.substr(operand_index);
+                size_t first = id.find('"');
+                size_t last = id.rfind('"');
+                if (first != std::string_view::npos && last > first) {
+                    id = id.substr(first + 1, last - first - 1);
+                } else {
+                    size_t id_index = 0;
+                    id = next_field(id, id_index);
+                }
+                position.id.assign(id);
+            } else if (opcode == "bm" || opcode == "am") {
+                std::vector<board_move>& moves = opcode == "bm" ? position.best_moves : position.avoid_moves;
+                for (std::string_view san = next_field(operation, operand_index); !san.empty(); san = next_field(operation, operand_index)) {
+                    board_move move = board.find_san_move(san);
+                    if (move.first.first != -1) {
+                        moves.push_back(move);
+                    }
+                }
+            }
+        }
+        return !position.best_moves.empty() || !position.avoid_moves.empty();
+    }
+
+    // Searches every position within the limits spread over the threads and returns the totals - on_result may be empty
+    // Each thread clears its table before every position so a result never depends on which positions the thread solved before
+    epd_summary EPD_Suite::run(const epd_limits& limits, epd_callback on_result) const {
+        int64_t start_ms = steady_time_ms();
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+        if (thread_count > positions.size()) {
+            thread_count = positions.size() > 0 ? positions.size() : 1;
+        }
+
+        std::atomic<size_t> next_position(0);
+        std::mutex summary_mutex;
+        epd_summary summary;
+
+        auto solve_positions = [&](unsigned int) {
+            std::shared_ptr<Transposition_Table> table = std::make_shared<Transposition_Table>(DEFAULT_EPD_TABLE_ENTRIES);
+            Searcher searcher(table, Bitbase_Set::get_default());
+            Game board = Game::make_scratch_board();
+
+            while (true) {
+                size_t index = next_position++;
+                if (index >= positions.size()) {
+                    break;
+                }
+                const epd_position& position = positions[index];
+                board.from_fen(position.fen);
+
+                // Decides whether a move solves the position
+                auto solves = [&position](const board_move& move) {
+                    bool best = position.best_moves.empty() || std::find(position.best_moves.begin(), position.best_moves.end(), move) != position.best_moves.end();
+                    return best && std::find(position.avoid_moves.begin(), position.avoid_moves.end(), move) == position.avoid_moves.end();
+                };
+
+                // Time to solution is when the best move last changed to a solving one
+                epd_result result;
+                result.index = index;
+                search_limits search;
+                search.move_time_ms = limits.move_time_ms;
+                search.nodes = limits.nodes;
+                search.depth = limits.depth;
+                search.on_iteration = [&result, &solves](const search_result& iteration) {
+                    if (!solves(iteration.best_move)) {
+                        result.solve_depth = 0;
+                    } else if (result.solve_depth == 0) {
+                        result.solve_depth = iteration.depth;
+                        result.solve_nodes = iteration.nodes;
+                        result.solve_ms = iteration.statistics.elapsed_ms;
+                    }
+                };
+
+                table->clear(1);
+                search_result found = searcher.search(board, search);
+                result.best_move = found.best_move;
+                result.score = found.score;
+                result.depth = found.depth;
+                result.nodes = found.nodes;
+                result.elapsed_ms = found.statistics.elapsed_ms;
+                result.solved = found.best_move.first.first != -1 && solves(found.best_move);
+                if (!result.solved) {
+                    result.solve_depth = 0;
+                    result.solve_nodes = 0;
+                    result.solve_ms = 0;
+                } else if (result.solve_depth == 0) {
+                    // Solved by the move kept from an unfinished first iteration
+                    result.solve_nodes = found.nodes;
+                    result.solve_ms = result.elapsed_ms;
+                }
+
+                std::lock_guard<std::mutex> lock(summary_mutex);
+                ++summary.positions;
+                if (result.solved) {
+                    ++summary.solved;
+                    summary.solve_ms += result.solve_ms;
+                    summary.solve_nodes += result.solve_nodes;
+                }
+                if (on_result) {
+                    on_result(position, result);
+                }
+            }
+        };
+
+        // The calling thread solves positions alongside the workers
+        Thread_Pool::get_default()->run_shares(thread_count, solve_positions);
+
+        summary.elapsed_ms = steady_time_ms() - start_ms;
+        return summary;
+    }
+}
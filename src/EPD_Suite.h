@@ -0,0 +1,86 @@
+#ifndef CPLUSPLUS_CHESS_EPD_SUITE
+#define CPLUSPLUS_CHESS_EPD_SUITE
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>   // std::function
+#include <cstdint>      // uint64_t, int64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Entries in the transposition table of each thread solving positions
+    const size_t DEFAULT_EPD_TABLE_ENTRIES = size_t(1) << 16;
+
+    // A test position of an EPD suite - solved by finding one of the best moves and none of the moves to avoid
+    struct epd_position {
+        std::string fen;                        // Position to solve - the counters are left to their starting values
+        std::string id;                         // Name given by the id operation - empty if there is none
+        std::vector<board_move> best_moves;     // Moves of the bm operation - any of them solves the position
+        std::vector<board_move> avoid_moves;    // Moves of the am operation - playing any of them fails the position
+    };
+
+    // Budget each position is searched with - a value of 0 means that limit isn't used
+    struct epd_limits {
+        int move_time_ms = 1000;        // Milliseconds allowed for each position
+        uint64_t nodes = 0;             // Positions allowed to be visited for each position
+        int depth = 0;                  // Deepest iteration for each position
+        unsigned int threads = 0;       // Positions solved at once - 0 solves one position per hardware thread
+    };
+
+    // How the search did on one position
+    struct epd_result {
+        size_t index = 0;               // Position in the suite
+        bool solved = false;            // Whether the final best move solves the position
+        board_move best_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        int score = 0;
+        int depth = 0;                  // Deepest completed iteration
+        uint64_t nodes = 0;
+        int64_t elapsed_ms = 0;
+        int solve_depth = 0;            // First iteration from which the best move solved the position and never changed back - 0 if not solved
+        uint64_t solve_nodes = 0;       // Nodes visited by the end of that iteration
+        int64_t solve_ms = 0;           // Milliseconds taken by the end of that iteration
+    };
+
+    // Totals over a whole suite
+    struct epd_summary {
+        int positions = 0;
+        int solved = 0;
+        int64_t solve_ms = 0;           // Time to solution added up over the solved positions
+        uint64_t solve_nodes = 0;       // Nodes to solution added up over the solved positions
+        int64_t elapsed_ms = 0;
+    };
+
+    // Called with each position and how the search did on it - calls never overlap but come in the order the positions finish
+    typedef std::function<void(const epd_position&, const epd_result&)> epd_callback;
+
+    // Solves the positions of an EPD test suite in parallel and reports how many were solved and how long each took to solve
+    // Used as the regression check that a change to the engine finds tactics faster rather than just searching faster
+    class EPD_Suite {
+    public:
+        // Reads every test position of the EPD file - returns the number of positions added
+        // Lines that aren't a position or have neither a bm nor an am move that can be played are skipped
+        // Throws a runtime_error if the file cannot be opened
+        size_t load(const std::string& file_path);
+
+        // Adds one test position to the suite
+        void add_position(const epd_position& position) {positions.push_back(position);}
+
+        // Returns every position of the suite in the order they were added
+        const std::vector<epd_position>& get_positions() const {return positions;}
+
+        // Reads one EPD line into position with board as scratch space - returns false if the line isn't a test position
+        static bool parse_line(std::string_view line, Game& board, epd_position& position);
+
+        // Searches every position within the limits spread over the threads and returns the totals - on_result may be empty
+        epd_summary run(const epd_limits& limits, epd_callback on_result = nullptr) const;
+
+    private:
+        std::vector<epd_position> positions;
+    };
+}
+
+#endif
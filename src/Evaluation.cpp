@@ -0,0 +1,76 @@
+#include "Evaluation.h"
+
+#include <cstdlib>  // abs
+
+namespace Chess_API {
+    // Distance of the position from the four center squares - 0 in the center and 3 on the edge
+    static int distance_from_center(int x, int y) {
+        int center_x = x < DEFAULT_CHESS_BOARD_SIZE / 2 ? (DEFAULT_CHESS_BOARD_SIZE / 2) - 1 - x : x - (DEFAULT_CHESS_BOARD_SIZE / 2);
+        int center_y = y < DEFAULT_CHESS_BOARD_SIZE / 2 ? (DEFAULT_CHESS_BOARD_SIZE / 2) - 1 - y : y - (DEFAULT_CHESS_BOARD_SIZE / 2);
+        return center_x > center_y ? center_x : center_y;
+    }
+
+    // Term counting the material of each piece type - indexed by GAME_PIECE_TYPE - the king has no material term
+    static const int MATERIAL_TERMS[GAME_PIECE_TYPE::TYPEMAX + 1] = {-1, TERM_PAWN, TERM_KNIGHT, TERM_ROOK, TERM_BISHOP, -1, TERM_QUEEN};
+
+    // Scores the position in centipawns from the perspective of the current player - positive means the current player is ahead
+    int evaluate(const Game& game) {
+        evaluation_trace trace = trace_evaluation(game);
+
+        int white_score = 0;
+        for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+            white_score += trace[i] * EVALUATION_WEIGHTS[i];
+        }
+        return game.get_current_player()->get_player_color() == GAME_PIECE_COLOR::WHITE ? white_score : -white_score;
+    }
+
+    // Breaks the evaluation of the position down into its terms - always from whites perspective
+    // Which side counts as having a lone king to mop up is decided with the weights in EVALUATION_WEIGHTS
+    evaluation_trace trace_evaluation(const Game& game) {
+        int terms[2][EVALUATION_TERM_COUNT] = {};   // White, black
+        int material[2] = {0, 0};
+        int piece_counts[2] = {0, 0};               // Non-king pieces per side
+        std::pair<int, int> kings[2] = {std::make_pair(-1, -1), std::make_pair(-1, -1)};
+
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece piece = game.get_location(std::make_pair(i, j));
+                if (!game.validate_game_piece(piece)) {
+                    continue;
+                }
+
+                int side = piece.color == GAME_PIECE_COLOR::WHITE ? 0 : 1;
+                if (piece.type == GAME_PIECE_TYPE::KING) {
+                    kings[side] = std::make_pair(i, j);
+                    continue;
+                }
+                ++piece_counts[side];
+                ++terms[side][MATERIAL_TERMS[piece.type]];
+                material[side] += EVALUATION_WEIGHTS[MATERIAL_TERMS[piece.type]];
+
+                if (piece.type == GAME_PIECE_TYPE::KNIGHT || piece.type == GAME_PIECE_TYPE::BISHOP) {
+                    terms[side][TERM_CENTRALIZATION] += 3 - distance_from_center(i, j);
+                } else if (piece.type == GAME_PIECE_TYPE::PAWN) {
+                    int rows_advanced = piece.pawn_move_positive_x ? i - 1 : (DEFAULT_CHESS_BOARD_SIZE - 2) - i;
+                    terms[side][TERM_PAWN_ADVANCE] += rows_advanced;
+                }
+            }
+        }
+
+        // Mopping up a lone king - the side with material wants the enemy king on the edge and its own king nearby
+        for (int side = 0; side < 2; ++side) {
+            int other = 1 - side;
+            if (piece_counts[other] == 0 && material[side] > material[other] && kings[0].first != -1 && kings[1].first != -1) {
+                int king_distance = abs(kings[0].first - kings[1].first) + abs(kings[0].second - kings[1].second);
+                terms[side][TERM_LONE_KING_EDGE] += distance_from_center(kings[other].first, kings[other].second);
+                terms[side][TERM_KING_PROXIMITY] += 14 - king_distance;
+            }
+        }
+
+        evaluation_trace trace;
+        for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+            trace[i] = terms[0][i] - terms[1][i];
+        }
+        return trace;
+    }
+}
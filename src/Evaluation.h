@@ -0,0 +1,51 @@
+#ifndef CPLUSPLUS_CHESS_EVALUATION
+#define CPLUSPLUS_CHESS_EVALUATION
+
+#include <array>
+
+#include "Game.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Value of each piece in centipawns - indexed by GAME_PIECE_TYPE
+    const int PIECE_VALUES[GAME_PIECE_TYPE::TYPEMAX + 1] = {0, 100, 320, 500, 330, 0, 900};
+
+    // Every term the evaluation adds up - the score is each terms weight times how often it applies
+    enum EVALUATION_TERM {
+        TERM_PAWN,              // Material
+        TERM_KNIGHT,
+        TERM_ROOK,
+        TERM_BISHOP,
+        TERM_QUEEN,
+        TERM_CENTRALIZATION,    // Per step a knight or bishop stands closer to the center
+        TERM_PAWN_ADVANCE,      // Per row a pawn has advanced from its starting row
+        TERM_LONE_KING_EDGE,    // Per step the lone king is pushed away from the center
+        TERM_KING_PROXIMITY,    // Per step the kings are closer together when one side has a lone king
+        EVALUATION_TERM_COUNT
+    };
+
+    // Names of the terms for printing tuned weights - indexed by EVALUATION_TERM
+    const char * const EVALUATION_TERM_NAMES[EVALUATION_TERM_COUNT] = {
+        "PAWN", "KNIGHT", "ROOK", "BISHOP", "QUEEN", "CENTRALIZATION_BONUS", "PAWN_ADVANCE_BONUS", "LONE_KING_EDGE_BONUS", "KING_PROXIMITY_BONUS"
+    };
+
+    // Weight of each term in centipawns - indexed by EVALUATION_TERM
+    const std::array<int, EVALUATION_TERM_COUNT> EVALUATION_WEIGHTS = {
+        PIECE_VALUES[GAME_PIECE_TYPE::PAWN], PIECE_VALUES[GAME_PIECE_TYPE::KNIGHT], PIECE_VALUES[GAME_PIECE_TYPE::ROOK],
+        PIECE_VALUES[GAME_PIECE_TYPE::BISHOP], PIECE_VALUES[GAME_PIECE_TYPE::QUEEN], 8, 6, 10, 4
+    };
+
+    // How many times each term applies to white minus how many times it applies to black - indexed by EVALUATION_TERM
+    typedef std::array<int, EVALUATION_TERM_COUNT> evaluation_trace;
+
+    // Scores the position in centipawns from the perspective of the current player - positive means the current player is ahead
+    // Counts material, rewards centralized minor pieces and advanced pawns, and when one side is down to a lone king
+    // drives that king to the edge and brings the other king closer so won endgames make progress
+    int evaluate(const Game& game);
+
+    // Breaks the evaluation of the position down into its terms - always from whites perspective
+    // The score evaluate gives white is the sum of each term times its weight in EVALUATION_WEIGHTS
+    evaluation_trace trace_evaluation(const Game& game);
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include "Evaluation_Tuner.h"
+#include "Thread_Pool.h"
+
+#include <fstream>      // std::ifstream
+#include <cmath>        // pow, log, sqrt
+#include <cctype>       // isupper, tolower
+
+namespace Chess_API {
+    static const double ADAM_BETA1 = 0.9;           // Decay of the running mean of the gradient
+    static const double ADAM_BETA2 = 0.999;         // Decay of the running mean of the squared gradient
+    static const double ADAM_EPSILON = 1e-8;        // Keeps the step finite for terms that never apply
+    static const double SCALING_MIN = 0.1;          // Range fit_scaling searches over
+    static const double SCALING_MAX = 10.0;
+    static const int SCALING_STEPS = 60;            // Golden section steps taken by fit_scaling
+
+    // Predicted share of the points white scores - the evaluation is scaled so 400 centipawns is a tenfold edge at a scaling of 1
+    static double predict(double evaluation, double scaling) {
+        return 1.0 / (1.0 + pow(10.0, -scaling * evaluation / 400.0));
+    }
+
+    // Starts with no positions - the weights start from EVALUATION_WEIGHTS
+    Evaluation_Tuner::Evaluation_Tuner() {
+        for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+            weights[i] = EVALUATION_WEIGHTS[i];
+        }
+    }
+
+    // Reads labelled positions from a file - one position to a line starting with a FEN and holding the result
+    // The result is any of 1-0, 0-1 or 1/2-1/2 anywhere after the board - lines without a result are skipped
+    size_t Evaluation_Tuner::load_positions(const std::string& file_path) {
+        std::ifstream input(file_path);
+        if (!input) {
+            throw std::runtime_error("Unable to open " + file_path);
+        }
+
+        // One scratch game is cleared and refilled for every line
+        Game game = Game::make_scratch_board();
+
+        size_t loaded = 0;
+        std::string line;
+        while (std::getline(input, line)) {
+            size_t board_end = line.find(' ');
+            if (board_end == std::string::npos) {
+                continue;
+            }
+
+            int white_half_points = -1;
+            if (line.find("1/2-1/2", board_end) != std::string::npos) {
+                white_half_points = 1;
+            } else if (line.find("1-0", board_end) != std::string::npos) {
+                white_half_points = 2;
+            } else if (line.find("0-1", board_end) != std::string::npos) {
+                white_half_points = 0;
+            }
+            if (white_half_points == -1) {
+                continue;
+            }
+
+            // Lines that don't start with a position are skipped
+            bool valid = true;
+            try {
+                game.from_fen(line);
+            } catch (const std::runtime_error&) {
+                valid = false;
+            }
+
+            if (valid) {
+                add_position(game, white_half_points);
+                ++loaded;
+            }
+        }
+
+        return loaded;
+    }
+
+    // Adds the position on game with the half points white scored in the game it came from - 0, 1 or 2
+    void Evaluation_Tuner::add_position(const Game& game, int white_half_points) {
+        evaluation_trace trace = trace_evaluation(game);
+        tuning_position position;
+        for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+            position.terms[i] = static_cast<int8_t>(trace[i]);
+        }
+        position.result = static_cast<uint8_t>(white_half_points);
+        positions.push_back(position);
+    }
+
+    // Adds up the squared error of the predictions for every position and its gradient for each weight
+    // Returns the error summed over every position - gradient_out is summed the same way
+    double Evaluation_Tuner::accumulate(const tuning_weights& weights_in, tuning_weights * gradient_out, unsigned int threads) const {
+        threads = Thread_Pool::resolve_thread_count(threads);
+        if (positions.size() < threads) {
+            threads = 1;
+        }
+
+        // Each thread sums its own share so no thread waits on another until the shares are added together
+        std::vector<double> errors(threads, 0.0);
+        std::vector<tuning_weights> gradients(threads);
+        double step = scaling * log(10.0) / 400.0;
+        auto run_share = [this, &weights_in, &errors, &gradients, gradient_out, threads, step](unsigned int share) {
+            tuning_weights gradient = {};
+            double error = 0.0;
+            size_t begin = positions.size() * share / threads;
+            size_t end = positions.size() * (share + 1) / threads;
+            for (size_t p = begin; p < end; ++p) {
+                const tuning_position& position = positions[p];
+                double evaluation = 0.0;
+                for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+                    evaluation += position.terms[i] * weights_in[i];
+                }
+
+                double predicted = predict(evaluation, scaling);
+                double difference = predicted - (position.result / 2.0);
+                error += difference * difference;
+
+                if (gradient_out != nullptr) {
+                    double slope = 2.0 * difference * predicted * (1.0 - predicted) * step;
+                    for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+                        gradient[i] += slope * position.terms[i];
+                    }
+                }
+            }
+            errors[share] = error;
+            gradients[share] = gradient;
+        };
+
+        Thread_Pool::get_default()->run_shares(threads, run_share);
+
+        double total_error = 0.0;
+        if (gradient_out != nullptr) {
+            gradient_out->fill(0.0);
+        }
+        for (unsigned int t = 0; t < threads; ++t) {
+            total_error += errors[t];
+            if (gradient_out != nullptr) {
+                for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+                    (*gradient_out)[i] += gradients[t][i];
+                }
+            }
+        }
+        return total_error;
+    }
+
+    // Returns the mean squared error of the predicted results with the weights
+    double Evaluation_Tuner::compute_error(const tuning_weights& weights_in, unsigned int threads) const {
+        if (positions.empty()) {
+            return 0.0;
+        }
+        return accumulate(weights_in, nullptr, threads) / positions.size();
+    }
+
+    // Finds the sigmoid scaling that best predicts the results with the current weights - run before tuning
+    // The error is a smooth bowl in the scaling so a golden section search narrows straight in on it
+    double Evaluation_Tuner::fit_scaling(unsigned int threads) {
+        const double ratio = (sqrt(5.0) - 1.0) / 2.0;
+        double low = SCALING_MIN;
+        double high = SCALING_MAX;
+        for (int step = 0; step < SCALING_STEPS; ++step) {
+            double left = high - ratio * (high - low);
+            double right = low + ratio * (high - low);
+            scaling = left;
+            double left_error = compute_error(weights, threads);
+            scaling = right;
+            double right_error = compute_error(weights, threads);
+            if (left_error < right_error) {
+                high = right;
+            } else {
+                low = left;
+            }
+        }
+
+        scaling = (low + high) / 2.0;
+        return scaling;
+    }
+
+    // Runs the tuning passes and returns the weights it settled on - also kept as the current weights
+    // Steps follow Adam so terms that rarely apply move as readily as material that applies in every position
+    tuning_weights Evaluation_Tuner::tune(const tuning_limits& limits) {
+        if (positions.empty()) {
+            return weights;
+        }
+
+        tuning_weights mean = {};
+        tuning_weights variance = {};
+        tuning_weights gradient;
+        for (int pass = 1; pass <= limits.iterations; ++pass) {
+            accumulate(weights, &gradient, limits.threads);
+            for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+                double average = gradient[i] / positions.size();
+                mean[i] = ADAM_BETA1 * mean[i] + (1.0 - ADAM_BETA1) * average;
+                variance[i] = ADAM_BETA2 * variance[i] + (1.0 - ADAM_BETA2) * average * average;
+
+                double corrected_mean = mean[i] / (1.0 - pow(ADAM_BETA1, pass));
+                double corrected_variance = variance[i] / (1.0 - pow(ADAM_BETA2, pass));
+                weights[i] -= limits.learning_rate * corrected_mean / (sqrt(corrected_variance) + ADAM_EPSILON);
+            }
+        }
+        return weights;
+    }
+}
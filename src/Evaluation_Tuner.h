@@ -0,0 +1,77 @@
+#ifndef CPLUSPLUS_CHESS_EVALUATION_TUNER
+#define CPLUSPLUS_CHESS_EVALUATION_TUNER
+
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>      // int8_t
+#include <cstddef>      // size_t
+#include <stdexcept>    // std::runtime_error
+
+#include "Game.h"
+#include "Evaluation.h"
+
+namespace Chess_API {
+    // Weights being fitted by the tuner - indexed by EVALUATION_TERM - kept fractional until they are rounded for the engine
+    typedef std::array<double, EVALUATION_TERM_COUNT> tuning_weights;
+
+    // A labelled position packed down to what the evaluation sees - its terms and the result of the game it came from
+    // The evaluation is linear in its weights so the board itself is never needed again once traced
+    struct tuning_position {
+        int8_t terms[EVALUATION_TERM_COUNT];    // evaluation_trace of the position - every term fits in a byte
+        uint8_t result;                         // Half points white scored - 0 for a loss, 1 for a draw and 2 for a win
+    };
+
+    // Settings for a tuning run
+    struct tuning_limits {
+        int iterations = 1000;          // Passes over every position
+        double learning_rate = 1.0;     // Step size of each pass in centipawns
+        unsigned int threads = 0;       // Threads sharing each pass - 0 uses every hardware thread
+    };
+
+    // Fits the evaluation weights to game results by minimizing the error of the predicted results - Texel tuning
+    // The prediction for a position is a sigmoid of its evaluation so large advantages predict wins and level positions predict draws
+    // Each pass splits the positions between threads that add up the error and its gradient for their share
+    class Evaluation_Tuner {
+    public:
+        // Starts with no positions - the weights start from EVALUATION_WEIGHTS
+        Evaluation_Tuner();
+
+        // Reads labelled positions from a file - one position to a line starting with a FEN and holding the result
+        // The result is any of 1-0, 0-1 or 1/2-1/2 anywhere after the board - lines without a result are skipped
+        // Returns the number of positions read - throws a runtime_error if the file cannot be opened
+        size_t load_positions(const std::string& file_path);
+
+        // Adds the position on game with the half points white scored in the game it came from - 0, 1 or 2
+        void add_position(const Game& game, int white_half_points);
+
+        // Returns the number of positions held
+        size_t get_position_count() const {return positions.size();}
+
+        // Finds the sigmoid scaling that best predicts the results with the current weights - run before tuning
+        double fit_scaling(unsigned int threads = 0);
+
+        // Returns the mean squared error of the predicted results with the weights
+        double compute_error(const tuning_weights& weights_in, unsigned int threads = 0) const;
+
+        // Runs the tuning passes and returns the weights it settled on - also kept as the current weights
+        tuning_weights tune(const tuning_limits& limits);
+
+        // Returns the current weights
+        const tuning_weights& get_weights() const {return weights;}
+
+        // Returns the sigmoid scaling in use
+        double get_scaling() const {return scaling;}
+
+    private:
+        // Adds up the squared error of the predictions for every position and its gradient for each weight
+        // Returns the error summed over every position - gradient_out is summed the same way
+        double accumulate(const tuning_weights& weights_in, tuning_weights * gradient_out, unsigned int threads) const;
+
+        std::vector<tuning_position> positions;     // Every labelled position
+        tuning_weights weights;                     // Current weights
+        double scaling = 1.0;                       // Multiplies the evaluation before the sigmoid
+    };
+}
+
+#endif
@@ -1,6 +1,43 @@
 #include "Game.h"
+#include "Human_Player.h"
 
 namespace Chess_API {
+    // Random keys for the Zobrist hash - generated from a fixed seed so a position keeps the same key between runs and builds
+    struct zobrist_keys {
+        uint64_t pieces[2][GAME_PIECE_TYPE::TYPEMAX + 1][DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE];
+        uint64_t black_to_move;
+        uint64_t castling[4];
+        uint64_t en_passant[DEFAULT_CHESS_BOARD_SIZE];
+
+        zobrist_keys() {
+            // SplitMix64 - simple and well distributed
+            uint64_t seed = 0x43686573734B6579ULL;
+            auto next_key = [&seed]() {
+                uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            };
+
+            for (int c = 0; c < 2; ++c) {
+                for (int t = 0; t <= GAME_PIECE_TYPE::TYPEMAX; ++t) {
+                    for (int sq = 0; sq < DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE; ++sq) {
+                        pieces[c][t][sq] = next_key();
+                    }
+                }
+            }
+            black_to_move = next_key();
+            for (int i = 0; i < 4; ++i) {
+                castling[i] = next_key();
+            }
+            for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+                en_passant[i] = next_key();
+            }
+        }
+    };
+
+    static const zobrist_keys ZOBRIST_KEYS;
+
     // Default constructor creating an empty game
     Game::Game(const std::shared_ptr<Player> player1_in, const std::shared_ptr<Player> player2_in) {
         // Building out the game board
@@ -37,7 +74,7 @@ namespace Chess_API {
             for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
                 // Adding the game pieces that exist on the copy source
                 if (copy_source.game_board[i][j] != nullptr) {
-                    game_board[i][j] = new game_piece(copy_source.game_board[i][j]->type, copy_source.game_board[i][j]->color);
+                    game_board[i][j] = new game_piece(*copy_source.game_board[i][j]);
                 } else {
                     game_board[i][j] = nullptr;
                 }   
@@ -47,10 +84,52 @@ namespace Chess_API {
         player1 = copy_source.player1;
         player2 = copy_source.player2;
         current_player = copy_source.current_player;
+
+        // Copying the cached state so the copy plays exactly like the source
+        current_game_state = copy_source.current_game_state;
+        en_passant_position = copy_source.en_passant_position;
+        player1_king_position = copy_source.player1_king_position;
+        player2_king_position = copy_source.player2_king_position;
+        hash_history = copy_source.hash_history;
+        hash_key = copy_source.hash_key;
+        hash_key_valid = copy_source.hash_key_valid;
+        history_count = copy_source.history_count;
+        halfmove_clock = copy_source.halfmove_clock;
+        fullmove_number = copy_source.fullmove_number;
+    }
+
+    // Move constructor - takes over the board and pieces of the source without copying them - the source may only be destroyed or assigned to
+    Game::Game(Game&& move_source) noexcept
+        : player1(std::move(move_source.player1)), player2(std::move(move_source.player2)), current_player(std::move(move_source.current_player)),
+          game_board(move_source.game_board), spare_pieces(std::move(move_source.spare_pieces)) {
+        move_source.game_board = nullptr;
+
+        current_game_state = move_source.current_game_state;
+        en_passant_position = move_source.en_passant_position;
+        player1_king_position = move_source.player1_king_position;
+        player2_king_position = move_source.player2_king_position;
+        hash_history = move_source.hash_history;
+        hash_key = move_source.hash_key;
+        hash_key_valid = move_source.hash_key_valid;
+        history_count = move_source.history_count;
+        halfmove_clock = move_source.halfmove_clock;
+        fullmove_number = move_source.fullmove_number;
+    }
+
+    // Returns an empty game between two human stand-ins - scratch space for working through positions away from any real game
+    Game Game::make_scratch_board() {
+        std::shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+        std::shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+        return Game(player1, player2);
     }
 
     // Destructor for removing all of the board allocated memory
     Game::~Game() {
+        // A game that was moved from has no board left to free
+        if (game_board == nullptr) {
+            return;
+        }
+
         // Setting default values for each 'cell' on the chess board
         for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
             for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
@@ -66,24 +145,44 @@ namespace Chess_API {
 
         // Deleting the remainder of the game board
         delete[] game_board;
+
+        for (int i = 0; i < spare_pieces.size(); ++i) {
+            delete spare_pieces[i];
+        }
     }
 
     // Assignment operator - copies the current games data rather then acting as a reference
+    // The board and pieces already held are reused so assigning position after position into the same game allocates nothing
     Game& Game::operator=(const Game& other) {
-        // Building out the game board
-        game_board = new game_piece ** [DEFAULT_CHESS_BOARD_SIZE];
+        if (this == &other) {
+            return *this;
+        }
 
-        // Setting default values for each 'cell' on the chess board
-        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
-            game_board[i] = new game_piece * [DEFAULT_CHESS_BOARD_SIZE];
+        // A game that was moved from has no board left to reuse
+        if (game_board == nullptr) {
+            game_board = new game_piece ** [DEFAULT_CHESS_BOARD_SIZE];
+            for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+                game_board[i] = new game_piece * [DEFAULT_CHESS_BOARD_SIZE];
+                for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                    game_board[i][j] = nullptr;
+                }
+            }
+        }
 
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
             for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
-                // Adding the game pieces that exist on the copy source
-                if (other.game_board[i][j] != nullptr) {
-                    game_board[i][j] = new game_piece(other.game_board[i][j]->type, other.game_board[i][j]->color);
+                game_piece * piece = game_board[i][j];
+                const game_piece * other_piece = other.game_board[i][j];
+                if (other_piece == nullptr) {
+                    if (piece != nullptr) {
+                        release_piece(piece);
+                        game_board[i][j] = nullptr;
+                    }
+                } else if (piece != nullptr) {
+                    *piece = *other_piece;
                 } else {
-                    game_board[i][j] = nullptr;
-                }   
+                    game_board[i][j] = acquire_piece(*other_piece);
+                }
             }
         }
 
@@ -91,9 +190,63 @@ namespace Chess_API {
         player2 = other.player2;
         current_player = other.current_player;
 
+        current_game_state = other.current_game_state;
+        en_passant_position = other.en_passant_position;
+        player1_king_position = other.player1_king_position;
+        player2_king_position = other.player2_king_position;
+        hash_history = other.hash_history;
+        hash_key = other.hash_key;
+        hash_key_valid = other.hash_key_valid;
+        history_count = other.history_count;
+        halfmove_clock = other.halfmove_clock;
+        fullmove_number = other.fullmove_number;
+
         return *this;
     }
 
+    // Move assignment - swaps boards with the other game so its destructor frees the board this game had
+    Game& Game::operator=(Game&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        std::swap(game_board, other.game_board);
+        std::swap(spare_pieces, other.spare_pieces);
+        player1 = std::move(other.player1);
+        player2 = std::move(other.player2);
+        current_player = std::move(other.current_player);
+
+        current_game_state = other.current_game_state;
+        en_passant_position = other.en_passant_position;
+        player1_king_position = other.player1_king_position;
+        player2_king_position = other.player2_king_position;
+        hash_history = other.hash_history;
+        hash_key = other.hash_key;
+        hash_key_valid = other.hash_key_valid;
+        history_count = other.history_count;
+        halfmove_clock = other.halfmove_clock;
+        fullmove_number = other.fullmove_number;
+
+        return *this;
+    }
+
+    // Keeps a captured piece for unmake_move to reuse rather than freeing it
+    void Game::release_piece(game_piece * piece) {
+        spare_pieces.push_back(piece);
+    }
+
+    // Returns a piece equal to piece_in - reusing a released piece when there is one
+    game_piece * Game::acquire_piece(const game_piece& piece_in) {
+        if (spare_pieces.empty()) {
+            return new game_piece(piece_in);
+        }
+
+        game_piece * piece = spare_pieces.back();
+        spare_pieces.pop_back();
+        *piece = piece_in;
+        return piece;
+    }
+
     // Adds the given piece type to the game board at the provided location
     // Throws an error if attempting to place the piece outside the bounds
     void Game::add_piece(const GAME_PIECE_TYPE type_in, const GAME_PIECE_COLOR color_in, const std::pair<int, int>& location) {
@@ -113,6 +266,7 @@ namespace Chess_API {
         }
 
         game_board[x][y] = new game_piece(type_in, color_in);
+        hash_key_valid = false;
 
         // Setting up the players kings position
         if (type_in == KING) {
@@ -144,6 +298,356 @@ namespace Chess_API {
         }
     }
 
+    // Replaces the position with the one described by the FEN - side to move, castling rights, en passant square and move counters
+    // Pieces already on the board are reused so loading position after position into the same game allocates nothing
+    // Missing fields after the board take their starting values and anything after the move counters is ignored so EPD lines load too
+    // The game state is left NORMAL and earlier positions are forgotten - throws a runtime_error if the FEN is malformed
+    void Game::from_fen(std::string_view fen) {
+        // The whole FEN is read before the board is touched so a malformed one leaves the game as it was
+        GAME_PIECE_TYPE types[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE];
+        GAME_PIECE_COLOR colors[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE];
+        std::pair<int, int> king_positions[2] = {std::make_pair(-1, -1), std::make_pair(-1, -1)};
+
+        // FEN lists the rows from the eighth down to the first and each row from the a file across
+        size_t index = 0;
+        int x = DEFAULT_CHESS_BOARD_SIZE - 1;
+        int y = 0;
+        for (; index < fen.size() && fen[index] != ' '; ++index) {
+            char c = fen[index];
+            if (c == '/') {
+                if (y != DEFAULT_CHESS_BOARD_SIZE || x == 0) {
+                    throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                }
+                --x;
+                y = 0;
+            } else if (c >= '1' && c <= '8') {
+                for (int empty = c - '0'; empty > 0; --empty) {
+                    if (y >= DEFAULT_CHESS_BOARD_SIZE) {
+                        throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                    }
+                    types[x][y] = GAME_PIECE_TYPE::NOTYPE;
+                    colors[x][y++] = GAME_PIECE_COLOR::NOCOLOR;
+                }
+            } else {
+                GAME_PIECE_TYPE type;
+                switch (c | 0x20) {
+                    case 'p': type = GAME_PIECE_TYPE::PAWN; break;
+                    case 'n': type = GAME_PIECE_TYPE::KNIGHT; break;
+                    case 'b': type = GAME_PIECE_TYPE::BISHOP; break;
+                    case 'r': type = GAME_PIECE_TYPE::ROOK; break;
+                    case 'q': type = GAME_PIECE_TYPE::QUEEN; break;
+                    case 'k': type = GAME_PIECE_TYPE::KING; break;
+                    default: throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                }
+                if (y >= DEFAULT_CHESS_BOARD_SIZE) {
+                    throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                }
+
+                GAME_PIECE_COLOR color = c < 'a' ? GAME_PIECE_COLOR::WHITE : GAME_PIECE_COLOR::BLACK;
+                if (type == GAME_PIECE_TYPE::KING) {
+                    std::pair<int, int>& king_position = king_positions[color == GAME_PIECE_COLOR::WHITE ? 0 : 1];
+                    if (king_position.first != -1) {
+                        throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                    }
+                    king_position = std::make_pair(x, y);
+                }
+                types[x][y] = type;
+                colors[x][y++] = color;
+            }
+        }
+        if (x != 0 || y != DEFAULT_CHESS_BOARD_SIZE || king_positions[0].first == -1 || king_positions[1].first == -1) {
+            throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+        }
+
+        // Hands out the next space separated field - empty once the FEN runs out
+        auto next_field = [&fen, &index]() {
+            while (index < fen.size() && fen[index] == ' ') {
+                ++index;
+            }
+            size_t start = index;
+            while (index < fen.size() && fen[index] != ' ') {
+                ++index;
+            }
+            return fen.substr(start, index - start);
+        };
+
+        // Reads a move counter - false if the field isn't a plain number
+        auto read_number = [](std::string_view field, int& value) {
+            if (field.empty() || field.size() > 6) {
+                return false;
+            }
+            int number = 0;
+            for (size_t i = 0; i < field.size(); ++i) {
+                if (field[i] < '0' || field[i] > '9') {
+                    return false;
+                }
+                number = (number * 10) + (field[i] - '0');
+            }
+            value = number;
+            return true;
+        };
+
+        std::string_view side = next_field();
+        if (side.size() > 1 || (side.size() == 1 && side[0] != 'w' && side[0] != 'b')) {
+            throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+        }
+        GAME_PIECE_COLOR side_color = side == "b" ? GAME_PIECE_COLOR::BLACK : GAME_PIECE_COLOR::WHITE;
+
+        // Rights in KQkq order - the kings side rook is in the last column
+        bool castling[4] = {false, false, false, false};
+        std::string_view castling_field = next_field();
+        if (castling_field != "-") {
+            for (size_t i = 0; i < castling_field.size(); ++i) {
+                size_t right = std::string_view("KQkq").find(castling_field[i]);
+                if (right == std::string_view::npos) {
+                    throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+                }
+                castling[right] = true;
+            }
+        }
+
+        // Only the square behind a pawn that just moved two rows can be an en passant square
+        std::pair<int, int> en_passant = std::make_pair(-1, -1);
+        std::string_view en_passant_field = next_field();
+        if (!en_passant_field.empty() && en_passant_field != "-") {
+            if (en_passant_field.size() != 2 || VALID_CHARS.find(en_passant_field[0]) == std::string::npos
+                || (en_passant_field[1] != '3' && en_passant_field[1] != '6')) {
+                throw std::runtime_error(INVALID_FEN_ERROR_MSG);
+            }
+            en_passant = std::make_pair(en_passant_field[1] - '1', en_passant_field[0] - 'a');
+        }
+
+        // EPD puts operations where the move counters would be so anything else ends the FEN
+        int halfmove = 0;
+        int fullmove = 1;
+        if (read_number(next_field(), halfmove)) {
+            read_number(next_field(), fullmove);
+        }
+
+        set_position(types, colors, king_positions, side_color, castling, en_passant, halfmove, fullmove);
+    }
+
+    // Returns the position as a FEN - castling rights come from the kings and rooks still unmoved on their starting squares
+    // Built straight into one string so writing out many positions costs a single allocation each
+    std::string Game::to_fen() const {
+        // Indexed by GAME_PIECE_TYPE
+        static const char PIECE_CHARS[] = {' ', 'p', 'n', 'r', 'b', 'k', 'q'};
+
+        std::string fen;
+        fen.reserve(96);
+        for (int i = DEFAULT_CHESS_BOARD_SIZE - 1; i >= 0; --i) {
+            int empty = 0;
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece * piece = game_board[i][j];
+                if (piece == nullptr) {
+                    ++empty;
+                    continue;
+                }
+                if (empty > 0) {
+                    fen.push_back(static_cast<char>('0' + empty));
+                    empty = 0;
+                }
+                char piece_char = PIECE_CHARS[piece->type];
+                fen.push_back(piece->color == GAME_PIECE_COLOR::WHITE ? static_cast<char>(piece_char - 0x20) : piece_char);
+            }
+            if (empty > 0) {
+                fen.push_back(static_cast<char>('0' + empty));
+            }
+            if (i > 0) {
+                fen.push_back('/');
+            }
+        }
+
+        fen.push_back(' ');
+        fen.push_back(current_player->get_player_color() == GAME_PIECE_COLOR::WHITE ? 'w' : 'b');
+        fen.push_back(' ');
+
+        size_t castling_start = fen.size();
+        const char castling_chars[4] = {'K', 'Q', 'k', 'q'};
+        for (int right = 0; right < 4; ++right) {
+            int back_row = right < 2 ? 0 : DEFAULT_CHESS_BOARD_SIZE - 1;
+            int rook_column = right % 2 == 0 ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+            if (has_castling_right(back_row, rook_column)) {
+                fen.push_back(castling_chars[right]);
+            }
+        }
+        if (fen.size() == castling_start) {
+            fen.push_back('-');
+        }
+
+        fen.push_back(' ');
+        if (validate_position(en_passant_position)) {
+            fen.push_back(VALID_CHARS[en_passant_position.second]);
+            fen.push_back(VALID_NUMS[en_passant_position.first]);
+        } else {
+            fen.push_back('-');
+        }
+
+        fen.push_back(' ');
+        fen += std::to_string(halfmove_clock);
+        fen.push_back(' ');
+        fen += std::to_string(fullmove_number);
+        return fen;
+    }
+
+    // Replaces the position with the packed one - pieces already on the board are reused so decoding into the same game allocates nothing
+    // The game state is left NORMAL and earlier positions are forgotten - throws a runtime_error if the packed position is malformed
+    void Game::from_packed(const packed_position& packed) {
+        // Checked in full before the board is touched so a malformed position leaves the game as it was
+        GAME_PIECE_TYPE types[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE];
+        GAME_PIECE_COLOR colors[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE];
+        std::pair<int, int> king_positions[2] = {std::make_pair(-1, -1), std::make_pair(-1, -1)};
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                types[i][j] = GAME_PIECE_TYPE::NOTYPE;
+                colors[i][j] = GAME_PIECE_COLOR::NOCOLOR;
+            }
+        }
+
+        // Walks the occupied squares from the lowest up - each takes the next nibble
+        int piece_count = 0;
+        for (uint64_t occupied = packed.occupancy; occupied != 0; occupied &= occupied - 1) {
+            if (piece_count == 32) {
+                throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+            }
+            int square = 0;
+            while (((occupied >> square) & 1) == 0) {
+                ++square;
+            }
+
+            int code = (packed.pieces[piece_count / 2] >> ((piece_count % 2) * 4)) & 0xF;
+            ++piece_count;
+            int type = (code & 7) + GAME_PIECE_TYPE::PAWN;
+            if (type > GAME_PIECE_TYPE::TYPEMAX) {
+                throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+            }
+
+            int x = square / DEFAULT_CHESS_BOARD_SIZE;
+            int y = square % DEFAULT_CHESS_BOARD_SIZE;
+            GAME_PIECE_COLOR color = (code & 8) == 0 ? GAME_PIECE_COLOR::WHITE : GAME_PIECE_COLOR::BLACK;
+            if (type == GAME_PIECE_TYPE::KING) {
+                std::pair<int, int>& king_position = king_positions[color == GAME_PIECE_COLOR::WHITE ? 0 : 1];
+                if (king_position.first != -1) {
+                    throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+                }
+                king_position = std::make_pair(x, y);
+            }
+            types[x][y] = static_cast<GAME_PIECE_TYPE>(type);
+            colors[x][y] = color;
+        }
+        if (king_positions[0].first == -1 || king_positions[1].first == -1) {
+            throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+        }
+
+        bool castling[4];
+        for (int right = 0; right < 4; ++right) {
+            castling[right] = ((packed.flags >> (right + 1)) & 1) != 0;
+        }
+
+        std::pair<int, int> en_passant = std::make_pair(-1, -1);
+        if (packed.en_passant != 0xFF) {
+            // Only the square behind a pawn that just moved two rows can be an en passant square
+            int row = packed.en_passant / DEFAULT_CHESS_BOARD_SIZE;
+            if (row != 2 && row != DEFAULT_CHESS_BOARD_SIZE - 3) {
+                throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+            }
+            en_passant = std::make_pair(row, packed.en_passant % DEFAULT_CHESS_BOARD_SIZE);
+        }
+
+        GAME_PIECE_COLOR side_color = (packed.flags & 1) != 0 ? GAME_PIECE_COLOR::BLACK : GAME_PIECE_COLOR::WHITE;
+        set_position(types, colors, king_positions, side_color, castling, en_passant, packed.halfmove_clock, packed.fullmove_number);
+    }
+
+    // Packs the position into 32 bytes - the score and result are left for the caller to fill in
+    // Throws a runtime_error if there are more than 32 pieces on the board
+    void Game::to_packed(packed_position& packed) const {
+        packed.occupancy = 0;
+        for (int i = 0; i < 16; ++i) {
+            packed.pieces[i] = 0;
+        }
+
+        int piece_count = 0;
+        for (int square = 0; square < DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE; ++square) {
+            game_piece * piece = game_board[square / DEFAULT_CHESS_BOARD_SIZE][square % DEFAULT_CHESS_BOARD_SIZE];
+            if (piece == nullptr) {
+                continue;
+            }
+            if (piece_count == 32) {
+                throw std::runtime_error(INVALID_PACKED_POSITION_ERROR_MSG);
+            }
+
+            int code = (piece->type - GAME_PIECE_TYPE::PAWN) | (piece->color == GAME_PIECE_COLOR::BLACK ? 8 : 0);
+            packed.occupancy |= uint64_t(1) << square;
+            packed.pieces[piece_count / 2] |= static_cast<uint8_t>(code << ((piece_count % 2) * 4));
+            ++piece_count;
+        }
+
+        // The result bits belong to the caller
+        uint8_t flags = packed.flags & 0x60;
+        flags |= current_player->get_player_color() == GAME_PIECE_COLOR::BLACK ? 1 : 0;
+        for (int right = 0; right < 4; ++right) {
+            int back_row = right < 2 ? 0 : DEFAULT_CHESS_BOARD_SIZE - 1;
+            int rook_column = right % 2 == 0 ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+            if (has_castling_right(back_row, rook_column)) {
+                flags |= static_cast<uint8_t>(1 << (right + 1));
+            }
+        }
+        packed.flags = flags;
+
+        packed.en_passant = validate_position(en_passant_position)
+            ? static_cast<uint8_t>((en_passant_position.first * DEFAULT_CHESS_BOARD_SIZE) + en_passant_position.second) : 0xFF;
+        packed.halfmove_clock = static_cast<uint8_t>(halfmove_clock < 255 ? halfmove_clock : 255);
+        packed.fullmove_number = static_cast<uint16_t>(fullmove_number < 65535 ? fullmove_number : 65535);
+    }
+
+    // Replaces every piece on the board with the types and colors given - pieces are reused and the move counts stand in for castling rights
+    // Shared by from_fen and from_packed once they have checked the position - the game state is left NORMAL and earlier positions are forgotten
+    void Game::set_position(const GAME_PIECE_TYPE (&types)[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE], const GAME_PIECE_COLOR (&colors)[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE],
+        const std::pair<int, int> (&king_positions)[2], GAME_PIECE_COLOR side_color, const bool (&castling)[4], const std::pair<int, int>& en_passant, int halfmove, int fullmove) {
+        // Move counts stand in for what the position says about the pieces - a piece that counts as moved can't castle or move a pawn two rows
+        // A piece already on a square that stays occupied is overwritten in place rather than going through the spare pieces
+        const int back_rows[2] = {0, DEFAULT_CHESS_BOARD_SIZE - 1};
+        const int pawn_rows[2] = {1, DEFAULT_CHESS_BOARD_SIZE - 2};
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                if (types[i][j] == GAME_PIECE_TYPE::NOTYPE) {
+                    if (game_board[i][j] != nullptr) {
+                        release_piece(game_board[i][j]);
+                        game_board[i][j] = nullptr;
+                    }
+                    continue;
+                }
+
+                game_piece * piece = game_board[i][j];
+                if (piece != nullptr) {
+                    *piece = game_piece(types[i][j], colors[i][j]);
+                } else {
+                    piece = acquire_piece(game_piece(types[i][j], colors[i][j]));
+                }
+                int c = colors[i][j] == GAME_PIECE_COLOR::WHITE ? 0 : 1;
+                if (types[i][j] == GAME_PIECE_TYPE::PAWN) {
+                    piece->moves_made = i == pawn_rows[c] ? 0 : 1;
+                } else if (types[i][j] == GAME_PIECE_TYPE::KING) {
+                    piece->moves_made = i == back_rows[c] && j == 4 && (castling[c * 2] || castling[(c * 2) + 1]) ? 0 : 1;
+                } else if (types[i][j] == GAME_PIECE_TYPE::ROOK) {
+                    bool unmoved = i == back_rows[c] && ((j == DEFAULT_CHESS_BOARD_SIZE - 1 && castling[c * 2]) || (j == 0 && castling[(c * 2) + 1]));
+                    piece->moves_made = unmoved ? 0 : 1;
+                }
+                game_board[i][j] = piece;
+            }
+        }
+
+        player1_king_position = king_positions[0];
+        player2_king_position = king_positions[1];
+        current_player = player1->get_player_color() == side_color ? player1 : player2;
+        en_passant_position = en_passant;
+        halfmove_clock = halfmove;
+        fullmove_number = fullmove;
+        history_count = 0;
+        current_game_state = NORMAL;
+        hash_key_valid = false;
+    }
+
     // Returns the game_piece pointer for the provided location
     // Throws an error if attempting to pull a location beyond the scope of the board
     // Simply returns an invalid piece if there isn't anything there
@@ -176,6 +680,7 @@ namespace Chess_API {
         if (game_board[x][y] != nullptr) {
             delete game_board[x][y];
             game_board[x][y] = nullptr;
+            hash_key_valid = false;
         }
     }
 
@@ -184,6 +689,7 @@ namespace Chess_API {
     // Warning - ensure the move has been validated by is_valid_move - this can have memory violations otherwise
     // Simulate_move is a flag that will do all of the normal functionality with the expectation that the move will be undone
     // Therefore it does not update cached information (en_passant_position / king position)
+    // Pawns reaching the far side of the board are promoted to a queen - except when simulating
     // Returns the game piece and location of the game piece captured - returns an invalid game piece if no piece was captured
     std::pair<game_piece, std::pair<int, int>> Game::play_move(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos, bool simulate_move) {
         int start_x = start_pos.first;
@@ -202,6 +708,7 @@ namespace Chess_API {
 
         game_piece * start_piece_ptr = game_board[start_x][start_y];
         game_piece * end_piece_ptr = nullptr;
+        hash_key_valid = false;
         game_piece return_piece;
         std::pair<int, int> return_loc;
         bool normal_move = false;
@@ -217,7 +724,7 @@ namespace Chess_API {
             if (end_pos == en_passant_position) {
                 return_piece = get_location(std::make_pair(end_x - delta_x, end_y));
                 return_loc = std::make_pair(end_x - delta_x, end_y);
-                delete game_board[end_x - delta_x][end_y];
+                release_piece(game_board[end_x - delta_x][end_y]);
                 game_board[end_x - delta_x][end_y] = nullptr;
                 game_board[end_x][end_y] = start_piece_ptr;
                 game_board[start_x][start_y] = nullptr;
@@ -267,7 +774,7 @@ namespace Chess_API {
             // If the end spot is an empty location - simply transfer ownership of the memory from one position to the other
             // Otherwise first deallocate the memory for the end location
             if (end_piece_ptr != nullptr) {
-                delete game_board[end_x][end_y];
+                release_piece(game_board[end_x][end_y]);
             }
 
             game_board[end_x][end_y] = start_piece_ptr;
@@ -291,19 +798,35 @@ namespace Chess_API {
             en_passant_position = std::make_pair(-1, -1);
         }
 
+        // Pawns reaching the far side of the board are promoted to a queen
+        if (start_piece_ptr->type == GAME_PIECE_TYPE::PAWN && !simulate_move) {
+            int promotion_x = start_piece_ptr->pawn_move_positive_x ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+
+            if (end_x == promotion_x) {
+                int moves_made = start_piece_ptr->moves_made;
+                *start_piece_ptr = game_piece(GAME_PIECE_TYPE::QUEEN, start_piece_ptr->color);
+                start_piece_ptr->moves_made = moves_made;
+            }
+        }
+
         return std::make_pair(return_piece, return_loc);
     }
 
     // Updates the internal game state based on chess ruling
-    // Essentially determines if the game is in stalemate / check / checkmate / or normal play
+    // Essentially determines if the game is in stalemate / check / checkmate / a drawn repetition / the fifty move rule / or normal play
     // Intented to be used after every call of play_move - must be manually called
     void Game::update_game_state() {
         // Run through each function to check which state the game is in - check first since checkmate implies check
         // Stalemate last because stalemate is separate from both
+        // A checkmate on the fiftieth move still wins so the draws only come after checkmate and stalemate
         if (is_in_checkmate()) {
             current_game_state = GAME_STATE::CHECKMATE;
         } else if (is_in_stalemate()) {
             current_game_state = GAME_STATE::STALEMATE;
+        } else if (is_repetition(2)) {
+            current_game_state = GAME_STATE::THREEFOLD_REPETITION;
+        } else if (halfmove_clock >= FIFTY_MOVE_RULE_HALFMOVES) {
+            current_game_state = GAME_STATE::FIFTY_MOVE_RULE;
         } else if (is_in_check()) {
             current_game_state = GAME_STATE::CHECK;
         } else {
@@ -431,7 +954,7 @@ namespace Chess_API {
 
     // Validates if the given piece can move described by move - for restricted pieces
     Game::MOVE_ERROR_CODE Game::validate_piece_move_restricted(const GAME_PIECE_TYPE type, const std::pair<int, int>& move) const {
-        std::vector<std::pair<int, int>> moveset = PIECE_MOVESETS.at(type);
+        const std::vector<std::pair<int, int>>& moveset = PIECE_MOVESETS.at(type);
 
         auto move_found = std::find(moveset.cbegin(), moveset.cend(), move);
 
@@ -511,7 +1034,7 @@ namespace Chess_API {
 
     // Validates that the move is an acceptable move for a pawn given the current state of the board - no consideration for checks
     Game::MOVE_ERROR_CODE Game::validate_pawn_move(const game_piece& starting_piece, const game_piece& ending_piece, const std::pair<int, int>& move, const std::pair<int, int>& end_pos) const {
-        std::vector<std::pair<int, int>> moveset = PIECE_MOVESETS.at(GAME_PIECE_TYPE::PAWN);
+        const std::vector<std::pair<int, int>>& moveset = PIECE_MOVESETS.at(GAME_PIECE_TYPE::PAWN);
         // Pawns may only move in a set x-direction, therefore check to ensure the move aligns with this pawns direction
         if (starting_piece.pawn_move_positive_x) {
             if (move.first < 0) {
@@ -581,8 +1104,8 @@ namespace Chess_API {
 
         // Determine if the move is attempting to castle
         if (abs(move.second) == 2) {
-            // Determine if the king has moved
-            if (starting_piece.moves_made != 0) {
+            // Determine if the king has moved - a king placed away from its starting column can never castle
+            if (starting_piece.moves_made != 0 || start_pos.second != 4) {
                 return ILLEGAL_MOVE;
             }
 
@@ -704,51 +1227,53 @@ namespace Chess_API {
     }
 
     // Determines if the provided move would place the player in check - only checks the one move and not any moves between it
+    // The pieces are moved by pointer and put back afterwards so nothing is allocated - this runs for every move generated
     bool Game::simulate_move_for_check(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos) {
-        // Setup the variables to simulate playing the incremental move
-        game_piece start_piece = get_location(start_pos);
-        std::pair<game_piece, std::pair<int, int>> removed_data = play_move(start_pos, end_pos, true);
-        game_piece end_piece = removed_data.first;
-
-        bool return_val = is_in_check();
+        game_piece * moving_piece = game_board[start_pos.first][start_pos.second];
+        std::pair<int, int> previous_player1_king_position = player1_king_position;
+        std::pair<int, int> previous_player2_king_position = player2_king_position;
+
+        // En passant captures the pawn beside the start position rather than a piece on the end position
+        std::pair<int, int> captured_pos = end_pos;
+        if (moving_piece->type == GAME_PIECE_TYPE::PAWN && end_pos == en_passant_position && start_pos.second != end_pos.second) {
+            captured_pos = std::make_pair(start_pos.first, end_pos.second);
+        }
+        game_piece * captured_piece = game_board[captured_pos.first][captured_pos.second];
 
-        // Case where the king castled - we need to replace where both the king and rook were
-        if (start_piece.type == GAME_PIECE_TYPE::KING && abs(start_pos.second - end_pos.second) == 2) {
-            int delta_y = end_pos.second - start_pos.second;
-            // Getting the rooks new position relative to the king
-            int rook_y = delta_y > 0 ? end_pos.second - 1 : end_pos.second + 1;
-            game_piece * rook_ptr = game_board[start_pos.first][rook_y];
-            game_piece * king_ptr = game_board[end_pos.first][end_pos.second];
+        game_board[captured_pos.first][captured_pos.second] = nullptr;
+        game_board[end_pos.first][end_pos.second] = moving_piece;
+        game_board[start_pos.first][start_pos.second] = nullptr;
 
-            // Replacing the king
-            game_board[start_pos.first][start_pos.second] = king_ptr;
-            game_board[end_pos.first][end_pos.second] = nullptr;
+        // Castling also moves the rook next to the king
+        int delta_y = end_pos.second - start_pos.second;
+        bool castling = moving_piece->type == GAME_PIECE_TYPE::KING && abs(delta_y) == 2;
+        int rook_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+        int end_rook_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 3 : 3;
+        if (castling) {
+            game_board[start_pos.first][end_rook_y] = game_board[start_pos.first][rook_y];
+            game_board[start_pos.first][rook_y] = nullptr;
+        }
 
-            // Replacing the rook
-            if (delta_y > 0) {
-                game_board[start_pos.first][DEFAULT_CHESS_BOARD_SIZE - 1] = rook_ptr;
+        if (moving_piece->type == GAME_PIECE_TYPE::KING) {
+            if (current_player == player1) {
+                player1_king_position = end_pos;
             } else {
-                game_board[start_pos.first][0] = rook_ptr;
+                player2_king_position = end_pos;
             }
+        }
 
-            game_board[start_pos.first][rook_y] = nullptr;
-            
-        } else {
-            // Clearing all potential positions where a piece could still be at before re-adding all of the pieces
-            remove_piece(removed_data.second);
-            remove_piece(start_pos);
-
-            // Readding pieces with moves made to ensure the piece is exactly the same as the previous version
-            if (validate_game_piece(start_piece)) {
-                game_board[start_pos.first][start_pos.second] = new game_piece(start_piece.type, start_piece.color);
-                game_board[start_pos.first][start_pos.second]->moves_made = start_piece.moves_made;
-            }
+        bool return_val = is_in_check();
 
-            if (validate_game_piece(end_piece)) {
-                game_board[removed_data.second.first][removed_data.second.second] = new game_piece(end_piece.type, end_piece.color);
-                game_board[removed_data.second.first][removed_data.second.second]->moves_made = end_piece.moves_made;
-            }
+        // Putting every piece back where it was
+        if (castling) {
+            game_board[start_pos.first][rook_y] = game_board[start_pos.first][end_rook_y];
+            game_board[start_pos.first][end_rook_y] = nullptr;
         }
+        game_board[start_pos.first][start_pos.second] = moving_piece;
+        game_board[end_pos.first][end_pos.second] = nullptr;
+        game_board[captured_pos.first][captured_pos.second] = captured_piece;
+        player1_king_position = previous_player1_king_position;
+        player2_king_position = previous_player2_king_position;
 
         return return_val;
     }
@@ -770,9 +1295,9 @@ namespace Chess_API {
         int delta_x = abs(end_pos.first - start_pos.first);
         int delta_y = abs(end_pos.second - start_pos.second);
 
-        // For moves greater than 1 unit we must simulate each move to ensure that no move along the route places the player in check
-        // Knights are the exception - they move straight to their end position
-        if ((delta_x > 1 || delta_y > 1) && start_piece.type != GAME_PIECE_TYPE::KNIGHT) {
+        // A castling king must not pass through check so each square along its route is simulated
+        // Every other piece only has to leave the player out of check once it arrives
+        if (start_piece.type == GAME_PIECE_TYPE::KING && (delta_x > 1 || delta_y > 1)) {
             std::pair<float, float> move_delta = calculate_piece_delta_move(start_piece, start_pos, end_pos);
             int move_delta_x = round(move_delta.first);
             int move_delta_y = round(move_delta.second);
@@ -794,7 +1319,7 @@ namespace Chess_API {
             // Making it out of the do-while loop means that all of the moves are valid and the move can be accomplished
             return VALID_MOVE;
         
-        // A restricted piece can just make the move - simply ensure that the move won't place the player in check
+        // Any other move can just be made - simply ensure that the move won't place the player in check
         } else {
             if (simulate_move_for_check(start_pos, end_pos)) {
                 return CHECK_MOVE;
@@ -806,6 +1331,7 @@ namespace Chess_API {
 
     // Swaps which player is the current player
     void Game::swap_current_player() {
+        hash_key_valid = false;
         if (current_player == player1) {
             current_player = player2;
         } else {
@@ -813,7 +1339,21 @@ namespace Chess_API {
         }
     }
 
+    // Replaces both players without touching the position - the new player with the color on move becomes the current player
+    // Throws a runtime_error if the players have the same color
+    void Game::set_players(const std::shared_ptr<Player> player1_in, const std::shared_ptr<Player> player2_in) {
+        if (player1_in->get_player_color() == player2_in->get_player_color()) {
+            throw std::runtime_error("The player colors must be different");
+        }
+
+        GAME_PIECE_COLOR color_on_move = current_player->get_player_color();
+        player1 = player1_in;
+        player2 = player2_in;
+        current_player = player1->get_player_color() == color_on_move ? player1 : player2;
+    }
+
     // Determines if the current player is in check
+    // Runs for every move generated so it sticks to bounds checks rather than exceptions and allocates nothing
     bool Game::is_in_check() {
         // Get the current players king position
         std::pair<int, int> king_pos = current_player == player1 ? player1_king_position : player2_king_position;
@@ -826,94 +1366,56 @@ namespace Chess_API {
         game_piece king = get_location(king_pos);
 
         // Check every piece around the king - if they are the same color then the king is safe from all pieces except knights
-        std::vector<std::pair<int, int>> area_around_king = {std::make_pair(1, 0), std::make_pair(-1, 0), std::make_pair(0, 1), std::make_pair(0, -1),
-                                                             std::make_pair(1, 1), std::make_pair(-1, 1), std::make_pair(1, -1), std::make_pair(-1, -1)};
-        game_piece piece;
+        static const std::pair<int, int> area_around_king[] = {std::make_pair(1, 0), std::make_pair(-1, 0), std::make_pair(0, 1), std::make_pair(0, -1),
+                                                               std::make_pair(1, 1), std::make_pair(-1, 1), std::make_pair(1, -1), std::make_pair(-1, -1)};
 
-        for(int i = 0; i < area_around_king.size(); ++i) {
-            std::pair<int, int> piece_delta = area_around_king.at(i);
-            int piece_x = piece_delta.first + king_pos.first;
-            int piece_y = piece_delta.second + king_pos.second;
+        for (int i = 0; i < 8; ++i) {
+            const std::pair<int, int>& piece_delta = area_around_king[i];
 
+            // Expand out in this direction until we hit the edge of the board or a piece
+            for (int j = 1; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                std::pair<int, int> piece_pos = std::make_pair((piece_delta.first * j) + king_pos.first, (piece_delta.second * j) + king_pos.second);
+                if (!validate_position(piece_pos)) {
+                    break;
+                }
 
-            try {
-                piece = get_location(std::make_pair(piece_x, piece_y));
-
-                // If this piece is a different color and a valid game piece then check if that piece can make a legal move to the king
-                if (piece.color != king.color && validate_game_piece(piece)) {
-                    // Temporarily swap the current player to see if the enemy piece can make the legal move
-                    swap_current_player();
+                game_piece * piece = game_board[piece_pos.first][piece_pos.second];
+                if (piece == nullptr) {
+                    continue;
+                }
 
-                    // If this move is legal then the current player is in check
-                    if(is_legal_move(std::make_pair(piece_x, piece_y), king_pos) == VALID_MOVE) {
-                        swap_current_player();
-                        return true;
-                    // Otherwise move on to the next piece
-                    } else {
-                        swap_current_player();
-                    }
-                // In the case where the square is empty then continue expanding out in that direction until we hit the edge of the board or a valid piece
-                } else if (!validate_game_piece(piece)) {
-                    // Loop to scale up the direction and get the next piece
-                    for(int j = 2; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
-                        int piece_x = (piece_delta.first * j) + king_pos.first;
-                        int piece_y = (piece_delta.second * j) + king_pos.second;
-
-                        // If we hit a wall then this will throw an error that we catch below
-                        piece = get_location(std::make_pair(piece_x, piece_y));
-
-                        // If we find a valid piece check if its the same color first
-                        if (validate_game_piece(piece)) {
-                            // This direction is safe, move on to the next one
-                            if (piece.color == king.color) {
-                                break;
-                            // Otherwise determine if the piece has a legal move to the king
-                            } else {
-                                // Temporarily swap the current player to see if the enemy piece can make the legal move
-                                swap_current_player();
-
-                                // If this move is legal then the current player is in check
-                                if(is_legal_move(std::make_pair(piece_x, piece_y), king_pos) == VALID_MOVE) {
-                                    swap_current_player();
-                                    return true;
-                                // Otherwise this direction is safe, move on to the next direction
-                                } else {
-                                    swap_current_player();
-                                    break;
-                                }
-                            }
-                        }
-                    }
+                // This direction is safe if the first piece is the same color
+                if (piece->color == king.color) {
+                    break;
                 }
 
-            // Expected error if this exceeds the bounds - this position doesn't matter since the king is next to a wall
-            } catch (std::runtime_error) {
-                continue;
-            }
+                // Temporarily swap the current player to see if the enemy piece can make the legal move
+                swap_current_player();
+                bool attacked = is_legal_move(piece_pos, king_pos) == VALID_MOVE;
+                swap_current_player();
 
+                // If this move is legal then the current player is in check - otherwise the piece blocks the rest of this direction
+                if (attacked) {
+                    return true;
+                }
+                break;
+            }
         }
 
         // Check for a knight of a different color in every knight moveset away from the king to ensure there isn't any knights there
-        std::vector<std::pair<int, int>> knight_moveset = PIECE_MOVESETS.at(GAME_PIECE_TYPE::KNIGHT);
+        const std::vector<std::pair<int, int>>& knight_moveset = PIECE_MOVESETS.at(GAME_PIECE_TYPE::KNIGHT);
 
         for (int i = 0; i < knight_moveset.size(); ++i) {
-            std::pair<int, int> piece_delta = knight_moveset[i];
-            int piece_x = piece_delta.first + king_pos.first;
-            int piece_y = piece_delta.second + king_pos.second;
-
-            try {
-                piece = get_location(std::make_pair(piece_x, piece_y));
-                
-                // If the piece is a different colored knight then the current player is in check
-                if (piece.color != king.color && validate_game_piece(piece) && piece.type == GAME_PIECE_TYPE::KNIGHT) {
-                    return true;
-                }
-
-            // Expected error if we hit a wall
-            } catch (std::runtime_error) {
+            std::pair<int, int> piece_pos = std::make_pair(knight_moveset[i].first + king_pos.first, knight_moveset[i].second + king_pos.second);
+            if (!validate_position(piece_pos)) {
                 continue;
             }
 
+            // If the piece is a different colored knight then the current player is in check
+            game_piece * piece = game_board[piece_pos.first][piece_pos.second];
+            if (piece != nullptr && piece->color != king.color && piece->type == GAME_PIECE_TYPE::KNIGHT) {
+                return true;
+            }
         }
 
         // Finally if all of the above did not return anything then the current player is not in check
@@ -923,7 +1425,6 @@ namespace Chess_API {
     // Determines if the current player has a valid move to make
     bool Game::current_player_has_valid_move() {
         game_piece player_piece;
-        std::vector<std::pair<int, int>> piece_moves;
         std::pair<int, int> move;
         std::pair<int, int> start_pos;
         std::pair<int, int> end_pos;
@@ -931,7 +1432,7 @@ namespace Chess_API {
             for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
                 player_piece = get_location(std::make_pair(i, j));
                 if (validate_game_piece(player_piece) && (current_player->get_player_color() == player_piece.color)) {
-                    piece_moves = PIECE_MOVESETS.at(player_piece.type);
+                    const std::vector<std::pair<int, int>>& piece_moves = PIECE_MOVESETS.at(player_piece.type);
                     for (int k = 0; k < piece_moves.size(); ++k) {
                         move = piece_moves.at(k);
                         start_pos = std::make_pair(i, j);
@@ -975,5 +1476,606 @@ namespace Chess_API {
         }
         return !current_player_has_valid_move();
     }
-}
+    // Returns every valid move for the current player as {start_pos, end_pos} pairs
+    // Walks the same movesets as current_player_has_valid_move but collects every move rather than stopping at the first
+    std::vector<board_move> Game::get_valid_moves() {
+        board_move moves[MAX_POSITION_MOVES];
+        int move_count = get_valid_moves(moves);
+        return std::vector<board_move>(moves, moves + move_count);
+    }
+
+    // Writes every valid move of the type for the current player into moves_out and returns how many there were
+    // moves_out must have room for MAX_POSITION_MOVES moves - lets the search keep its move lists off the heap
+    // Moves of the other types are skipped before they are validated so each stage only pays for its own moves
+    int Game::get_valid_moves(board_move * moves_out, MOVE_TYPE type) {
+        int move_count = 0;
+        GAME_PIECE_COLOR player_color = current_player->get_player_color();
+        std::pair<int, int> start_pos;
+        std::pair<int, int> end_pos;
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                const game_piece * player_piece = game_board[i][j];
+                if (player_piece == nullptr || player_piece->color != player_color) {
+                    continue;
+                }
+
+                start_pos = std::make_pair(i, j);
+                int promotion_x = player_piece->pawn_move_positive_x ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+                const std::vector<std::pair<int, int>>& piece_moves = PIECE_MOVESETS.at(player_piece->type);
+                for (int k = 0; k < piece_moves.size(); ++k) {
+                    const std::pair<int, int>& move = piece_moves[k];
+                    if (player_piece->is_restricted) {
+                        end_pos = std::make_pair(i + move.first, j + move.second);
+                        if (!validate_position(end_pos)) {
+                            continue;
+                        }
+
+                        // Own pieces and backwards pawn moves can never be valid so they are skipped before the full validation
+                        const game_piece * target = game_board[end_pos.first][end_pos.second];
+                        if (target != nullptr && target->color == player_color) {
+                            continue;
+                        }
+
+                        bool is_capture = target != nullptr;
+                        if (player_piece->type == GAME_PIECE_TYPE::PAWN) {
+                            if ((move.first > 0) != player_piece->pawn_move_positive_x) {
+                                continue;
+                            }
+                            is_capture = move.second != 0 || end_pos.first == promotion_x;
+                        }
+
+                        if ((type == CAPTURE_MOVES && !is_capture) || (type == QUIET_MOVES && is_capture)) {
+                            continue;
+                        }
+
+                        if (is_valid_move(start_pos, end_pos) == VALID_MOVE) {
+                            moves_out[move_count++] = std::make_pair(start_pos, end_pos);
+                        }
+                    } else {
+                        // Unrestricted pieces slide until they leave the board or run into another piece
+                        for (int l = 1; validate_position(std::make_pair(i + (l * move.first), j + (l * move.second))); ++l) {
+                            end_pos = std::make_pair(i + (l * move.first), j + (l * move.second));
+                            const game_piece * target = game_board[end_pos.first][end_pos.second];
+                            bool is_capture = target != nullptr;
+                            bool wanted = (type == ALL_MOVES) || ((type == CAPTURE_MOVES) == is_capture);
+
+                            if (wanted && (target == nullptr || target->color != player_color) && is_valid_move(start_pos, end_pos) == VALID_MOVE) {
+                                moves_out[move_count++] = std::make_pair(start_pos, end_pos);
+                            }
+                            if (target != nullptr) {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return move_count;
+    }
+
+    // Finds the valid move the standard algebraic notation describes for the current player - {-1, -1} positions if there is none
+    // Check and annotation marks are ignored - promotions other than to a queen have no move since pawns only ever promote to queens
+    // Only pieces of the named type that can reach the destination are validated rather than generating every move
+    board_move Game::find_san_move(std::string_view san) {
+        board_move no_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+            san.remove_suffix(1);
+        }
+        if (san.empty()) {
+            return no_move;
+        }
+
+        // Castling names the side rather than the squares
+        GAME_PIECE_COLOR color = current_player->get_player_color();
+        int back_row = color == GAME_PIECE_COLOR::WHITE ? 0 : DEFAULT_CHESS_BOARD_SIZE - 1;
+        if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+            board_move castle = std::make_pair(std::make_pair(back_row, 4), std::make_pair(back_row, san.size() == 3 ? 6 : 2));
+            game_piece * king = game_board[back_row][4];
+            if (king == nullptr || king->type != GAME_PIECE_TYPE::KING || is_valid_move(castle.first, castle.second) != VALID_MOVE) {
+                return no_move;
+            }
+            return castle;
+        }
+
+        GAME_PIECE_TYPE type = GAME_PIECE_TYPE::PAWN;
+        size_t index = 1;
+        switch (san[0]) {
+            case 'N': type = GAME_PIECE_TYPE::KNIGHT; break;
+            case 'B': type = GAME_PIECE_TYPE::BISHOP; break;
+            case 'R': type = GAME_PIECE_TYPE::ROOK; break;
+            case 'Q': type = GAME_PIECE_TYPE::QUEEN; break;
+            case 'K': type = GAME_PIECE_TYPE::KING; break;
+            default: index = 0; break;
+        }
+
+        // Promotions are written e8=Q or e8Q
+        if (type == GAME_PIECE_TYPE::PAWN) {
+            char promotion = san.back();
+            if (promotion == 'N' || promotion == 'B' || promotion == 'R' || promotion == 'Q') {
+                if (promotion != 'Q') {
+                    return no_move;
+                }
+                san.remove_suffix(1);
+                if (!san.empty() && san.back() == '=') {
+                    san.remove_suffix(1);
+                }
+            }
+        }
+
+        if (san.size() < index + 2) {
+            return no_move;
+        }
+        char end_file = san[san.size() - 2];
+        char end_rank = san[san.size() - 1];
+        if (end_file < 'a' || end_file > 'h' || end_rank < '1' || end_rank > '8') {
+            return no_move;
+        }
+        std::pair<int, int> end_pos = std::make_pair(end_rank - '1', end_file - 'a');
+
+        // Whatever sits between the piece and the destination narrows down where the piece comes from
+        int start_x = -1;
+        int start_y = -1;
+        for (size_t i = index; i < san.size() - 2; ++i) {
+            char c = san[i];
+            if (c >= 'a' && c <= 'h') {
+                start_y = c - 'a';
+            } else if (c >= '1' && c <= '8') {
+                start_x = c - '1';
+            } else if (c != 'x' && c != '-') {
+                return no_move;
+            }
+        }
+
+        // A pawn that doesn't capture stays on its file
+        if (type == GAME_PIECE_TYPE::PAWN && start_y == -1) {
+            start_y = end_pos.second;
+        }
+
+        // Written correctly exactly one piece can make the move - more than one means the notation is ambiguous
+        board_move found = no_move;
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            if (start_x != -1 && i != start_x) {
+                continue;
+            }
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                if (start_y != -1 && j != start_y) {
+                    continue;
+                }
+
+                game_piece * piece = game_board[i][j];
+                if (piece == nullptr || piece->type != type || piece->color != color) {
+                    continue;
+                }
+
+                // Pieces that couldn't reach the destination on an empty board are passed over before the full validation
+                int delta_x = abs(end_pos.first - i);
+                int delta_y = abs(end_pos.second - j);
+                bool diagonal = delta_x == delta_y;
+                bool straight = delta_x == 0 || delta_y == 0;
+                if ((type == GAME_PIECE_TYPE::KNIGHT && delta_x * delta_y != 2) || (type == GAME_PIECE_TYPE::BISHOP && !diagonal)
+                    || (type == GAME_PIECE_TYPE::ROOK && !straight) || (type == GAME_PIECE_TYPE::QUEEN && !diagonal && !straight)
+                    || (type == GAME_PIECE_TYPE::KING && delta_x > 1) || (type == GAME_PIECE_TYPE::PAWN && delta_x > 2)) {
+                    continue;
+                }
+
+                std::pair<int, int> start_pos = std::make_pair(i, j);
+                if (is_valid_move(start_pos, end_pos) == VALID_MOVE) {
+                    if (found.first.first != -1) {
+                        return no_move;
+                    }
+                    found = std::make_pair(start_pos, end_pos);
+                }
+            }
+        }
+        return found;
+    }
+
+    // Determines if the move captures a piece or promotes a pawn - the moves collected by CAPTURE_MOVES
+    bool Game::is_capture_or_promotion(const board_move& move) const {
+        const game_piece * mover = game_board[move.first.first][move.first.second];
+        if (game_board[move.second.first][move.second.second] != nullptr) {
+            return true;
+        }
+
+        // A pawn moving diagonally onto an empty square is capturing en passant
+        if (mover == nullptr || mover->type != GAME_PIECE_TYPE::PAWN) {
+            return false;
+        }
+        int promotion_x = mover->pawn_move_positive_x ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+        return move.first.second != move.second.second || move.second.first == promotion_x;
+    }
+
+    // Determines if any piece of the color attacks the position - the piece standing on the position doesn't matter
+    // Walks outwards from the position the same way is_in_check walks out from the king but reads the pieces directly
+    bool Game::is_square_attacked(const std::pair<int, int>& position, GAME_PIECE_COLOR by_color) const {
+        static const std::pair<int, int> directions[] = {std::make_pair(1, 0), std::make_pair(-1, 0), std::make_pair(0, 1), std::make_pair(0, -1),
+                                                         std::make_pair(1, 1), std::make_pair(-1, 1), std::make_pair(1, -1), std::make_pair(-1, -1)};
+        static const std::pair<int, int> knight_jumps[] = {std::make_pair(2, 1), std::make_pair(2, -1), std::make_pair(1, 2), std::make_pair(-1, 2),
+                                                           std::make_pair(-2, 1), std::make_pair(-2, -1), std::make_pair(1, -2), std::make_pair(-1, -2)};
+
+        for (int i = 0; i < 8; ++i) {
+            bool diagonal = directions[i].first != 0 && directions[i].second != 0;
+            for (int j = 1; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                std::pair<int, int> piece_pos = std::make_pair(position.first + (directions[i].first * j), position.second + (directions[i].second * j));
+                if (!validate_position(piece_pos)) {
+                    break;
+                }
+
+                const game_piece * piece = game_board[piece_pos.first][piece_pos.second];
+                if (piece == nullptr) {
+                    continue;
+                }
+
+                // Only the first piece in each direction can attack - and only if it moves along that direction
+                if (piece->color == by_color) {
+                    if (piece->type == GAME_PIECE_TYPE::QUEEN || (piece->type == (diagonal ? GAME_PIECE_TYPE::BISHOP : GAME_PIECE_TYPE::ROOK))) {
+                        return true;
+                    }
+                    if (j == 1 && piece->type == GAME_PIECE_TYPE::KING) {
+                        return true;
+                    }
+
+                    // Pawns attack one square diagonally in the direction they move
+                    if (j == 1 && diagonal && piece->type == GAME_PIECE_TYPE::PAWN && (directions[i].first < 0) == piece->pawn_move_positive_x) {
+                        return true;
+                    }
+                }
+                break;
+            }
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            std::pair<int, int> piece_pos = std::make_pair(position.first + knight_jumps[i].first, position.second + knight_jumps[i].second);
+            if (!validate_position(piece_pos)) {
+                continue;
+            }
+
+            const game_piece * piece = game_board[piece_pos.first][piece_pos.second];
+            if (piece != nullptr && piece->color == by_color && piece->type == GAME_PIECE_TYPE::KNIGHT) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Returns every quiet move the previous player could have just played to arrive at the current board - used for retrograde analysis
+    // Captures, castling, en passant and promotions are never returned since they cannot be taken back from the board alone
+    // The returned moves are {start_pos, end_pos} pairs as they would have been played - the piece currently sits on end_pos
+    std::vector<board_move> Game::get_retro_moves() const {
+        std::vector<board_move> retro_moves;
+        GAME_PIECE_COLOR previous_color = current_player == player1 ? player2->get_player_color() : player1->get_player_color();
+
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece * piece = game_board[i][j];
+                if (piece == nullptr || piece->color != previous_color) {
+                    continue;
+                }
+
+                std::pair<int, int> end_pos = std::make_pair(i, j);
+
+                // Pawns only ever move forward - so step backwards one row, or two rows if the pawn could have made its first double move
+                if (piece->type == GAME_PIECE_TYPE::PAWN) {
+                    int direction = piece->pawn_move_positive_x ? 1 : -1;
+                    int pawn_start_x = piece->pawn_move_positive_x ? 1 : DEFAULT_CHESS_BOARD_SIZE - 2;
+                    std::pair<int, int> single_start = std::make_pair(i - direction, j);
+
+                    // A pawn on its own starting row, or one that would have come from behind it, has no previous move
+                    if (i == pawn_start_x || !validate_position(single_start) || single_start.first == pawn_start_x - direction) {
+                        continue;
+                    }
+
+                    if (game_board[single_start.first][single_start.second] == nullptr) {
+                        retro_moves.push_back(std::make_pair(single_start, end_pos));
+
+                        std::pair<int, int> double_start = std::make_pair(i - (2 * direction), j);
+                        if (double_start.first == pawn_start_x && game_board[double_start.first][double_start.second] == nullptr) {
+                            retro_moves.push_back(std::make_pair(double_start, end_pos));
+                        }
+                    }
+                    continue;
+                }
+
+                // Every other piece moves symmetrically - the squares it could have come from are the empty squares it could move to now
+                const std::vector<std::pair<int, int>>& piece_moves = PIECE_MOVESETS.at(piece->type);
+                for (int k = 0; k < piece_moves.size(); ++k) {
+                    std::pair<int, int> move = piece_moves.at(k);
+
+                    // Castling cannot be taken back without knowing the rooks history
+                    if (piece->type == GAME_PIECE_TYPE::KING && abs(move.second) == 2) {
+                        continue;
+                    }
+
+                    int max_distance = piece->is_restricted ? 1 : DEFAULT_CHESS_BOARD_SIZE - 1;
+                    for (int l = 1; l <= max_distance; ++l) {
+                        std::pair<int, int> start_pos = std::make_pair(i + (l * move.first), j + (l * move.second));
+                        if (!validate_position(start_pos) || game_board[start_pos.first][start_pos.second] != nullptr) {
+                            break;
+                        }
+                        retro_moves.push_back(std::make_pair(start_pos, end_pos));
+                    }
+                }
+            }
+        }
+        return retro_moves;
+    }
 
+    // Determines if the player that is not currently on move is in check - such a board can never be reached through play
+    bool Game::is_opponent_in_check() {
+        swap_current_player();
+        bool opponent_in_check = is_in_check();
+        swap_current_player();
+        return opponent_in_check;
+    }
+    // Plays the move with play_move and hands the turn to the other player - intended for searching many moves quickly
+    // Only the check part of the game state is updated - CHECK or NORMAL - as the full update_game_state would generate every move
+    // Assumes the move has been validated by is_valid_move
+    Game::move_record Game::make_move(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos) {
+        move_record record;
+        record.start_pos = start_pos;
+        record.end_pos = end_pos;
+        record.moved_piece = get_location(start_pos);
+        record.en_passant_position = en_passant_position;
+        record.player1_king_position = player1_king_position;
+        record.player2_king_position = player2_king_position;
+        record.game_state = current_game_state;
+        record.halfmove_clock = halfmove_clock;
+        record.hash_key = get_hash_key();
+
+        hash_history[history_count % HASH_HISTORY_SIZE] = record.hash_key;
+        ++history_count;
+
+        // The castling rights and en passant position are taken out of the key before the move changes them
+        // Castling rights only change when a king or rook moves or a rook is captured
+        game_piece target = get_location(end_pos);
+        bool castling_may_change = record.moved_piece.type == GAME_PIECE_TYPE::KING || record.moved_piece.type == GAME_PIECE_TYPE::ROOK
+            || target.type == GAME_PIECE_TYPE::ROOK;
+        uint64_t key = record.hash_key;
+        if (castling_may_change) {
+            key ^= get_castling_hash_key();
+        }
+        if (validate_position(en_passant_position)) {
+            key ^= ZOBRIST_KEYS.en_passant[en_passant_position.second];
+        }
+
+        std::pair<game_piece, std::pair<int, int>> captured = play_move(start_pos, end_pos);
+        record.captured_piece = captured.first;
+        record.captured_pos = captured.second;
+
+        // Only the squares the move touched change - the moved piece may have been promoted on its way
+        int color_index = record.moved_piece.color == GAME_PIECE_COLOR::WHITE ? 0 : 1;
+        key ^= ZOBRIST_KEYS.pieces[color_index][record.moved_piece.type][(start_pos.first * DEFAULT_CHESS_BOARD_SIZE) + start_pos.second];
+        key ^= ZOBRIST_KEYS.pieces[color_index][game_board[end_pos.first][end_pos.second]->type][(end_pos.first * DEFAULT_CHESS_BOARD_SIZE) + end_pos.second];
+        if (validate_game_piece(record.captured_piece)) {
+            int captured_color_index = record.captured_piece.color == GAME_PIECE_COLOR::WHITE ? 0 : 1;
+            key ^= ZOBRIST_KEYS.pieces[captured_color_index][record.captured_piece.type][(record.captured_pos.first * DEFAULT_CHESS_BOARD_SIZE) + record.captured_pos.second];
+        }
+
+        int delta_y = end_pos.second - start_pos.second;
+        if (record.moved_piece.type == GAME_PIECE_TYPE::KING && abs(delta_y) == 2) {
+            int corner_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+            int rook_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 3 : 3;
+            key ^= ZOBRIST_KEYS.pieces[color_index][GAME_PIECE_TYPE::ROOK][(start_pos.first * DEFAULT_CHESS_BOARD_SIZE) + corner_y];
+            key ^= ZOBRIST_KEYS.pieces[color_index][GAME_PIECE_TYPE::ROOK][(start_pos.first * DEFAULT_CHESS_BOARD_SIZE) + rook_y];
+        }
+
+        key ^= ZOBRIST_KEYS.black_to_move;
+        if (castling_may_change) {
+            key ^= get_castling_hash_key();
+        }
+        if (validate_position(en_passant_position)) {
+            key ^= ZOBRIST_KEYS.en_passant[en_passant_position.second];
+        }
+
+        // Captures and pawn moves can never be taken back so no earlier position can come up again
+        if (record.moved_piece.type == GAME_PIECE_TYPE::PAWN || validate_game_piece(record.captured_piece)) {
+            halfmove_clock = 0;
+        } else {
+            ++halfmove_clock;
+        }
+
+        if (current_player->get_player_color() == GAME_PIECE_COLOR::BLACK) {
+            ++fullmove_number;
+        }
+        swap_current_player();
+        hash_key = key;
+        hash_key_valid = true;
+        current_game_state = is_in_check() ? GAME_STATE::CHECK : GAME_STATE::NORMAL;
+
+        return record;
+    }
+
+    // Takes back a move played through make_move - moves must be taken back in the reverse order they were made
+    void Game::unmake_move(const move_record& record) {
+        const std::pair<int, int>& start_pos = record.start_pos;
+        const std::pair<int, int>& end_pos = record.end_pos;
+
+        // Returning the moved piece - copying the old piece over it undoes promotions and the move count
+        game_piece * piece_ptr = game_board[end_pos.first][end_pos.second];
+        *piece_ptr = record.moved_piece;
+        game_board[start_pos.first][start_pos.second] = piece_ptr;
+        game_board[end_pos.first][end_pos.second] = nullptr;
+
+        // Castling also moved the rook next to the king - return it to its corner
+        int delta_y = end_pos.second - start_pos.second;
+        if (record.moved_piece.type == GAME_PIECE_TYPE::KING && abs(delta_y) == 2) {
+            int rook_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 3 : 3;
+            int corner_y = delta_y > 0 ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+            game_piece * rook_ptr = game_board[start_pos.first][rook_y];
+            --rook_ptr->moves_made;
+            game_board[start_pos.first][corner_y] = rook_ptr;
+            game_board[start_pos.first][rook_y] = nullptr;
+        }
+
+        if (validate_game_piece(record.captured_piece)) {
+            game_board[record.captured_pos.first][record.captured_pos.second] = acquire_piece(record.captured_piece);
+        }
+
+        en_passant_position = record.en_passant_position;
+        player1_king_position = record.player1_king_position;
+        player2_king_position = record.player2_king_position;
+        current_game_state = record.game_state;
+        halfmove_clock = record.halfmove_clock;
+        --history_count;
+
+        swap_current_player();
+        if (current_player->get_player_color() == GAME_PIECE_COLOR::BLACK) {
+            --fullmove_number;
+        }
+        hash_key = record.hash_key;
+        hash_key_valid = true;
+    }
+
+    // Passes the turn to the other player without moving a piece - lets the search ask whether a position is strong enough to hold even after passing
+    // The positions before the pass never count as repetitions of the positions after it - must not be played while in check
+    Game::move_record Game::make_null_move() {
+        move_record record;
+        record.start_pos = std::make_pair(-1, -1);
+        record.end_pos = std::make_pair(-1, -1);
+        record.captured_pos = std::make_pair(-1, -1);
+        record.en_passant_position = en_passant_position;
+        record.player1_king_position = player1_king_position;
+        record.player2_king_position = player2_king_position;
+        record.game_state = current_game_state;
+        record.halfmove_clock = halfmove_clock;
+        record.hash_key = get_hash_key();
+
+        hash_history[history_count % HASH_HISTORY_SIZE] = record.hash_key;
+        ++history_count;
+
+        uint64_t key = record.hash_key ^ ZOBRIST_KEYS.black_to_move;
+        if (validate_position(en_passant_position)) {
+            key ^= ZOBRIST_KEYS.en_passant[en_passant_position.second];
+        }
+
+        en_passant_position = std::make_pair(-1, -1);
+        halfmove_clock = 0;
+        if (current_player->get_player_color() == GAME_PIECE_COLOR::BLACK) {
+            ++fullmove_number;
+        }
+        swap_current_player();
+        hash_key = key;
+        hash_key_valid = true;
+
+        // The player who passed wasn't in check so the player now on move can't be either
+        current_game_state = GAME_STATE::NORMAL;
+
+        return record;
+    }
+
+    // Takes back a pass played through make_null_move
+    void Game::unmake_null_move(const move_record& record) {
+        en_passant_position = record.en_passant_position;
+        current_game_state = record.game_state;
+        halfmove_clock = record.halfmove_clock;
+        --history_count;
+
+        swap_current_player();
+        if (current_player->get_player_color() == GAME_PIECE_COLOR::BLACK) {
+            --fullmove_number;
+        }
+        hash_key = record.hash_key;
+        hash_key_valid = true;
+    }
+
+    // Determines if the current player has a piece other than pawns and their king - without one passing may be their best option
+    bool Game::has_non_pawn_material() const {
+        GAME_PIECE_COLOR color = current_player->get_player_color();
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece * piece = game_board[i][j];
+                if (piece != nullptr && piece->color == color && piece->type != GAME_PIECE_TYPE::PAWN && piece->type != GAME_PIECE_TYPE::KING) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Returns a Zobrist hash of the position - pieces, the player on move, castling rights and the en passant position
+    // Equal positions always share a key so the key can identify a position without comparing boards
+    // make_move and unmake_move keep the key up to date - any other change to the board has it worked out again on the next call
+    uint64_t Game::get_hash_key() const {
+        if (hash_key_valid) {
+            return hash_key;
+        }
+
+        uint64_t key = 0;
+
+        for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+            for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+                game_piece * piece = game_board[i][j];
+                if (piece != nullptr) {
+                    int color_index = piece->color == GAME_PIECE_COLOR::WHITE ? 0 : 1;
+                    key ^= ZOBRIST_KEYS.pieces[color_index][piece->type][(i * DEFAULT_CHESS_BOARD_SIZE) + j];
+                }
+            }
+        }
+
+        if (current_player->get_player_color() == GAME_PIECE_COLOR::BLACK) {
+            key ^= ZOBRIST_KEYS.black_to_move;
+        }
+
+        key ^= get_castling_hash_key();
+
+        if (validate_position(en_passant_position)) {
+            key ^= ZOBRIST_KEYS.en_passant[en_passant_position.second];
+        }
+
+        hash_key = key;
+        hash_key_valid = true;
+        return key;
+    }
+
+    // Determines if the king on the back row and the rook in the column have both never moved from their starting squares
+    bool Game::has_castling_right(int back_row, int rook_column) const {
+        game_piece * king = game_board[back_row][4];
+        if (king == nullptr || king->type != GAME_PIECE_TYPE::KING || king->moves_made != 0) {
+            return false;
+        }
+        game_piece * rook = game_board[back_row][rook_column];
+        return rook != nullptr && rook->type == GAME_PIECE_TYPE::ROOK && rook->color == king->color && rook->moves_made == 0;
+    }
+
+    // Returns the part of the hash key for the castling rights - the king and the rook must both still be unmoved on their starting squares
+    uint64_t Game::get_castling_hash_key() const {
+        uint64_t key = 0;
+        const int back_rows[2] = {0, DEFAULT_CHESS_BOARD_SIZE - 1};
+        const int rook_columns[2] = {0, DEFAULT_CHESS_BOARD_SIZE - 1};
+        for (int c = 0; c < 2; ++c) {
+            for (int r = 0; r < 2; ++r) {
+                if (has_castling_right(back_rows[c], rook_columns[r])) {
+                    key ^= ZOBRIST_KEYS.castling[(c * 2) + r];
+                }
+            }
+        }
+        return key;
+    }
+
+    // Determines if the current position has already come up at least times times before since the last capture or pawn move
+    // Only the remembered hash keys are compared - costs one comparison per two moves since the last capture or pawn move
+    // Positions with the same player on move are an even number of moves apart and never fewer than four so the rest are skipped
+    bool Game::is_repetition(int times) const {
+        int moves_back = halfmove_clock < history_count ? halfmove_clock : history_count;
+        if (moves_back > HASH_HISTORY_SIZE) {
+            moves_back = HASH_HISTORY_SIZE;
+        }
+        if (moves_back < 4) {
+            return false;
+        }
+
+        uint64_t key = get_hash_key();
+        int repetitions = 0;
+        for (int i = 4; i <= moves_back; i += 2) {
+            if (hash_history[(history_count - i) % HASH_HISTORY_SIZE] == key) {
+                ++repetitions;
+                if (repetitions >= times) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+}
\ No newline at end of file
@@ -2,9 +2,14 @@
 #define CPLUSPLUS_CHESS_GAME
 
 #include <tuple>            // std::pair
+#include <vector>           // std::vector
+#include <array>            // std::array
 #include <unordered_map>    // std::unordered_map for containing the key-value pair of game piece movesets
 #include <stdexcept>        // std::runtime_error
 #include <memory>           // std::shared_ptr
+#include <string>           // std::string
+#include <string_view>      // std::string_view
+#include <cstdint>          // uint64_t
 #include <iostream>         // std::cout, std::endl
 #include <io.h>             // _setmode
 #include <fcntl.h>          // _O_U16TEXT
@@ -22,7 +27,9 @@ namespace Chess_API {
             NORMAL,
             CHECK,
             STALEMATE,
-            CHECKMATE
+            CHECKMATE,
+            THREEFOLD_REPETITION,   // The same position has come up three times with the same player on move
+            FIFTY_MOVE_RULE         // Fifty moves by each player without a capture or a pawn move
         };
 
         // The constantly defined movesets for each piece based on the ruling of chess
@@ -65,18 +72,35 @@ namespace Chess_API {
             NO_PIECE
         };
 
+        // Which moves get_valid_moves collects - lets the search generate captures and quiet moves in separate stages
+        enum MOVE_TYPE {
+            ALL_MOVES,
+            CAPTURE_MOVES,      // Captures including en passant plus every promotion
+            QUIET_MOVES         // Everything else including castling
+        };
+
         // Default constructor creating an empty game
         Game(const std::shared_ptr<Player> player1_in, const std::shared_ptr<Player> player2_in);
 
         // Copy constructor
         Game(const Game& copy_source);
 
+        // Move constructor - takes over the board and pieces of the source without copying them - the source may only be destroyed or assigned to
+        Game(Game&& move_source) noexcept;
+
+        // Returns an empty game between two human stand-ins - scratch space for working through positions away from any real game
+        static Game make_scratch_board();
+
         // Destructor for removing all board allocated memory
         ~Game();
 
         // Assignment operator - copies the current games data rather then acting as a reference
+        // The board and pieces already held are reused so assigning position after position into the same game allocates nothing
         Game& operator=(const Game& other);
 
+        // Move assignment - swaps boards with the other game so its destructor frees the board this game had
+        Game& operator=(Game&& other) noexcept;
+
         // Adds the given piece type to the game board at the provided location
         // Throws an error if attempting to place the piece outside the bounds
         void add_piece(const GAME_PIECE_TYPE type_in, const GAME_PIECE_COLOR color_in, const std::pair<int, int>& location);
@@ -84,6 +108,23 @@ namespace Chess_API {
         // Sets up the game with the default chess board state
         void setup_default_board_state();
 
+        // Replaces the position with the one described by the FEN - side to move, castling rights, en passant square and move counters
+        // Pieces already on the board are reused so loading position after position into the same game allocates nothing
+        // Missing fields after the board take their starting values and anything after the move counters is ignored so EPD lines load too
+        // The game state is left NORMAL and earlier positions are forgotten - throws a runtime_error if the FEN is malformed
+        void from_fen(std::string_view fen);
+
+        // Returns the position as a FEN - castling rights come from the kings and rooks still unmoved on their starting squares
+        std::string to_fen() const;
+
+        // Replaces the position with the packed one - pieces already on the board are reused so decoding into the same game allocates nothing
+        // The game state is left NORMAL and earlier positions are forgotten - throws a runtime_error if the packed position is malformed
+        void from_packed(const packed_position& packed);
+
+        // Packs the position into 32 bytes - the score and result are left for the caller to fill in
+        // Throws a runtime_error if there are more than 32 pieces on the board
+        void to_packed(packed_position& packed) const;
+
         // Returns a game_piece copy for this location
         // Throws an error if attempting to pull a location beyond the scope of the board
         // Returns an invalid piece if there is no piece - type = NOTYPE, color = NOCOLOR
@@ -97,11 +138,12 @@ namespace Chess_API {
         // Warning - ensure the move has been validated by is_valid_move - this can have memory violations otherwise
         // Simulate_move is a flag that will do all of the normal functionality with the expectation that the move will be undone
         // Therefore it does not update cached information (en_passant_position / king position)
+        // Pawns reaching the far side of the board are promoted to a queen - except when simulating
         // Returns the game piece and location of the game piece captured - returns an invalid game piece if no piece was captured
         std::pair<game_piece, std::pair<int, int>> Game::play_move(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos, bool simulate_move = false);
 
         // Updates the internal game state based on chess ruling
-        // Essentially determines if the game is in stalemate / check / checkmate / or normal play
+        // Essentially determines if the game is in stalemate / check / checkmate / a drawn repetition / the fifty move rule / or normal play
         // Intented to be used after every call of play_move - must be manually called
         void update_game_state();
 
@@ -128,9 +170,90 @@ namespace Chess_API {
         // Swaps which player is the current player
         void swap_current_player();
 
+        // Replaces both players without touching the position - the new player with the color on move becomes the current player
+        // Throws a runtime_error if the players have the same color
+        void set_players(const std::shared_ptr<Player> player1_in, const std::shared_ptr<Player> player2_in);
+
         // Returns a read-only version of the current player
         const std::shared_ptr<Player> get_current_player() const {return current_player;}
 
+        // Returns every valid move for the current player as {start_pos, end_pos} pairs
+        std::vector<board_move> get_valid_moves();
+
+        // Writes every valid move of the type for the current player into moves_out and returns how many there were
+        // moves_out must have room for MAX_POSITION_MOVES moves - lets the search keep its move lists off the heap
+        // Moves of the other types are skipped before they are validated so each stage only pays for its own moves
+        int get_valid_moves(board_move * moves_out, MOVE_TYPE type = ALL_MOVES);
+
+        // Finds the valid move the standard algebraic notation describes for the current player - {-1, -1} positions if there is none
+        // Check and annotation marks are ignored - promotions other than to a queen have no move since pawns only ever promote to queens
+        board_move find_san_move(std::string_view san);
+
+        // Determines if the move captures a piece or promotes a pawn - the moves collected by CAPTURE_MOVES
+        bool is_capture_or_promotion(const board_move& move) const;
+
+        // Determines if any piece of the color attacks the position - the piece standing on the position doesn't matter
+        bool is_square_attacked(const std::pair<int, int>& position, GAME_PIECE_COLOR by_color) const;
+
+        // Returns every quiet move the previous player could have just played to arrive at the current board - used for retrograde analysis
+        // Captures, castling, en passant and promotions are never returned since they cannot be taken back from the board alone
+        std::vector<board_move> get_retro_moves() const;
+
+        // Determines if the player that is not currently on move is in check - such a board can never be reached through play
+        bool is_opponent_in_check();
+
+        // Determines if the current player is in check
+        bool is_in_check();
+
+        // Everything needed to take back a move played through make_move
+        struct move_record {
+            std::pair<int, int> start_pos;                  // Where the moved piece started
+            std::pair<int, int> end_pos;                    // Where the moved piece ended
+            game_piece moved_piece;                         // The moved piece before it moved - restores move counts and promotions
+            game_piece captured_piece;                      // The captured piece - an invalid piece if nothing was captured
+            std::pair<int, int> captured_pos;               // Where the captured piece stood - differs from end_pos for en passant
+            std::pair<int, int> en_passant_position;        // En passant position before the move
+            std::pair<int, int> player1_king_position;      // Player 1's king position before the move
+            std::pair<int, int> player2_king_position;      // Player 2's king position before the move
+            GAME_STATE game_state;                          // Game state before the move
+            int halfmove_clock;                             // Halfmove clock before the move
+            uint64_t hash_key;                              // Hash key before the move
+        };
+
+        // Plays the move with play_move and hands the turn to the other player - intended for searching many moves quickly
+        // Only the check part of the game state is updated - CHECK or NORMAL - as the full update_game_state would generate every move
+        // The position before the move is remembered for repetitions and the halfmove clock is advanced
+        // Assumes the move has been validated by is_valid_move
+        move_record make_move(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos);
+
+        // Takes back a move played through make_move - moves must be taken back in the reverse order they were made
+        void unmake_move(const move_record& record);
+
+        // Passes the turn to the other player without moving a piece - lets the search ask whether a position is strong enough to hold even after passing
+        // The positions before the pass never count as repetitions of the positions after it - must not be played while in check
+        move_record make_null_move();
+
+        // Takes back a pass played through make_null_move
+        void unmake_null_move(const move_record& record);
+
+        // Determines if the current player has a piece other than pawns and their king - without one passing may be their best option
+        bool has_non_pawn_material() const;
+
+        // Returns a Zobrist hash of the position - pieces, the player on move, castling rights and the en passant position
+        // Equal positions always share a key so the key can identify a position without comparing boards
+        // make_move and unmake_move keep the key up to date - any other change to the board has it worked out again on the next call
+        uint64_t get_hash_key() const;
+
+        // Returns the number of moves played since the last capture or pawn move - each players move counts as one
+        int get_halfmove_clock() const {return halfmove_clock;}
+
+        // Returns the number of the current move - starts at one and goes up after each of blacks moves
+        int get_fullmove_number() const {return fullmove_number;}
+
+        // Determines if the current position has already come up at least times times before since the last capture or pawn move
+        // Only the remembered hash keys are compared - costs one comparison per two moves since the last capture or pawn move
+        bool is_repetition(int times) const;
+
     private:
         // Prints the provided character the number of times provided - helper function for show board - assumes the CLI has been set to UTF-16 mode
         void print_wchar_times(const wchar_t wide_char, const int times) const;
@@ -141,6 +264,23 @@ namespace Chess_API {
         // Prints the board letters - helper function for show board - assumes the CLI has been set to UTF-16 mode
         void Game::print_board_letters() const;
 
+        // Keeps a captured piece for unmake_move to reuse rather than freeing it
+        void release_piece(game_piece * piece);
+
+        // Determines if the king on the back row and the rook in the column have both never moved from their starting squares
+        bool has_castling_right(int back_row, int rook_column) const;
+
+        // Replaces every piece on the board with the types and colors given - pieces are reused and the move counts stand in for castling rights
+        // Shared by from_fen and from_packed once they have checked the position - the game state is left NORMAL and earlier positions are forgotten
+        void set_position(const GAME_PIECE_TYPE (&types)[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE], const GAME_PIECE_COLOR (&colors)[DEFAULT_CHESS_BOARD_SIZE][DEFAULT_CHESS_BOARD_SIZE],
+            const std::pair<int, int> (&king_positions)[2], GAME_PIECE_COLOR side_color, const bool (&castling)[4], const std::pair<int, int>& en_passant, int halfmove, int fullmove);
+
+        // Returns the part of the hash key for the castling rights - the king and the rook must both still be unmoved on their starting squares
+        uint64_t get_castling_hash_key() const;
+
+        // Returns a piece equal to piece_in - reusing a released piece when there is one
+        game_piece * acquire_piece(const game_piece& piece_in);
+
         // validates that the position is a valid position on the board
         bool validate_position(const std::pair<int, int>& position) const;
 
@@ -162,9 +302,6 @@ namespace Chess_API {
         // Determines if the provided move would place the player in check - only checks the one move and not any moves between it
         bool simulate_move_for_check(const std::pair<int, int>& start_pos, const std::pair<int, int>& end_pos);
 
-        // Determines if the current player is in check
-        bool is_in_check();
-
         // Determines if the current player has a valid move to make
         bool current_player_has_valid_move();
 
@@ -187,6 +324,15 @@ namespace Chess_API {
         std::pair<int, int> en_passant_position = std::make_pair(-1, -1);   // Tracks the position for the next available en passant move, updates every move played, defaults to negative values when there isn't a valid en passant move
         std::pair<int, int> player1_king_position = std::make_pair(-1, -1); // Tracks the current position of player 1's king - defaults to -1, -1 if not defined
         std::pair<int, int> player2_king_position = std::make_pair(-1, -1); // Tracks the current position of player 2's king - defaults to -1, -1 if not defined
+
+        std::array<uint64_t, HASH_HISTORY_SIZE> hash_history;              // Ring of the hash keys of the positions before each move played through make_move
+        int history_count = 0;                                              // Number of moves played through make_move - the next key goes in hash_history[history_count % HASH_HISTORY_SIZE]
+        int halfmove_clock = 0;                                             // Moves played since the last capture or pawn move
+        int fullmove_number = 1;                                            // Number of the current move - goes up after each of blacks moves
+        mutable uint64_t hash_key = 0;                                      // Hash key of the position - only meaningful while hash_key_valid is set
+        mutable bool hash_key_valid = false;                                // Cleared by any change to the board that make_move doesn't account for
+
+        std::vector<game_piece *> spare_pieces;                             // Captured pieces kept for unmake_move - taking back a capture doesn't have to allocate
    
     };
     
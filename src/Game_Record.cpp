@@ -0,0 +1,197 @@
+#include "Game_Record.h"
+
+#include <algorithm>    // std::sort
+#include <cstring>      // memcmp
+
+namespace Chess_API {
+    static const char GAME_RECORD_MAGIC[4] = {'C', 'G', 'R', '1'};     // Identifies a game record file
+    static const uint8_t RECORD_HAS_FEN = 4;                            // Header bit set when a starting FEN follows
+    static const uint8_t RECORD_RESULT_MASK = 3;                        // Header bits holding the result - white half points plus one
+
+    // Appends value seven bits at a time - the high bit of each byte says another byte follows
+    static void write_varint(uint64_t value, std::vector<uint8_t>& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Reads a value written by write_varint starting at position - throws a runtime_error if the data ends first
+    static uint64_t read_varint(const uint8_t * data, size_t size, size_t& position) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position >= size) {
+                throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+            }
+            uint8_t byte = data[position++];
+            value |= uint64_t(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+    }
+
+    // Returns the sort key of a move - start square then end square
+    static int move_key(const board_move& move) {
+        return (((move.first.first * DEFAULT_CHESS_BOARD_SIZE) + move.first.second) * DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE)
+            + (move.second.first * DEFAULT_CHESS_BOARD_SIZE) + move.second.second;
+    }
+
+    // Appends the record to out in the compact binary format
+    // A header byte holds the result and whether a starting FEN follows - then a varint move count and one byte per move
+    // Each move is stored as its index among the valid moves of its position sorted by start then end square
+    // Sorting keeps the index independent of the order Game generates moves in - throws a runtime_error if a move can't be played
+    // The index is found by counting the smaller keys so encoding never sorts
+    void encode_game_record(const game_record& record, Game& board, std::vector<uint8_t>& out) {
+        uint8_t header = static_cast<uint8_t>((record.white_half_points + 1) & RECORD_RESULT_MASK);
+        if (!record.start_fen.empty()) {
+            header |= RECORD_HAS_FEN;
+        }
+        out.push_back(header);
+        if (!record.start_fen.empty()) {
+            write_varint(record.start_fen.size(), out);
+            out.insert(out.end(), record.start_fen.begin(), record.start_fen.end());
+        }
+        write_varint(record.moves.size(), out);
+
+        board.from_fen(record.start_fen.empty() ? STARTING_POSITION_FEN : record.start_fen);
+        board.update_game_state();
+        board_move moves[MAX_POSITION_MOVES];
+        for (int i = 0; i < record.moves.size(); ++i) {
+            int move_count = board.get_valid_moves(moves);
+            int key = move_key(record.moves[i]);
+            int index = 0;
+            bool found = false;
+            for (int m = 0; m < move_count; ++m) {
+                int other_key = move_key(moves[m]);
+                index += other_key < key ? 1 : 0;
+                found = found || other_key == key;
+            }
+            if (!found) {
+                throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+            }
+
+            out.push_back(static_cast<uint8_t>(index));
+            board.make_move(record.moves[i].first, record.moves[i].second);
+        }
+    }
+
+    // Reads one record in the compact binary format from the start of data into record - returns the number of bytes read
+    // Throws a runtime_error if the data is cut short or holds a move that doesn't exist - board is scratch space as for encoding
+    size_t decode_game_record(const uint8_t * data, size_t size, Game& board, game_record& record) {
+        size_t position = 0;
+        if (size == 0) {
+            throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+        }
+        uint8_t header = data[position++];
+        record.white_half_points = static_cast<int>(header & RECORD_RESULT_MASK) - 1;
+
+        record.start_fen.clear();
+        if ((header & RECORD_HAS_FEN) != 0) {
+            uint64_t fen_length = read_varint(data, size, position);
+            if (fen_length > size - position) {
+                throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+            }
+            record.start_fen.assign(reinterpret_cast<const char *>(data + position), fen_length);
+            position += fen_length;
+        }
+
+        uint64_t move_count = read_varint(data, size, position);
+        if (move_count > size - position) {
+            throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+        }
+
+        board.from_fen(record.start_fen.empty() ? STARTING_POSITION_FEN : record.start_fen);
+        board.update_game_state();
+        record.moves.resize(move_count);
+        board_move moves[MAX_POSITION_MOVES];
+        int keys[MAX_POSITION_MOVES];
+        for (size_t i = 0; i < move_count; ++i) {
+            int valid_count = board.get_valid_moves(moves);
+            int index = data[position++];
+            if (index >= valid_count) {
+                throw std::runtime_error(INVALID_GAME_RECORD_ERROR_MSG);
+            }
+
+            for (int m = 0; m < valid_count; ++m) {
+                keys[m] = move_key(moves[m]);
+            }
+            std::nth_element(keys, keys + index, keys + valid_count);
+
+            int key = keys[index];
+            int squares = DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE;
+            board_move move = std::make_pair(std::make_pair((key / squares) / DEFAULT_CHESS_BOARD_SIZE, (key / squares) % DEFAULT_CHESS_BOARD_SIZE),
+                std::make_pair((key % squares) / DEFAULT_CHESS_BOARD_SIZE, (key % squares) % DEFAULT_CHESS_BOARD_SIZE));
+            record.moves[i] = move;
+            board.make_move(move.first, move.second);
+        }
+        return position;
+    }
+
+    // Creates the file at file_path - anything already there is replaced
+    Game_Record_Writer::Game_Record_Writer(const std::string& file_path)
+        : output(file_path, std::ios::binary | std::ios::trunc), file_path(file_path), board(Game::make_scratch_board()) {
+        if (!output) {
+            throw std::runtime_error("Unable to write the game records to " + file_path);
+        }
+        output.write(GAME_RECORD_MAGIC, sizeof(GAME_RECORD_MAGIC));
+        buffer.reserve(GAME_RECORD_BUFFER_BYTES);
+    }
+
+    // Writes out whatever records are still gathered - an error here is swallowed so call flush first to find out if everything was written
+    Game_Record_Writer::~Game_Record_Writer() {
+        try {
+            flush();
+        } catch (const std::runtime_error&) {
+            // A destructor has no way to report the failure
+        }
+    }
+
+    // Adds the record to the end of the file - throws a runtime_error if a move can't be played or a full buffer cannot be written out
+    // A record that fails is taken back out of the buffer so the file never holds part of one
+    void Game_Record_Writer::write(const game_record& record) {
+        size_t record_start = buffer.size();
+        try {
+            encode_game_record(record, board, buffer);
+        } catch (...) {
+            buffer.resize(record_start);
+            throw;
+        }
+
+        ++record_count;
+        if (buffer.size() >= GAME_RECORD_BUFFER_BYTES) {
+            flush();
+        }
+    }
+
+    // Writes out every gathered record - throws a runtime_error if the file cannot be written
+    void Game_Record_Writer::flush() {
+        if (!buffer.empty()) {
+            output.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+            buffer.clear();
+        }
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("Unable to write the game records to " + file_path);
+        }
+    }
+
+    // Maps the whole file at file_path into memory
+    Game_Record_Reader::Game_Record_Reader(const std::string& file_path) : file(file_path), position(sizeof(GAME_RECORD_MAGIC)), board(Game::make_scratch_board()) {
+        if (file.size() < sizeof(GAME_RECORD_MAGIC) || memcmp(file.data(), GAME_RECORD_MAGIC, sizeof(GAME_RECORD_MAGIC)) != 0) {
+            throw std::runtime_error(file_path + " isn't a game record file");
+        }
+    }
+
+    // Reads the next record into record - returns false once every record has been read
+    // Throws a runtime_error if the record is damaged
+    bool Game_Record_Reader::next(game_record& record) {
+        if (position >= file.size()) {
+            return false;
+        }
+        position += decode_game_record(file.data() + position, file.size() - position, board, record);
+        return true;
+    }
+}
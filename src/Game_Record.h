@@ -0,0 +1,78 @@
+#ifndef CPLUSPLUS_CHESS_GAME_RECORD
+#define CPLUSPLUS_CHESS_GAME_RECORD
+
+#include <vector>
+#include <string>
+#include <fstream>      // std::ofstream
+#include <cstdint>      // uint8_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // A whole game as a starting position and the moves played from it
+    struct game_record {
+        std::string start_fen;              // Position the game started from - empty for the standard starting position
+        int white_half_points = -1;         // Half points white scored - 0, 1 or 2 - -1 if the game isn't over
+        std::vector<board_move> moves;      // Every move played in order
+    };
+
+    // Appends the record to out in the compact binary format
+    // A header byte holds the result and whether a starting FEN follows - then a varint move count and one byte per move
+    // Each move is stored as its index among the valid moves of its position sorted by start then end square
+    // Sorting keeps the index independent of the order Game generates moves in - throws a runtime_error if a move can't be played
+    // board is scratch space for playing the moves - its position is replaced
+    void encode_game_record(const game_record& record, Game& board, std::vector<uint8_t>& out);
+
+    // Reads one record in the compact binary format from the start of data into record - returns the number of bytes read
+    // Throws a runtime_error if the data is cut short or holds a move that doesn't exist - board is scratch space as for encoding
+    size_t decode_game_record(const uint8_t * data, size_t size, Game& board, game_record& record);
+
+    // Streams game records into a file - records are gathered in memory and written out in large blocks
+    // Throws a runtime_error if the file cannot be written
+    class Game_Record_Writer {
+    public:
+        // Creates the file at file_path - anything already there is replaced
+        Game_Record_Writer(const std::string& file_path);
+
+        // Writes out whatever records are still gathered - an error here is swallowed so call flush first to find out if everything was written
+        ~Game_Record_Writer();
+
+        // Adds the record to the end of the file - throws a runtime_error if a move can't be played or a full buffer cannot be written out
+        void write(const game_record& record);
+
+        // Writes out every gathered record - throws a runtime_error if the file cannot be written
+        void flush();
+
+        // Returns the number of records written
+        size_t get_record_count() const {return record_count;}
+
+    private:
+        std::ofstream output;           // File being written
+        std::string file_path;          // Named in the error when the file cannot be written
+        std::vector<uint8_t> buffer;    // Records not yet written out
+        Game board;                     // Plays the moves to number them
+        size_t record_count = 0;
+    };
+
+    // Streams game records out of a file written by Game_Record_Writer - the file is mapped so reading costs no copies
+    // Throws a runtime_error if the file cannot be opened or isn't a game record file
+    class Game_Record_Reader {
+    public:
+        // Maps the whole file at file_path into memory
+        Game_Record_Reader(const std::string& file_path);
+
+        // Reads the next record into record - returns false once every record has been read
+        // Throws a runtime_error if the record is damaged
+        bool next(game_record& record);
+
+    private:
+        Mapped_File file;       // File being read
+        size_t position;        // Start of the next record
+        Game board;             // Plays the moves to find them from their numbers
+    };
+}
+
+#endif
@@ -7,4 +7,41 @@ namespace Chess_API {
         return std::make_pair("b2", "b3");
     }
 
-}
\ No newline at end of file
+    // Starts the players turn without blocking - the future is fulfilled by submit_move so no thread waits on the human
+    // A turn still waiting from before is cancelled as only one turn can be played at a time
+    std::future<std::pair<std::string, std::string>> Human_Player::take_turn_async(std::shared_ptr<const Cancellation_Token> token) const {
+        cancel_turn();
+
+        std::lock_guard<std::mutex> lock(turn_mutex);
+        pending_move = std::make_shared<std::promise<std::pair<std::string, std::string>>>();
+        pending_token = token;
+        return pending_move->get_future();
+    }
+
+    // Finishes the turn started by take_turn_async with the humans move - returns false if no turn is waiting for a move
+    bool Human_Player::submit_move(const std::pair<std::string, std::string>& move) {
+        std::lock_guard<std::mutex> lock(turn_mutex);
+        if (pending_move == nullptr) {
+            return false;
+        }
+
+        pending_move->set_value(move);
+        pending_move.reset();
+        pending_token.reset();
+        return true;
+    }
+
+    // Ends the turn started by take_turn_async without a move
+    void Human_Player::cancel_turn() const {
+        std::lock_guard<std::mutex> lock(turn_mutex);
+        if (pending_move == nullptr) {
+            return;
+        }
+
+        bool timed_out = pending_token != nullptr && !pending_token->is_cancelled() && pending_token->is_past_deadline();
+        pending_move->set_exception(std::make_exception_ptr(std::runtime_error(timed_out ? TURN_DEADLINE_ERROR_MSG : TURN_CANCELLED_ERROR_MSG)));
+        pending_move.reset();
+        pending_token.reset();
+    }
+
+}
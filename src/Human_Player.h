@@ -4,9 +4,16 @@
 #include "Player.h"
 #include "Chess_API_vars.h"
 #include <string>
+#include <mutex>        // std::mutex
+#include <stdexcept>    // std::runtime_error
 
 namespace Chess_API {
     class Human_Player: public Player {
+    private:
+        mutable std::mutex turn_mutex;                                                      // Guards the pending turn - moves may be submitted from any thread
+        mutable std::shared_ptr<std::promise<std::pair<std::string, std::string>>> pending_move;   // Promise of the turn waiting for submit_move - nullptr without a turn
+        mutable std::shared_ptr<const Cancellation_Token> pending_token;                    // Token of the turn waiting for submit_move
+
     public:
         // Default Constructor for the computer player
         Human_Player() : Player() {}
@@ -16,7 +23,16 @@ namespace Chess_API {
 
         std::pair<std::string, std::string> take_turn() const;
 
+        // Starts the players turn without blocking - the future is fulfilled by submit_move so no thread waits on the human
+        std::future<std::pair<std::string, std::string>> take_turn_async(std::shared_ptr<const Cancellation_Token> token) const;
+
+        // Finishes the turn started by take_turn_async with the humans move - returns false if no turn is waiting for a move
+        bool submit_move(const std::pair<std::string, std::string>& move);
+
+        // Ends the turn started by take_turn_async without a move
+        void cancel_turn() const;
+
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,96 @@
+#include "Mapped_File.h"
+
+#ifdef _WIN32
+#   include <Windows.h>     // CreateFileMappingA, MapViewOfFile
+#else
+#   include <sys/mman.h>    // mmap, munmap
+#   include <sys/stat.h>    // fstat
+#   include <fcntl.h>       // open
+#   include <unistd.h>      // close
+#endif
+
+namespace Chess_API {
+    // Maps the whole file at file_path into memory
+    Mapped_File::Mapped_File(const std::string& file_path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Unable to open " + file_path);
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            throw std::runtime_error("Unable to read the size of " + file_path);
+        }
+
+        file_handle = file;
+        mapped_size = static_cast<size_t>(file_size.QuadPart);
+
+        // Windows refuses to map empty files - an empty view is still a valid mapping
+        if (mapped_size == 0) {
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            CloseHandle(file);
+            throw std::runtime_error("Unable to map " + file_path);
+        }
+
+        void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == NULL) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Unable to map " + file_path);
+        }
+
+        mapping_handle = mapping;
+        mapped_data = static_cast<const unsigned char *>(view);
+#else
+        int file = open(file_path.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("Unable to open " + file_path);
+        }
+
+        struct stat file_stats;
+        if (fstat(file, &file_stats) != 0) {
+            close(file);
+            throw std::runtime_error("Unable to read the size of " + file_path);
+        }
+
+        mapped_size = static_cast<size_t>(file_stats.st_size);
+
+        if (mapped_size != 0) {
+            void * view = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, file, 0);
+            if (view == MAP_FAILED) {
+                close(file);
+                throw std::runtime_error("Unable to map " + file_path);
+            }
+            mapped_data = static_cast<const unsigned char *>(view);
+        }
+
+        // The mapping keeps its own reference to the file
+        close(file);
+#endif
+    }
+
+    // Unmaps the file and releases every handle
+    Mapped_File::~Mapped_File() {
+#ifdef _WIN32
+        if (mapped_data != nullptr) {
+            UnmapViewOfFile(mapped_data);
+        }
+        if (mapping_handle != nullptr) {
+            CloseHandle(mapping_handle);
+        }
+        if (file_handle != nullptr) {
+            CloseHandle(file_handle);
+        }
+#else
+        if (mapped_data != nullptr) {
+            munmap(const_cast<unsigned char *>(mapped_data), mapped_size);
+        }
+#endif
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef CPLUSPLUS_CHESS_MAPPED_FILE
+#define CPLUSPLUS_CHESS_MAPPED_FILE
+
+#include <string>
+#include <cstddef>      // size_t
+#include <stdexcept>    // std::runtime_error
+
+namespace Chess_API {
+    // A read-only view of a file mapped into memory - the operating system pages the file in on demand so large files cost no up front reads
+    // Throws a runtime_error if the file cannot be opened or mapped
+    class Mapped_File {
+    public:
+        // Maps the whole file at file_path into memory
+        Mapped_File(const std::string& file_path);
+
+        // Unmaps the file and releases every handle
+        ~Mapped_File();
+
+        // Mappings own operating system handles and therefore cannot be copied
+        Mapped_File(const Mapped_File&) = delete;
+        Mapped_File& operator=(const Mapped_File&) = delete;
+
+        // Returns the first byte of the mapped file - nullptr for an empty file
+        const unsigned char * data() const {return mapped_data;}
+
+        // Returns the size of the mapped file in bytes
+        size_t size() const {return mapped_size;}
+
+    private:
+        const unsigned char * mapped_data = nullptr;    // Start of the mapped view
+        size_t mapped_size = 0;                         // Number of bytes in the mapped view
+        void * file_handle = nullptr;                   // Windows only - handle to the opened file
+        void * mapping_handle = nullptr;                // Windows only - handle to the file mapping object
+    };
+}
+
+#endif
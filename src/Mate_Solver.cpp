@@ -0,0 +1,270 @@
+#include "Mate_Solver.h"
+
+#include <stdexcept>    // std::runtime_error
+
+namespace Chess_API {
+    static const uint32_t INFINITE_PROOF = 0x3FFFFFFF;          // Proof or disproof number of a position that has been solved the other way
+    static const uint64_t NODES_BETWEEN_CHECKS = 256;           // How often the token is looked at
+    static const size_t MIN_MATE_TABLE_ENTRIES = 1024;          // Smallest table the solver will run with whatever the memory cap
+
+    // Adds proof numbers - sums of unsolved positions stop just short of infinity so they are never mistaken for a solved position
+    static uint32_t add_proof(uint32_t a, uint32_t b) {
+        if (a >= INFINITE_PROOF || b >= INFINITE_PROOF) {
+            return INFINITE_PROOF;
+        }
+        uint32_t sum = a + b;
+        return sum >= INFINITE_PROOF ? INFINITE_PROOF - 1 : sum;
+    }
+
+    // Solves the position within the limits - throws a runtime_error if max_moves is outside 1 to MAX_MATE_MOVES
+    mate_solution Mate_Solver::solve(const Game& root_game, const mate_limits& limits) {
+        if (limits.max_moves < 1 || limits.max_moves > MAX_MATE_MOVES) {
+            throw std::runtime_error(INVALID_MATE_LENGTH_ERROR_MSG);
+        }
+
+        // The table is sized down to a power of two within the memory cap
+        size_t entry_count = MIN_MATE_TABLE_ENTRIES;
+        while (entry_count * 2 * sizeof(mate_entry) <= limits.memory_bytes) {
+            entry_count *= 2;
+        }
+        table.assign(entry_count, mate_entry());
+        index_mask = entry_count - 1;
+        arena.reset();
+
+        node_limit = limits.nodes;
+        nodes = 0;
+        stopped = false;
+        token = limits.token;
+
+        mate_solution solution;
+        Game game(root_game);
+
+        // The game state the solver relies on for check is only kept up to date by update_game_state
+        game.update_game_state();
+
+        solution.result = NO_MATE;
+        for (int mate_in = 1; mate_in <= limits.max_moves; ++mate_in) {
+            int remaining = (mate_in * 2) - 1;
+            bool proven = prove(game, remaining);
+            if (stopped) {
+                solution.result = MATE_UNKNOWN;
+                break;
+            }
+
+            if (proven) {
+                solution.result = MATE_FOUND;
+                solution.mate_in = mate_in;
+
+                // The line only retraces what has been proven so the node budget no longer applies
+                node_limit = 0;
+                extract_line(game, remaining, solution.line);
+                break;
+            }
+        }
+
+        solution.nodes = nodes;
+        table.clear();
+        table.shrink_to_fit();
+        token = nullptr;
+        return solution;
+    }
+
+    // Searches the position until it is proven or disproven with remaining plies left - returns true if it was proven
+    bool Mate_Solver::prove(Game& game, int remaining) {
+        uint32_t proof;
+        uint32_t disproof;
+        search(game, remaining, INFINITE_PROOF, INFINITE_PROOF, proof, disproof);
+        return proof == 0;
+    }
+
+    // Searches the position until its numbers reach either threshold - the attacker is on move when remaining is odd
+    // The final numbers are written to proof and disproof and stored in the table
+    void Mate_Solver::search(Game& game, int remaining, uint32_t proof_threshold, uint32_t disproof_threshold, uint32_t& proof, uint32_t& disproof) {
+        uint64_t key = game.get_hash_key();
+        look_up(key, remaining, proof, disproof);
+        if (proof == 0 || disproof == 0 || check_limits()) {
+            return;
+        }
+
+        // The move list and the children's numbers live in the arena until this position returns
+        Arena_Scope scope(arena);
+        bool attacker_to_move = remaining % 2 == 1;
+        board_move * moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+        int move_count = generate_moves(game, remaining, moves);
+
+        // A position without moves is mate for the attacker only if the defender is the one stuck in check
+        // The defender still having a move once no plies remain means there is no mate in time
+        if (move_count == 0 || remaining == 0) {
+            bool proven = move_count == 0 && !attacker_to_move && game.get_current_game_state() == Game::CHECK;
+            proof = proven ? 0 : INFINITE_PROOF;
+            disproof = proven ? INFINITE_PROOF : 0;
+            store(key, remaining, proof, disproof);
+            return;
+        }
+
+        // Children keep the numbers their own search handed back - the table slot may have been taken by another position since
+        uint32_t * child_proofs = arena.allocate_array<uint32_t>(move_count);
+        uint32_t * child_disproofs = arena.allocate_array<uint32_t>(move_count);
+        for (int i = 0; i < move_count; ++i) {
+            Game::move_record record = game.make_move(moves[i].first, moves[i].second);
+            look_up(game.get_hash_key(), remaining - 1, child_proofs[i], child_disproofs[i]);
+            game.unmake_move(record);
+        }
+
+        // The attacker needs one child proven - the defender needs every child proven
+        // From the side on move a child is "proving" if it helps that side - the proof number for the attacker and the disproof number for the defender
+        while (true) {
+            uint32_t best_proving = INFINITE_PROOF;
+            uint32_t second_proving = INFINITE_PROOF;
+            uint32_t refuting_sum = 0;
+            uint32_t best_refuting = 0;
+            int best_child = 0;
+
+            for (int i = 0; i < move_count; ++i) {
+                uint32_t proving = attacker_to_move ? child_proofs[i] : child_disproofs[i];
+                uint32_t refuting = attacker_to_move ? child_disproofs[i] : child_proofs[i];
+                refuting_sum = add_proof(refuting_sum, refuting);
+                if (proving < best_proving) {
+                    second_proving = best_proving;
+                    best_proving = proving;
+                    best_refuting = refuting;
+                    best_child = i;
+                } else if (proving < second_proving) {
+                    second_proving = proving;
+                }
+            }
+
+            proof = attacker_to_move ? best_proving : refuting_sum;
+            disproof = attacker_to_move ? refuting_sum : best_proving;
+
+            uint32_t proving_threshold = attacker_to_move ? proof_threshold : disproof_threshold;
+            uint32_t refuting_threshold = attacker_to_move ? disproof_threshold : proof_threshold;
+            if (best_proving >= proving_threshold || refuting_sum >= refuting_threshold || stopped) {
+                break;
+            }
+
+            // The best child is searched until it is no longer the best or the side on move has enough refutations
+            uint32_t child_proving_threshold = second_proving + 1 < proving_threshold ? second_proving + 1 : proving_threshold;
+            uint32_t child_refuting_threshold = refuting_threshold >= INFINITE_PROOF ? INFINITE_PROOF : refuting_threshold - refuting_sum + best_refuting;
+
+            Game::move_record record = game.make_move(moves[best_child].first, moves[best_child].second);
+            search(game, remaining - 1,
+                attacker_to_move ? child_proving_threshold : child_refuting_threshold,
+                attacker_to_move ? child_refuting_threshold : child_proving_threshold,
+                child_proofs[best_child], child_disproofs[best_child]);
+            game.unmake_move(record);
+        }
+
+        store(key, remaining, proof, disproof);
+    }
+
+    // Writes every move worth searching into moves_out and returns how many there were - only checks on the attacker's last move
+    int Mate_Solver::generate_moves(Game& game, int remaining, board_move * moves_out) {
+        int move_count = game.get_valid_moves(moves_out);
+        if (remaining != 1) {
+            return move_count;
+        }
+
+        int checking_count = 0;
+        for (int i = 0; i < move_count; ++i) {
+            Game::move_record record = game.make_move(moves_out[i].first, moves_out[i].second);
+            bool gives_check = game.get_current_game_state() == Game::CHECK;
+            game.unmake_move(record);
+            if (gives_check) {
+                moves_out[checking_count++] = moves_out[i];
+            }
+        }
+        return checking_count;
+    }
+
+    // Reads the numbers of the position from the table - a proof with fewer plies or a disproof with more plies still holds
+    void Mate_Solver::look_up(uint64_t key, int remaining, uint32_t& proof, uint32_t& disproof) const {
+        const mate_entry& entry = table[key & index_mask];
+        proof = 1;
+        disproof = 1;
+        if (entry.key != key || entry.remaining < 0) {
+            return;
+        }
+
+        if ((entry.proof == 0 && entry.remaining <= remaining) || (entry.disproof == 0 && entry.remaining >= remaining) || entry.remaining == remaining) {
+            proof = entry.proof;
+            disproof = entry.disproof;
+        }
+    }
+
+    // Stores the numbers of the position in the table
+    void Mate_Solver::store(uint64_t key, int remaining, uint32_t proof, uint32_t disproof) {
+        mate_entry& entry = table[key & index_mask];
+        entry.key = key;
+        entry.proof = proof;
+        entry.disproof = disproof;
+        entry.remaining = remaining;
+    }
+
+    // Follows the proof choosing the quickest mate for the attacker and the longest defence for the defender
+    void Mate_Solver::extract_line(Game& game, int remaining, std::vector<board_move>& line) {
+        Arena_Scope scope(arena);
+        board_move * moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+        int move_count = generate_moves(game, remaining, moves);
+        if (move_count == 0 || remaining == 0 || stopped) {
+            return;
+        }
+
+        bool attacker_to_move = remaining % 2 == 1;
+        int best_child = -1;
+        int best_plies = 0;
+
+        if (attacker_to_move) {
+            // The first move mating within the fewest plies
+            for (int plies = 0; plies < remaining && best_child == -1; plies += 2) {
+                for (int i = 0; i < move_count && best_child == -1; ++i) {
+                    Game::move_record record = game.make_move(moves[i].first, moves[i].second);
+                    if (prove(game, plies)) {
+                        best_child = i;
+                        best_plies = plies;
+                    }
+                    game.unmake_move(record);
+                }
+            }
+        } else {
+            // The reply that holds out the longest - each reply is proven at its shortest length
+            for (int i = 0; i < move_count; ++i) {
+                Game::move_record record = game.make_move(moves[i].first, moves[i].second);
+                int plies = 1;
+                while (plies < remaining - 1 && !prove(game, plies)) {
+                    plies += 2;
+                }
+                game.unmake_move(record);
+
+                if (best_child == -1 || plies > best_plies) {
+                    best_child = i;
+                    best_plies = plies;
+                }
+            }
+        }
+
+        if (best_child == -1 || stopped) {
+            return;
+        }
+
+        line.push_back(moves[best_child]);
+        Game::move_record record = game.make_move(moves[best_child].first, moves[best_child].second);
+        extract_line(game, best_plies, line);
+        game.unmake_move(record);
+    }
+
+    // Counts the node and checks the limits every so often - returns true once the solve has to stop
+    bool Mate_Solver::check_limits() {
+        ++nodes;
+        if (stopped) {
+            return true;
+        }
+
+        if (node_limit != 0 && nodes >= node_limit) {
+            stopped = true;
+        } else if (token != nullptr && nodes % NODES_BETWEEN_CHECKS == 0 && token->should_stop()) {
+            stopped = true;
+        }
+        return stopped;
+    }
+}
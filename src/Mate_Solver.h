@@ -0,0 +1,90 @@
+#ifndef CPLUSPLUS_CHESS_MATE_SOLVER
+#define CPLUSPLUS_CHESS_MATE_SOLVER
+
+#include <vector>
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Cancellation_Token.h"
+#include "Search_Arena.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    const size_t DEFAULT_MATE_SOLVER_BYTES = size_t(16) << 20;     // Memory the solver's table may use unless told otherwise
+    const int MAX_MATE_MOVES = 32;                                  // Longest mate the solver will look for - in moves of the attacking player
+
+    // What the solver was able to show about the position
+    enum MATE_RESULT {
+        MATE_FOUND,     // The player on move forces mate within the asked number of moves
+        NO_MATE,        // The player on move cannot force mate within the asked number of moves
+        MATE_UNKNOWN    // The node budget or the token stopped the solver before it could decide
+    };
+
+    // Limits placed on a single solve - a value of 0 means that limit isn't used
+    struct mate_limits {
+        int max_moves = 1;                                  // Longest mate looked for in moves of the attacking player - from 1 to MAX_MATE_MOVES
+        uint64_t nodes = 0;                                 // Positions the solver may visit
+        size_t memory_bytes = DEFAULT_MATE_SOLVER_BYTES;    // Memory the solver's table may use - rounded down to a power of two entries
+        const Cancellation_Token * token = nullptr;         // Stops the solver once cancelled or past its deadline - must outlive the solve
+    };
+
+    // The outcome of a solve
+    struct mate_solution {
+        MATE_RESULT result = MATE_UNKNOWN;
+        int mate_in = 0;                        // Moves of the attacking player until mate - 0 unless result is MATE_FOUND
+        std::vector<board_move> line;           // The mating line against the longest defence - empty unless result is MATE_FOUND
+        uint64_t nodes = 0;                     // Positions visited over every mate length tried
+    };
+
+    // Answers "does the player on move force mate in N?" with depth-first proof-number search (df-pn) over Game
+    // Unlike the alpha-beta Searcher it never evaluates a position - it only searches where a proof or disproof is closest
+    // Each mate length from 1 to max_moves is tried in turn so the shortest mate is the one found
+    // The fifty move rule and repetitions are not considered - a mate within max_moves is reported even if the clock would run out first
+    class Mate_Solver {
+    public:
+        // Solves the position within the limits - throws a runtime_error if max_moves is outside 1 to MAX_MATE_MOVES
+        mate_solution solve(const Game& root_game, const mate_limits& limits);
+
+    private:
+        // Proof and disproof numbers remembered for a position searched with a number of plies remaining
+        struct mate_entry {
+            uint64_t key = 0;           // Full hash key of the position
+            uint32_t proof = 1;         // Positions that still have to be searched to prove the mate
+            uint32_t disproof = 1;      // Positions that still have to be searched to refute the mate
+            int16_t remaining = -1;     // Plies that were left to deliver mate - -1 for an empty entry
+        };
+
+        // Searches the position until its numbers reach either threshold - the attacker is on move when remaining is odd
+        // The final numbers are written to proof and disproof and stored in the table
+        void search(Game& game, int remaining, uint32_t proof_threshold, uint32_t disproof_threshold, uint32_t& proof, uint32_t& disproof);
+
+        // Searches the position until it is proven or disproven with remaining plies left - returns true if it was proven
+        bool prove(Game& game, int remaining);
+
+        // Writes every move worth searching into moves_out and returns how many there were - only checks on the attacker's last move
+        int generate_moves(Game& game, int remaining, board_move * moves_out);
+
+        // Reads the numbers of the position from the table - a proof with fewer plies or a disproof with more plies still holds
+        void look_up(uint64_t key, int remaining, uint32_t& proof, uint32_t& disproof) const;
+
+        // Stores the numbers of the position in the table
+        void store(uint64_t key, int remaining, uint32_t proof, uint32_t disproof);
+
+        // Follows the proof choosing the quickest mate for the attacker and the longest defence for the defender
+        void extract_line(Game& game, int remaining, std::vector<board_move>& line);
+
+        // Counts the node and checks the limits every so often - returns true once the solve has to stop
+        bool check_limits();
+
+        std::vector<mate_entry> table;                  // Results shared between every mate length of a solve
+        size_t index_mask = 0;                          // Mask turning a key into a slot - table.size() - 1
+        uint64_t node_limit = 0;                        // Positions allowed over the whole solve
+        uint64_t nodes = 0;                             // Positions visited so far
+        bool stopped = false;                           // Set once the solve has hit a limit
+        const Cancellation_Token * token = nullptr;     // Token of whoever asked for the solve
+        Search_Arena arena;                             // Move lists and child numbers of every position on the current path
+    };
+}
+
+#endif
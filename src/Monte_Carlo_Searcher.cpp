@@ -0,0 +1,277 @@
+#include "Monte_Carlo_Searcher.h"
+#include "Evaluation.h"
+#include "Thread_Pool.h"
+
+#include <cmath>        // sqrt, log
+
+namespace Chess_API {
+    static const double EXPLORATION_CONSTANT = 1.2;         // Weight of the exploration term in the upper confidence bound
+    static const int DECISIVE_EVALUATION = 300;             // Centipawns ahead at the end of a playout that count as a win
+    static const uint32_t WIN_POINTS = 2;                   // Half points for a win
+    static const uint32_t DRAW_POINTS = 1;                  // Half points for a draw
+
+    // Expansion state of a node
+    enum NODE_STATE : uint8_t {
+        NODE_LEAF,          // No children yet
+        NODE_EXPANDING,     // A thread is adding the children
+        NODE_EXPANDED       // Children are ready - a node without children is the end of the game
+    };
+
+    // Searches the position within the limits - at least one playout is always run
+    monte_carlo_result Monte_Carlo_Searcher::search(const Game& root_game, const monte_carlo_limits& limits) {
+        monte_carlo_result result;
+        int64_t start_ms = steady_time_ms();
+
+        Game game(root_game);
+
+        // The game state the playouts rely on for check is only kept up to date by update_game_state
+        game.update_game_state();
+
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+
+        // The tree is kept between searches of the same size so it is only allocated once
+        size_t capacity = limits.memory_bytes / sizeof(mcts_node);
+        if (capacity < 1 + MAX_POSITION_MOVES) {
+            capacity = 1 + MAX_POSITION_MOVES;
+        }
+        if (capacity != tree_capacity) {
+            tree.reset(new mcts_node[capacity]);
+            tree_capacity = capacity;
+        }
+
+        reset_node(0, std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1)));
+        tree_size = 1;
+        playouts = 0;
+        stopped = false;
+        playout_limit = limits.playouts;
+        deadline_ms = limits.move_time_ms > 0 ? start_ms + limits.move_time_ms : 0;
+        playout_plies = limits.playout_plies > 0 ? limits.playout_plies : DEFAULT_PLAYOUT_PLIES;
+        light_policy = limits.light_policy;
+        token = limits.token;
+
+        // Nothing to search without a move to play
+        expand(game, 0);
+        if (tree[0].child_count == 0) {
+            token = nullptr;
+            return result;
+        }
+
+        std::random_device device;
+        uint64_t seed = limits.seed != 0 ? limits.seed : (uint64_t(device()) << 32) | device();
+
+        // Each share runs playouts with its own copy of the game on the shared pool - the calling thread runs shares alongside the workers
+        Thread_Pool::get_default()->run_shares(thread_count, [this, &game, seed](unsigned int share) {
+            run_thread(game, seed + share);
+        });
+
+        // The most visited move is the one the search trusts the most
+        uint32_t first_child = tree[0].first_child;
+        uint32_t best_child = first_child;
+        for (uint32_t i = first_child; i < first_child + tree[0].child_count; ++i) {
+            if (tree[i].visits > tree[best_child].visits) {
+                best_child = i;
+            }
+        }
+
+        result.best_move = tree[best_child].move;
+        result.win_rate = tree[best_child].visits == 0 ? 0.0 : double(tree[best_child].score) / (WIN_POINTS * double(tree[best_child].visits));
+        result.playouts = playouts;
+        result.tree_nodes = tree_size < tree_capacity ? tree_size.load() : tree_capacity;
+        result.threads = thread_count;
+        result.elapsed_ms = steady_time_ms() - start_ms;
+
+        double seconds = result.elapsed_ms > 0 ? result.elapsed_ms / 1000.0 : 0.001;
+        result.playouts_per_second = result.playouts / seconds;
+        result.playouts_per_second_per_thread = result.playouts_per_second / thread_count;
+
+        token = nullptr;
+        return result;
+    }
+
+    // Runs playouts on one thread until a limit is reached
+    void Monte_Carlo_Searcher::run_thread(Game game, uint64_t seed) {
+        std::mt19937_64 random(seed);
+        std::vector<Game::move_record> records;
+        std::vector<uint32_t> path;
+        records.reserve(playout_plies + MAX_POSITION_MOVES);
+        path.reserve(MAX_POSITION_MOVES);
+
+        do {
+            // Selection - the virtual loss steers the other threads away from this line until the playout is backed up
+            uint32_t node_index = 0;
+            path.assign(1, 0);
+            while (tree[node_index].state.load(std::memory_order_acquire) == NODE_EXPANDED && tree[node_index].child_count > 0) {
+                node_index = select_child(node_index);
+                tree[node_index].virtual_loss.fetch_add(1, std::memory_order_relaxed);
+                records.push_back(game.make_move(tree[node_index].move.first, tree[node_index].move.second));
+                path.push_back(node_index);
+            }
+
+            // Expansion - a leaf grows its children the second time it is reached
+            if (tree[node_index].visits > 0 && expand(game, node_index) && tree[node_index].child_count > 0) {
+                node_index = select_child(node_index);
+                tree[node_index].virtual_loss.fetch_add(1, std::memory_order_relaxed);
+                records.push_back(game.make_move(tree[node_index].move.first, tree[node_index].move.second));
+                path.push_back(node_index);
+            }
+
+            // Simulation and backpropagation - each node scores from the view of the player who moved into it
+            uint32_t points = playout(game, random, records);
+            for (int i = path.size() - 1; i >= 0; --i) {
+                mcts_node& node = tree[path[i]];
+                node.visits.fetch_add(1, std::memory_order_relaxed);
+                node.score.fetch_add(points, std::memory_order_relaxed);
+                if (i > 0) {
+                    node.virtual_loss.fetch_sub(1, std::memory_order_relaxed);
+                    game.unmake_move(records.back());
+                    records.pop_back();
+                }
+                points = WIN_POINTS - points;
+            }
+
+            playouts.fetch_add(1, std::memory_order_relaxed);
+        } while (!should_stop());
+    }
+
+    // Picks the child with the best upper confidence bound
+    // Visits in progress on other threads count as losses so threads spread over different children
+    uint32_t Monte_Carlo_Searcher::select_child(uint32_t node_index) const {
+        const mcts_node& node = tree[node_index];
+        uint32_t first_child = node.first_child;
+        uint32_t child_count = node.child_count;
+        double parent_visits = double(node.visits) + node.virtual_loss + 1.0;
+        double log_parent = log(parent_visits);
+
+        uint32_t best_child = first_child;
+        double best_bound = -1.0;
+        for (uint32_t i = first_child; i < first_child + child_count; ++i) {
+            double visits = double(tree[i].visits.load(std::memory_order_relaxed)) + tree[i].virtual_loss.load(std::memory_order_relaxed);
+            if (visits == 0.0) {
+                return i;
+            }
+
+            double mean = double(tree[i].score.load(std::memory_order_relaxed)) / (WIN_POINTS * visits);
+            double bound = mean + (EXPLORATION_CONSTANT * sqrt(log_parent / visits));
+            if (bound > best_bound) {
+                best_bound = bound;
+                best_child = i;
+            }
+        }
+        return best_child;
+    }
+
+    // Adds the children of the node - returns false if another thread is expanding it or the tree is full
+    bool Monte_Carlo_Searcher::expand(Game& game, uint32_t node_index) {
+        mcts_node& node = tree[node_index];
+        uint8_t expected = NODE_LEAF;
+        if (!node.state.compare_exchange_strong(expected, NODE_EXPANDING, std::memory_order_acq_rel)) {
+            return false;
+        }
+
+        board_move moves[MAX_POSITION_MOVES];
+        int move_count = game.get_valid_moves(moves);
+
+        // Claiming room for the children - a full tree leaves the node as a leaf for the playouts to keep scoring
+        uint32_t first_child = 0;
+        if (move_count > 0) {
+            if (tree_size.load(std::memory_order_relaxed) + move_count > tree_capacity) {
+                node.state.store(NODE_LEAF, std::memory_order_release);
+                return false;
+            }
+
+            first_child = tree_size.fetch_add(move_count, std::memory_order_relaxed);
+            if (first_child + move_count > tree_capacity) {
+                node.state.store(NODE_LEAF, std::memory_order_release);
+                return false;
+            }
+
+            for (int i = 0; i < move_count; ++i) {
+                reset_node(first_child + i, moves[i]);
+            }
+        }
+
+        node.first_child.store(first_child, std::memory_order_relaxed);
+        node.child_count.store(move_count, std::memory_order_relaxed);
+        node.state.store(NODE_EXPANDED, std::memory_order_release);
+        return true;
+    }
+
+    // Plays random moves from the position until the game ends or the ply limit is reached - records holds the moves to take back
+    // Returns the half points scored by the player who is not on move at the start of the playout
+    uint32_t Monte_Carlo_Searcher::playout(Game& game, std::mt19937_64& random, std::vector<Game::move_record>& records) {
+        size_t start = records.size();
+        board_move moves[MAX_POSITION_MOVES];
+        uint32_t points = DRAW_POINTS;
+        int ply = 0;
+
+        for (; ply < playout_plies; ++ply) {
+            if (game.get_halfmove_clock() >= FIFTY_MOVE_RULE_HALFMOVES || game.is_repetition(2)) {
+                break;
+            }
+
+            int move_count = game.get_valid_moves(moves);
+            if (move_count == 0) {
+                // Checkmate scores for whoever delivered it - the player who moved last
+                if (game.get_current_game_state() == Game::CHECK) {
+                    points = ply % 2 == 0 ? WIN_POINTS : 0;
+                }
+                break;
+            }
+
+            int chosen = random() % move_count;
+
+            // The light policy takes the most valuable piece on offer half of the time
+            if (light_policy && (random() & 1) == 0) {
+                int best_value = 0;
+                for (int i = 0; i < move_count; ++i) {
+                    game_piece target = game.get_location(moves[i].second);
+                    if (game.validate_game_piece(target) && PIECE_VALUES[target.type] > best_value) {
+                        best_value = PIECE_VALUES[target.type];
+                        chosen = i;
+                    }
+                }
+            }
+
+            records.push_back(game.make_move(moves[chosen].first, moves[chosen].second));
+        }
+
+        // A playout cut off by the ply limit is decided by the evaluation
+        if (ply == playout_plies) {
+            int evaluation = evaluate(game);
+            uint32_t mover_points = evaluation >= DECISIVE_EVALUATION ? WIN_POINTS : (evaluation <= -DECISIVE_EVALUATION ? 0 : DRAW_POINTS);
+            points = ply % 2 == 0 ? WIN_POINTS - mover_points : mover_points;
+        }
+
+        while (records.size() > start) {
+            game.unmake_move(records.back());
+            records.pop_back();
+        }
+        return points;
+    }
+
+    // Readies a node handed out from the tree for use
+    void Monte_Carlo_Searcher::reset_node(uint32_t node_index, const board_move& move) {
+        mcts_node& node = tree[node_index];
+        node.move = move;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.score.store(0, std::memory_order_relaxed);
+        node.virtual_loss.store(0, std::memory_order_relaxed);
+        node.first_child.store(0, std::memory_order_relaxed);
+        node.child_count.store(0, std::memory_order_relaxed);
+        node.state.store(NODE_LEAF, std::memory_order_relaxed);
+    }
+
+    // Determines if the limits call for the search to stop - once one thread stops every thread stops
+    bool Monte_Carlo_Searcher::should_stop() {
+        if (stopped.load(std::memory_order_relaxed)) {
+            return true;
+        }
+
+        if ((playout_limit != 0 && playouts.load(std::memory_order_relaxed) >= playout_limit)
+            || (deadline_ms != 0 && steady_time_ms() >= deadline_ms)
+            || (token != nullptr && token->should_stop())) {
+            stopped = true;
+        }
+        return stopped;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef CPLUSPLUS_CHESS_MONTE_CARLO_SEARCHER
+#define CPLUSPLUS_CHESS_MONTE_CARLO_SEARCHER
+
+#include <vector>
+#include <memory>       // std::unique_ptr
+#include <atomic>       // std::atomic
+#include <random>       // std::mt19937_64
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Cancellation_Token.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    const size_t DEFAULT_MONTE_CARLO_BYTES = size_t(32) << 20;     // Memory the tree may use unless told otherwise
+    const int DEFAULT_PLAYOUT_PLIES = 160;                          // Plies a playout runs before the evaluation decides it
+
+    // Limits placed on a single Monte Carlo search - a value of 0 means that limit isn't used
+    struct monte_carlo_limits {
+        uint64_t playouts = 0;                                  // Playouts run over every thread
+        int move_time_ms = 0;                                   // Milliseconds allowed for the search
+        unsigned int threads = 1;                               // Threads running playouts - 0 uses every hardware thread
+        size_t memory_bytes = DEFAULT_MONTE_CARLO_BYTES;        // Memory the tree may use - the tree stops growing once it is full
+        int playout_plies = DEFAULT_PLAYOUT_PLIES;              // Plies a playout runs before the evaluation decides it
+        bool light_policy = true;                               // Playouts favour capturing the most valuable piece over a uniformly random move
+        uint64_t seed = 0;                                      // Seeds the playouts - 0 seeds from std::random_device
+        const Cancellation_Token * token = nullptr;             // Stops the search once cancelled or past its deadline - must outlive the search
+    };
+
+    // The outcome of a Monte Carlo search
+    struct monte_carlo_result {
+        board_move best_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));     // Most visited move - {-1, -1} positions if there was no move
+        double win_rate = 0.0;              // Share of points the best move scored - a draw counts as half a point
+        uint64_t playouts = 0;              // Playouts run over every thread
+        uint64_t tree_nodes = 0;            // Nodes added to the tree
+        unsigned int threads = 0;           // Threads that ran playouts
+        int64_t elapsed_ms = 0;             // Wall clock time of the search
+        double playouts_per_second = 0.0;   // Throughput of the whole search
+        double playouts_per_second_per_thread = 0.0;    // Throughput of each thread - the benchmark figure
+    };
+
+    // Monte Carlo tree search over Game - UCT selection over a tree shared by every thread
+    // The tree is lock-free - a node is claimed for expansion with a compare and swap and threads passing through a node
+    // add a virtual loss so they spread over different lines instead of all following the same one
+    // Playouts use Game's move generation and end on checkmate, stalemate, the fifty move rule, repetition or the ply limit
+    class Monte_Carlo_Searcher {
+    public:
+        // Searches the position within the limits - at least one playout is always run
+        monte_carlo_result search(const Game& root_game, const monte_carlo_limits& limits);
+
+    private:
+        // A position in the tree - reached from its parent by move
+        struct mcts_node {
+            board_move move;                        // Move from the parent that reaches this position
+            std::atomic<uint32_t> visits;           // Playouts that passed through the node
+            std::atomic<uint32_t> score;            // Half points scored by the player who played move - a win is 2 and a draw is 1
+            std::atomic<uint32_t> virtual_loss;     // Threads currently below the node - each counts as a lost visit
+            std::atomic<uint32_t> first_child;      // Index of the first child
+            std::atomic<uint16_t> child_count;      // Number of children
+            std::atomic<uint8_t> state;             // NODE_LEAF, NODE_EXPANDING or NODE_EXPANDED
+        };
+
+        // Runs playouts on one thread until a limit is reached
+        void run_thread(Game game, uint64_t seed);
+
+        // Picks the child with the best upper confidence bound
+        uint32_t select_child(uint32_t node_index) const;
+
+        // Adds the children of the node - returns false if another thread is expanding it or the tree is full
+        bool expand(Game& game, uint32_t node_index);
+
+        // Plays random moves from the position until the game ends or the ply limit is reached - records holds the moves to take back
+        // Returns the half points scored by the player who is not on move at the start of the playout
+        uint32_t playout(Game& game, std::mt19937_64& random, std::vector<Game::move_record>& records);
+
+        // Readies a node handed out from the tree for use
+        void reset_node(uint32_t node_index, const board_move& move);
+
+        // Determines if the limits call for the search to stop - once one thread stops every thread stops
+        bool should_stop();
+
+        std::unique_ptr<mcts_node[]> tree;              // Every node of the tree - node 0 is the root
+        size_t tree_capacity = 0;                       // Nodes the memory allows
+        std::atomic<uint32_t> tree_size;                // Nodes handed out so far
+        std::atomic<uint64_t> playouts;                 // Playouts finished over every thread
+        std::atomic<bool> stopped;                      // Set once any thread sees a limit reached
+        uint64_t playout_limit = 0;                     // Playouts allowed
+        int64_t deadline_ms = 0;                        // Steady clock time the search must finish by - 0 for no deadline
+        int playout_plies = DEFAULT_PLAYOUT_PLIES;      // Plies each playout may run
+        bool light_policy = true;                       // Whether playouts favour captures
+        const Cancellation_Token * token = nullptr;     // Token of whoever asked for the search
+    };
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include "Move_Picker.h"
+#include "Evaluation.h"
+
+namespace Chess_API {
+    // killers_in holds KILLER_MOVES_PER_PLY moves or is nullptr - quiets_in false only hands out the hash move and captures
+    Move_Picker::Move_Picker(Game& game_in, Search_Arena& arena_in, const board_move& hash_move_in, const board_move * killers_in, bool quiets_in)
+        : game(game_in), arena(arena_in), hash_move(hash_move_in), quiets(quiets_in) {
+        board_move no_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        for (int i = 0; i < KILLER_MOVES_PER_PLY; ++i) {
+            killers[i] = killers_in != nullptr ? killers_in[i] : no_move;
+        }
+
+        // Only captures are wanted without quiets so a quiet hash move is dropped
+        if (hash_move.first.first != -1 && !quiets && !game.is_capture_or_promotion(hash_move)) {
+            hash_move = no_move;
+        }
+    }
+
+    // Writes the next move into move - returns false once every move has been handed out
+    bool Move_Picker::next(board_move& move) {
+        switch (stage) {
+            case STAGE_HASH_MOVE:
+                stage = STAGE_GENERATE_CAPTURES;
+
+                // The table may hand back a move from a different position sharing the slot
+                if (hash_move.first.first != -1 && game.is_valid_move(hash_move.first, hash_move.second) == Game::VALID_MOVE) {
+                    move = hash_move;
+                    return true;
+                }
+                hash_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+                // Fall through
+
+            case STAGE_GENERATE_CAPTURES:
+                generate_captures();
+                stage = STAGE_WINNING_CAPTURES;
+                index = 0;
+                // Fall through
+
+            case STAGE_WINNING_CAPTURES:
+                while (index < winning_count) {
+                    move = pick_best(winning, winning_scores, index, winning_count);
+                    ++index;
+                    if (move != hash_move) {
+                        return true;
+                    }
+                }
+                stage = quiets ? STAGE_KILLERS : STAGE_LOSING_CAPTURES;
+                index = 0;
+                return next(move);
+
+            case STAGE_KILLERS:
+                while (index < KILLER_MOVES_PER_PLY) {
+                    move = killers[index];
+                    ++index;
+                    if (move.first.first != -1 && move != hash_move && !game.is_capture_or_promotion(move)
+                        && game.is_valid_move(move.first, move.second) == Game::VALID_MOVE) {
+                        return true;
+                    }
+                }
+                stage = STAGE_GENERATE_QUIETS;
+                // Fall through
+
+            case STAGE_GENERATE_QUIETS:
+                quiet_moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+                quiet_count = game.get_valid_moves(quiet_moves, Game::QUIET_MOVES);
+                stage = STAGE_QUIETS;
+                index = 0;
+                // Fall through
+
+            case STAGE_QUIETS:
+                while (index < quiet_count) {
+                    move = quiet_moves[index];
+                    ++index;
+                    if (!is_special(move)) {
+                        return true;
+                    }
+                }
+                stage = STAGE_LOSING_CAPTURES;
+                index = 0;
+                // Fall through
+
+            case STAGE_LOSING_CAPTURES:
+                while (index < losing_count) {
+                    move = pick_best(losing, losing_scores, index, losing_count);
+                    ++index;
+                    if (move != hash_move) {
+                        return true;
+                    }
+                }
+                stage = STAGE_DONE;
+                // Fall through
+
+            case STAGE_DONE:
+            default:
+                return false;
+        }
+    }
+
+    // Generates the captures and splits them into winning and losing captures
+    // A capture is losing when the capturing piece is worth more than what it takes and the opponent defends the square
+    void Move_Picker::generate_captures() {
+        board_move * captures = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+        int capture_count = game.get_valid_moves(captures, Game::CAPTURE_MOVES);
+
+        winning = arena.allocate_array<board_move>(capture_count);
+        winning_scores = arena.allocate_array<int>(capture_count);
+        losing = arena.allocate_array<board_move>(capture_count);
+        losing_scores = arena.allocate_array<int>(capture_count);
+        winning_count = 0;
+        losing_count = 0;
+
+        GAME_PIECE_COLOR opponent = game.get_current_player()->get_player_color() == GAME_PIECE_COLOR::WHITE ? GAME_PIECE_COLOR::BLACK : GAME_PIECE_COLOR::WHITE;
+        for (int i = 0; i < capture_count; ++i) {
+            game_piece mover = game.get_location(captures[i].first);
+            game_piece target = game.get_location(captures[i].second);
+
+            // En passant takes a pawn from beside the target square
+            int victim_value = game.validate_game_piece(target) ? PIECE_VALUES[target.type] : 0;
+            if (mover.type == GAME_PIECE_TYPE::PAWN && captures[i].first.second != captures[i].second.second && victim_value == 0) {
+                victim_value = PIECE_VALUES[GAME_PIECE_TYPE::PAWN];
+            }
+
+            // Most valuable victim first - the least valuable attacker breaks ties
+            int attacker_value = mover.type == GAME_PIECE_TYPE::KING ? PIECE_VALUES[GAME_PIECE_TYPE::QUEEN] * 2 : PIECE_VALUES[mover.type];
+            int score = (victim_value * 10) - (attacker_value / 10);
+
+            int promotion_x = mover.pawn_move_positive_x ? DEFAULT_CHESS_BOARD_SIZE - 1 : 0;
+            bool promotion = mover.type == GAME_PIECE_TYPE::PAWN && captures[i].second.first == promotion_x;
+            if (promotion) {
+                score += PIECE_VALUES[GAME_PIECE_TYPE::QUEEN] * 10;
+            }
+
+            if (promotion || victim_value >= attacker_value || !game.is_square_attacked(captures[i].second, opponent)) {
+                winning[winning_count] = captures[i];
+                winning_scores[winning_count++] = score;
+            } else {
+                losing[losing_count] = captures[i];
+                losing_scores[losing_count++] = score;
+            }
+        }
+    }
+
+    // Takes the best scoring move out of moves[index, count) and swaps it to index
+    // Picking one at a time leaves the rest unsorted if an early capture causes a cutoff
+    board_move Move_Picker::pick_best(board_move * moves, int * scores, int index, int count) {
+        int best = index;
+        for (int i = index + 1; i < count; ++i) {
+            if (scores[i] > scores[best]) {
+                best = i;
+            }
+        }
+
+        board_move best_move = moves[best];
+        int best_score = scores[best];
+        moves[best] = moves[index];
+        scores[best] = scores[index];
+        moves[index] = best_move;
+        scores[index] = best_score;
+        return best_move;
+    }
+
+    // Determines if the move is the hash move or one of the killers - those are handed out in their own stages
+    bool Move_Picker::is_special(const board_move& move) const {
+        if (move == hash_move) {
+            return true;
+        }
+        for (int i = 0; i < KILLER_MOVES_PER_PLY; ++i) {
+            if (move == killers[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
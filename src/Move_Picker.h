@@ -0,0 +1,65 @@
+#ifndef CPLUSPLUS_CHESS_MOVE_PICKER
+#define CPLUSPLUS_CHESS_MOVE_PICKER
+
+#include "Game.h"
+#include "Search_Arena.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Number of quiet moves remembered per ply for causing a cutoff
+    const int KILLER_MOVES_PER_PLY = 2;
+
+    // Hands the search one move at a time in stages - the hash move, winning captures, killers, quiet moves and finally losing captures
+    // A stage is only generated once the one before it runs out so a cutoff on an early move skips generating the rest
+    // Lists are carved from the arena - the caller must hold an Arena_Scope for as long as the picker is used
+    class Move_Picker {
+    public:
+        // killers_in holds KILLER_MOVES_PER_PLY moves or is nullptr - quiets_in false only hands out the hash move and captures
+        Move_Picker(Game& game_in, Search_Arena& arena_in, const board_move& hash_move_in, const board_move * killers_in, bool quiets_in);
+
+        // Writes the next move into move - returns false once every move has been handed out
+        bool next(board_move& move);
+
+    private:
+        // Stages in the order they are handed out
+        enum PICK_STAGE {
+            STAGE_HASH_MOVE,
+            STAGE_GENERATE_CAPTURES,
+            STAGE_WINNING_CAPTURES,
+            STAGE_KILLERS,
+            STAGE_GENERATE_QUIETS,
+            STAGE_QUIETS,
+            STAGE_LOSING_CAPTURES,
+            STAGE_DONE
+        };
+
+        // Generates the captures and splits them into winning and losing captures
+        // A capture is losing when the capturing piece is worth more than what it takes and the opponent defends the square
+        void generate_captures();
+
+        // Takes the best scoring move out of moves[index, count) and swaps it to index
+        static board_move pick_best(board_move * moves, int * scores, int index, int count);
+
+        // Determines if the move is the hash move or one of the killers - those are handed out in their own stages
+        bool is_special(const board_move& move) const;
+
+        Game& game;                     // Position the moves are for
+        Search_Arena& arena;            // Scratch memory for the move lists
+        board_move hash_move;           // Best move stored for the position - {-1, -1} positions if there is none
+        board_move killers[KILLER_MOVES_PER_PLY];   // Quiet moves that caused cutoffs at the same ply
+        bool quiets;                    // Whether quiet moves and killers are handed out
+        PICK_STAGE stage = STAGE_HASH_MOVE;
+
+        board_move * winning = nullptr; // Winning captures and promotions
+        int * winning_scores = nullptr;
+        int winning_count = 0;
+        board_move * losing = nullptr;  // Captures that lose material to a recapture
+        int * losing_scores = nullptr;
+        int losing_count = 0;
+        board_move * quiet_moves = nullptr;
+        int quiet_count = 0;
+        int index = 0;                  // Next move of the current stage
+    };
+}
+
+#endif
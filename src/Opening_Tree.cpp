@@ -0,0 +1,219 @@
+#include "Opening_Tree.h"
+#include "PGN_Reader.h"
+#include "Thread_Pool.h"
+
+#include <unordered_map>    // std::unordered_map
+#include <fstream>          // std::ofstream
+#include <atomic>           // std::atomic
+#include <random>           // std::mt19937_64
+#include <algorithm>        // std::sort, std::lower_bound
+#include <cstring>          // memcmp, memcpy
+
+namespace Chess_API {
+    static const char OPENING_TREE_MAGIC[8] = {'C', 'O', 'T', '1', 0, 0, 0, 0};     // Identifies an opening tree - padded to keep the entries after it aligned
+
+    // A position of the tree and the move played from it
+    struct tree_move_key {
+        uint64_t key;
+        uint16_t move;
+
+        bool operator==(const tree_move_key& other) const {return key == other.key && move == other.move;}
+    };
+
+    // The position keys are already random so mixing in the move is all the hashing needed
+    struct tree_move_key_hash {
+        size_t operator()(const tree_move_key& key) const {return static_cast<size_t>(key.key ^ (uint64_t(key.move) * 0x9E3779B97F4A7C15ULL));}
+    };
+
+    typedef std::unordered_map<tree_move_key, position_stats, tree_move_key_hash> tree_move_map;
+
+    // Returns the key range a position key belongs to - ranges follow the order of the keys so merged ranges are already in order
+    static size_t key_range(uint64_t key, size_t range_count) {
+        return static_cast<size_t>(((key >> 32) * range_count) >> 32);
+    }
+
+    // Maps the opening tree at file_path into memory
+    Opening_Tree::Opening_Tree(const std::string& file_path) : file(file_path) {
+        if (file.size() < sizeof(OPENING_TREE_MAGIC) + sizeof(uint64_t) || memcmp(file.data(), OPENING_TREE_MAGIC, sizeof(OPENING_TREE_MAGIC)) != 0) {
+            throw std::runtime_error(file_path + " isn't an opening tree");
+        }
+
+        uint64_t count;
+        memcpy(&count, file.data() + sizeof(OPENING_TREE_MAGIC), sizeof(count));
+        size_t header_size = sizeof(OPENING_TREE_MAGIC) + sizeof(uint64_t);
+        if (count != (file.size() - header_size) / sizeof(tree_entry) || (file.size() - header_size) % sizeof(tree_entry) != 0) {
+            throw std::runtime_error(file_path + " isn't an opening tree");
+        }
+        entries = reinterpret_cast<const tree_entry *>(file.data() + header_size);
+        entry_count = count;
+    }
+
+    // Reads every game of the PGN archive in parallel and writes the tree of their openings to tree_path - returns the number of games read
+    // Each worker counts into maps of its own split by key range which are merged range by range in parallel at the end
+    // Games that can't be played count up to the move that can't be played - throws a runtime_error if a file cannot be read or written
+    size_t Opening_Tree::build(const std::string& pgn_path, const std::string& tree_path, const opening_tree_limits& limits) {
+        PGN_Reader reader(pgn_path);
+        std::vector<std::string_view> chunks = PGN_Pipeline::split_chunks(reader.get_text(), limits.chunk_bytes);
+
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+
+        // The file is created before any work so a bad path fails straight away
+        std::ofstream output(tree_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            throw std::runtime_error("Unable to write the opening tree to " + tree_path);
+        }
+
+        // Every worker has a map for each key range - nothing is shared until the merge
+        std::vector<std::vector<tree_move_map>> worker_maps(thread_count, std::vector<tree_move_map>(thread_count));
+        std::atomic<size_t> next_chunk(0);
+        std::atomic<size_t> games_read(0);
+        std::atomic<bool> failed(false);
+
+        auto count_chunks = [&](unsigned int worker) {
+            try {
+                std::vector<tree_move_map>& maps = worker_maps[worker];
+                Game board = Game::make_scratch_board();
+
+                while (!failed) {
+                    size_t index = next_chunk++;
+                    if (index >= chunks.size()) {
+                        break;
+                    }
+
+                    games_read += PGN_Reader::read_games(chunks[index], [&](const pgn_game& game) {
+                        if (game.moves.empty()) {
+                            return;
+                        }
+
+                        // A FEN the reader couldn't load leaves no moves so the starting position is always loadable here
+                        int white_half_points = game.get_white_half_points();
+                        std::string_view fen = game.get_tag("FEN");
+                        board.from_fen(fen.empty() ? std::string_view(STARTING_POSITION_FEN) : fen);
+                        for (int ply = 0; ply < game.moves.size(); ++ply) {
+                            const board_move& move = game.moves[ply];
+                            tree_move_key key;
+                            key.key = board.get_hash_key();
+                            key.move = encode_stored_move(move);
+                            maps[key_range(key.key, thread_count)][key].add_game(white_half_points);
+                            board.make_move(move.first, move.second);
+                        }
+                    }, true, limits.max_plies);
+                }
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+        };
+
+        // The calling thread counts chunks alongside the workers - the first error any of them hit is thrown once they have all stopped
+        std::shared_ptr<Thread_Pool> thread_pool = Thread_Pool::get_default();
+        thread_pool->run_shares(thread_count, count_chunks);
+
+        // Each thread merges one key range from every worker and sorts it - the ranges are in key order so they are written one after another
+        std::vector<std::vector<tree_entry>> ranges(thread_count);
+        auto merge_range = [&](unsigned int range) {
+            tree_move_map merged;
+            for (unsigned int worker = 0; worker < thread_count; ++worker) {
+                tree_move_map& source = worker_maps[worker][range];
+                if (merged.empty()) {
+                    merged.swap(source);
+                    continue;
+                }
+                for (auto it = source.begin(); it != source.end(); ++it) {
+                    position_stats& stats = merged[it->first];
+                    stats.games += it->second.games;
+                    stats.white_wins += it->second.white_wins;
+                    stats.draws += it->second.draws;
+                    stats.black_wins += it->second.black_wins;
+                }
+                tree_move_map().swap(source);
+            }
+
+            std::vector<tree_entry>& entries = ranges[range];
+            entries.reserve(merged.size());
+            for (auto it = merged.begin(); it != merged.end(); ++it) {
+                if (it->second.games < limits.min_games) {
+                    continue;
+                }
+                tree_entry entry;
+                entry.key = it->first.key;
+                entry.move = it->first.move;
+                entry.reserved = 0;
+                entry.reserved_stats = 0;
+                entry.stats = it->second;
+                entries.push_back(entry);
+            }
+            std::sort(entries.begin(), entries.end(), [](const tree_entry& first, const tree_entry& second) {
+                if (first.key != second.key) {
+                    return first.key < second.key;
+                }
+                return first.stats.games != second.stats.games ? first.stats.games > second.stats.games : first.move < second.move;
+            });
+        };
+
+        thread_pool->run_shares(thread_count, merge_range);
+
+        uint64_t count = 0;
+        for (unsigned int r = 0; r < thread_count; ++r) {
+            count += ranges[r].size();
+        }
+        output.write(OPENING_TREE_MAGIC, sizeof(OPENING_TREE_MAGIC));
+        output.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        for (unsigned int r = 0; r < thread_count; ++r) {
+            output.write(reinterpret_cast<const char *>(ranges[r].data()), ranges[r].size() * sizeof(tree_entry));
+        }
+        if (!output) {
+            throw std::runtime_error("Unable to write the opening tree to " + tree_path);
+        }
+        return games_read;
+    }
+
+    // Replaces moves with every move played from the position with the hash key - the most played first - returns the number of moves
+    size_t Opening_Tree::get_moves(uint64_t key, std::vector<opening_tree_move>& moves) const {
+        moves.clear();
+        const tree_entry * found = std::lower_bound(entries, entries + entry_count, key, [](const tree_entry& entry, uint64_t value) {
+            return entry.key < value;
+        });
+
+        for (; found != entries + entry_count && found->key == key; ++found) {
+            opening_tree_move move;
+            move.move = decode_stored_move(found->move);
+            move.stats = found->stats;
+            moves.push_back(move);
+        }
+        return moves.size();
+    }
+
+    // Picks a move for the position at random weighted by how often each move was played - the same seed always picks the same move
+    // Moves that can't be played in the position are never picked - returns {-1, -1} positions if the tree has no move for it
+    // A different position sharing the hash key could hand back moves that don't fit so every move is checked
+    board_move Opening_Tree::choose_move(const Game& game, uint64_t seed) const {
+        board_move no_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        std::vector<opening_tree_move> moves;
+        if (get_moves(game.get_hash_key(), moves) == 0) {
+            return no_move;
+        }
+
+        Game check_game(game);
+        uint64_t total_games = 0;
+        for (int i = 0; i < moves.size(); ++i) {
+            if (check_game.is_valid_move(moves[i].move.first, moves[i].move.second) != Game::VALID_MOVE) {
+                moves[i].stats.games = 0;
+            }
+            total_games += moves[i].stats.games;
+        }
+        if (total_games == 0) {
+            return no_move;
+        }
+
+        std::mt19937_64 random(seed ^ game.get_hash_key());
+        uint64_t pick = random() % total_games;
+        for (int i = 0; i < moves.size(); ++i) {
+            if (pick < moves[i].stats.games) {
+                return moves[i].move;
+            }
+            pick -= moves[i].stats.games;
+        }
+        return no_move;
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef CPLUSPLUS_CHESS_OPENING_TREE
+#define CPLUSPLUS_CHESS_OPENING_TREE
+
+#include <vector>
+#include <string>
+#include <cstdint>      // uint16_t, uint32_t, uint64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "PGN_Pipeline.h"
+#include "Position_Index.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Settings for building an opening tree from a PGN archive
+    struct opening_tree_limits {
+        int max_plies = 20;                             // Moves deeper into a game than this are left out of the tree
+        unsigned int threads = 0;                       // Workers reading the archive - 0 uses one per hardware thread
+        size_t chunk_bytes = DEFAULT_PGN_CHUNK_BYTES;   // Bytes of the archive a worker claims at a time
+        uint32_t min_games = 1;                         // Moves played in fewer games than this are left out of the file
+    };
+
+    // A move played from a position of the tree with what happened in the games it was played in
+    typedef position_move opening_tree_move;
+
+    // A book of the moves played from each position of an archive's openings - positions are found by their Zobrist hash key
+    // The file is mapped and searched in place so the computer player can read it like an opening book
+    // Throws a runtime_error if the file cannot be opened or isn't an opening tree
+    class Opening_Tree {
+    public:
+        // Maps the opening tree at file_path into memory
+        Opening_Tree(const std::string& file_path);
+
+        // Reads every game of the PGN archive in parallel and writes the tree of their openings to tree_path - returns the number of games read
+        // Each worker counts into maps of its own split by key range which are merged range by range in parallel at the end
+        // Games that can't be played count up to the move that can't be played - throws a runtime_error if a file cannot be read or written
+        static size_t build(const std::string& pgn_path, const std::string& tree_path, const opening_tree_limits& limits);
+
+        // Returns the number of position and move pairs in the tree
+        size_t get_entry_count() const {return entry_count;}
+
+        // Replaces moves with every move played from the position with the hash key - the most played first - returns the number of moves
+        size_t get_moves(uint64_t key, std::vector<opening_tree_move>& moves) const;
+
+        // Picks a move for the position at random weighted by how often each move was played - the same seed always picks the same move
+        // Moves that can't be played in the position are never picked - returns {-1, -1} positions if the tree has no move for it
+        board_move choose_move(const Game& game, uint64_t seed) const;
+
+    private:
+        // One move played from one position - entries are sorted by key then by the most played move
+        struct tree_entry {
+            uint64_t key;
+            uint16_t move;          // Packed by encode_stored_move
+            uint16_t reserved;
+            uint32_t reserved_stats;
+            position_stats stats;
+        };
+
+        Mapped_File file;                       // Tree being read
+        const tree_entry * entries = nullptr;
+        size_t entry_count = 0;
+    };
+}
+
+#endif
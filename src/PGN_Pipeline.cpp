@@ -0,0 +1,196 @@
+#include "PGN_Pipeline.h"
+#include "Thread_Pool.h"
+
+#include <thread>               // std::thread
+#include <mutex>                // std::mutex
+#include <condition_variable>   // std::condition_variable
+#include <exception>            // std::exception_ptr
+
+namespace Chess_API {
+    // Adds the counts of other to these and appends its positions
+    void pgn_chunk_result::merge(const pgn_chunk_result& other) {
+        games += other.games;
+        moves += other.moves;
+        unplayable_games += other.unplayable_games;
+        white_wins += other.white_wins;
+        draws += other.draws;
+        black_wins += other.black_wins;
+        no_results += other.no_results;
+        positions.insert(positions.end(), other.positions.begin(), other.positions.end());
+    }
+
+    // Splits text into chunks of about chunk_bytes - every chunk but the first starts on the first tag of a game
+    // A game starts on a tag line that doesn't follow another tag line
+    std::vector<std::string_view> PGN_Pipeline::split_chunks(std::string_view text, size_t chunk_bytes) {
+        std::vector<std::string_view> chunks;
+        if (chunk_bytes == 0) {
+            chunk_bytes = DEFAULT_PGN_CHUNK_BYTES;
+        }
+
+        size_t chunk_start = 0;
+        while (chunk_start < text.size()) {
+            size_t boundary = text.size();
+            size_t search = chunk_start + chunk_bytes;
+            while (search < text.size()) {
+                size_t line_start = text.find("\n[", search);
+                if (line_start == std::string_view::npos) {
+                    break;
+                }
+
+                // The line before has to be something other than a tag - otherwise this is the middle of a game's tags
+                size_t previous_start = line_start == 0 ? std::string_view::npos : text.rfind('\n', line_start - 1);
+                previous_start = previous_start == std::string_view::npos ? 0 : previous_start + 1;
+                if (line_start == 0 || text[previous_start] != '[') {
+                    boundary = line_start + 1;
+                    break;
+                }
+                search = line_start + 1;
+            }
+
+            chunks.push_back(text.substr(chunk_start, boundary - chunk_start));
+            chunk_start = boundary;
+        }
+        return chunks;
+    }
+
+    // Reads every game in the chunk into a result - positions are extracted as the limits ask
+    // Extracting replays the moves the reader already resolved on a board of its own - make_move alone costs little next to resolving them
+    pgn_chunk_result PGN_Pipeline::read_chunk(std::string_view chunk, const pgn_pipeline_limits& limits) {
+        pgn_chunk_result result;
+        Game board = Game::make_scratch_board();
+
+        PGN_Reader::read_games(chunk, [&result, &board, &limits](const pgn_game& game) {
+            ++result.games;
+            result.moves += game.moves.size();
+            if (!game.error.empty()) {
+                ++result.unplayable_games;
+            }
+
+            int white_half_points = game.get_white_half_points();
+            result.white_wins += white_half_points == 2 ? 1 : 0;
+            result.draws += white_half_points == 1 ? 1 : 0;
+            result.black_wins += white_half_points == 0 ? 1 : 0;
+            result.no_results += white_half_points == -1 ? 1 : 0;
+
+            if (limits.position_stride <= 0 || game.moves.empty()) {
+                return;
+            }
+
+            // A FEN the reader couldn't load leaves no moves so the starting position is always loadable here
+            std::string_view fen = game.get_tag("FEN");
+            board.from_fen(fen.empty() ? std::string_view(STARTING_POSITION_FEN) : fen);
+            for (int ply = 0; ply < game.moves.size(); ++ply) {
+                board.make_move(game.moves[ply].first, game.moves[ply].second);
+                if (ply + 1 > limits.skip_plies && (ply + 1) % limits.position_stride == 0) {
+                    pgn_position position;
+                    position.fen = board.to_fen();
+                    position.white_half_points = white_half_points;
+                    result.positions.push_back(std::move(position));
+                }
+            }
+        });
+        return result;
+    }
+
+    // Reads every game of the file within the limits and hands each chunk to on_chunk on the calling thread in file order
+    // Returns the counts over the whole file - positions only reach the caller through on_chunk so they are never all held at once
+    // Workers stay at most two chunks per thread ahead of the chunk on_chunk is waiting for so a slow on_chunk holds them back
+    // Throws whatever a worker or on_chunk threw once the workers have stopped
+    pgn_chunk_result PGN_Pipeline::run(const pgn_pipeline_limits& limits, pgn_chunk_callback on_chunk) const {
+        std::vector<std::string_view> chunks = split_chunks(reader.get_text(), limits.chunk_bytes);
+
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+        if (thread_count > chunks.size()) {
+            thread_count = chunks.size();
+        }
+
+        // Workers never get more than this many chunks ahead of the caller so a slow on_chunk doesn't leave the whole file's results waiting in memory
+        size_t window = size_t(2) * thread_count;
+
+        std::mutex results_mutex;                       // Guards everything below
+        std::condition_variable chunk_progress;         // Signalled when a chunk's result is stored or handed out and when the run is abandoned
+        size_t next_chunk = 0;                          // Next chunk a worker may claim
+        size_t handed_out = 0;                          // Chunks already handed to on_chunk
+        bool abandoned = false;
+        std::vector<pgn_chunk_result> results(chunks.size());
+        std::vector<char> ready(chunks.size(), 0);
+        std::vector<std::exception_ptr> errors(chunks.size());
+
+        // Each worker claims the next chunk until none are left or the run has failed - waiting while it is a full window ahead
+        auto read_chunks = [&]() {
+            while (true) {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(results_mutex);
+                    chunk_progress.wait(lock, [&]() {return abandoned || next_chunk < handed_out + window;});
+                    if (abandoned || next_chunk >= chunks.size()) {
+                        break;
+                    }
+                    index = next_chunk++;
+                }
+
+                pgn_chunk_result result;
+                std::exception_ptr error;
+                try {
+                    result = read_chunk(chunks[index], limits);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(results_mutex);
+                results[index] = std::move(result);
+                errors[index] = error;
+                ready[index] = 1;
+                chunk_progress.notify_all();
+            }
+        };
+
+        // The workers get threads of their own rather than pool shares - a worker a full window ahead blocks until on_chunk catches up
+        // On the shared pool that wait would hold a worker other jobs need and run_shares would have the caller reading chunks instead of handing them out
+        std::vector<std::thread> threads;
+        for (unsigned int t = 0; t < thread_count; ++t) {
+            threads.push_back(std::thread(read_chunks));
+        }
+
+        // Results are handed out in order as they become ready and let go of once handed out
+        pgn_chunk_result total;
+        std::exception_ptr failure;
+        for (size_t index = 0; index < chunks.size() && failure == nullptr; ++index) {
+            pgn_chunk_result result;
+            {
+                std::unique_lock<std::mutex> lock(results_mutex);
+                chunk_progress.wait(lock, [&ready, index]() {return ready[index] != 0;});
+                failure = errors[index];
+                result = std::move(results[index]);
+                ++handed_out;
+            }
+            chunk_progress.notify_all();
+
+            if (failure == nullptr) {
+                try {
+                    if (on_chunk) {
+                        on_chunk(index, result);
+                    }
+                } catch (...) {
+                    failure = std::current_exception();
+                }
+            }
+
+            result.positions.clear();
+            total.merge(result);
+        }
+
+        if (failure != nullptr) {
+            std::lock_guard<std::mutex> lock(results_mutex);
+            abandoned = true;
+            chunk_progress.notify_all();
+        }
+        for (int t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        if (failure != nullptr) {
+            std::rethrow_exception(failure);
+        }
+        return total;
+    }
+}
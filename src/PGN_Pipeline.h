@@ -0,0 +1,72 @@
+#ifndef CPLUSPLUS_CHESS_PGN_PIPELINE
+#define CPLUSPLUS_CHESS_PGN_PIPELINE
+
+#include <vector>
+#include <string>
+#include <string_view>  // std::string_view
+#include <functional>   // std::function
+#include <cstddef>      // size_t
+
+#include "PGN_Reader.h"
+
+namespace Chess_API {
+    // Bytes of PGN each worker reads at a time - enough games that handing out chunks costs nothing next to reading them
+    const size_t DEFAULT_PGN_CHUNK_BYTES = size_t(4) << 20;
+
+    // Settings for reading a PGN file on many threads at once
+    struct pgn_pipeline_limits {
+        unsigned int threads = 0;                       // Threads reading chunks - 0 uses every hardware thread
+        size_t chunk_bytes = DEFAULT_PGN_CHUNK_BYTES;   // Rough size of each chunk - chunks always end on a game boundary
+        int position_stride = 0;                        // Every this many plies of each game is extracted as a position - 0 extracts none
+        int skip_plies = 0;                             // Plies at the start of each game that are never extracted
+    };
+
+    // A position taken from a game along with how the game ended
+    struct pgn_position {
+        std::string fen;
+        int white_half_points = -1;     // Half points white scored in the game - 0, 1 or 2 - -1 if the game has no result
+    };
+
+    // Everything read out of one chunk of games
+    struct pgn_chunk_result {
+        size_t games = 0;
+        size_t moves = 0;                   // Moves played out over every game
+        size_t unplayable_games = 0;        // Games with a move that couldn't be played
+        size_t white_wins = 0;
+        size_t draws = 0;
+        size_t black_wins = 0;
+        size_t no_results = 0;              // Games that ended with * or without a result
+        std::vector<pgn_position> positions;    // Positions extracted in the order of the games
+
+        // Adds the counts of other to these and appends its positions
+        void merge(const pgn_chunk_result& other);
+    };
+
+    // Called with the index of each chunk and its result - chunks arrive in the order they appear in the file
+    typedef std::function<void(size_t, const pgn_chunk_result&)> pgn_chunk_callback;
+
+    // Reads a PGN file on many threads by splitting the mapped file into chunks at game boundaries
+    // Each worker reads whole chunks with its own board and the results are handed back in file order
+    class PGN_Pipeline {
+    public:
+        // Maps the whole file at file_path into memory - throws a runtime_error if the file cannot be opened or mapped
+        PGN_Pipeline(const std::string& file_path) : reader(file_path) {}
+
+        // Reads every game of the file within the limits and hands each chunk to on_chunk on the calling thread in file order
+        // Returns the counts over the whole file - positions only reach the caller through on_chunk so they are never all held at once
+        // Workers stay at most two chunks per thread ahead of the chunk on_chunk is waiting for so a slow on_chunk holds them back
+        // Throws whatever a worker or on_chunk threw once the workers have stopped
+        pgn_chunk_result run(const pgn_pipeline_limits& limits, pgn_chunk_callback on_chunk = nullptr) const;
+
+        // Splits text into chunks of about chunk_bytes - every chunk but the first starts on the first tag of a game
+        static std::vector<std::string_view> split_chunks(std::string_view text, size_t chunk_bytes);
+
+        // Reads every game in the chunk into a result - positions are extracted as the limits ask
+        static pgn_chunk_result read_chunk(std::string_view chunk, const pgn_pipeline_limits& limits);
+
+    private:
+        PGN_Reader reader;  // Holds the mapped file
+    };
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include "PGN_Reader.h"
+
+namespace Chess_API {
+    // Determines if the character separates tokens
+    static bool is_pgn_space(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Determines if the token ends a game
+    static bool is_pgn_result(std::string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    // Returns the position just past the end of the line position is on
+    static size_t skip_line(std::string_view text, size_t position) {
+        size_t line_end = text.find('\n', position);
+        return line_end == std::string_view::npos ? text.size() : line_end + 1;
+    }
+
+    // Returns the position just past the comment or variation starting at position - variations may nest and hold comments of their own
+    static size_t skip_annotation(std::string_view text, size_t position) {
+        int depth = 0;
+        while (position < text.size()) {
+            char c = text[position];
+            if (c == '{') {
+                size_t comment_end = text.find('}', position);
+                position = comment_end == std::string_view::npos ? text.size() : comment_end + 1;
+            } else if (c == ';') {
+                position = skip_line(text, position);
+            } else {
+                ++position;
+                if (c == '(') {
+                    ++depth;
+                } else if (c == ')') {
+                    --depth;
+                }
+            }
+
+            if (depth <= 0) {
+                break;
+            }
+        }
+        return position;
+    }
+
+    // Returns the value of the tag - empty if the game doesn't have it
+    std::string_view pgn_game::get_tag(std::string_view name) const {
+        for (int i = 0; i < tags.size(); ++i) {
+            if (tags[i].name == name) {
+                return tags[i].value;
+            }
+        }
+        return std::string_view();
+    }
+
+    // Returns the half points white scored by the result - 0, 1 or 2 - -1 if the game has no result
+    int pgn_game::get_white_half_points() const {
+        if (result == "1-0") {
+            return 2;
+        } else if (result == "1/2-1/2") {
+            return 1;
+        } else if (result == "0-1") {
+            return 0;
+        }
+        return -1;
+    }
+
+    // Maps the whole file at file_path into memory - throws a runtime_error if the file cannot be opened or mapped
+    PGN_Reader::PGN_Reader(const std::string& file_path) : file(file_path) {}
+
+    // Reads every game of the file and hands each one to on_game - returns the number of games read
+    // resolve_moves false only splits out the tags and movetext which skips playing through every game
+    // max_plies above 0 stops resolving moves after that many plies - the rest of the game is still read past
+    size_t PGN_Reader::read_games(pgn_callback on_game, bool resolve_moves, int max_plies) const {
+        return read_games(get_text(), on_game, resolve_moves, max_plies);
+    }
+
+    // Reads every game in text and hands each one to on_game - returns the number of games read
+    // Comments, variations, annotation glyphs and move numbers are skipped - only the main line is played
+    // max_plies above 0 stops resolving moves after that many plies - the rest of the game is still read past
+    // One game and one board are reused for every game read so nothing is allocated once they have grown to fit the longest game
+    size_t PGN_Reader::read_games(std::string_view text, pgn_callback on_game, bool resolve_moves, int max_plies) {
+        Game board = Game::make_scratch_board();
+
+        pgn_game game;
+        size_t games_read = 0;
+        size_t position = 0;
+        while (true) {
+            // Escaped lines and blank space between games are skipped
+            while (position < text.size() && (is_pgn_space(text[position]) || (text[position] == '%' && (position == 0 || text[position - 1] == '\n')))) {
+                position = text[position] == '%' ? skip_line(text, position) : position + 1;
+            }
+            if (position >= text.size()) {
+                break;
+            }
+
+            game.tags.clear();
+            game.moves.clear();
+            game.result = std::string_view();
+            game.error = std::string_view();
+
+            // Tag pairs - one [Name "Value"] to a line
+            while (position < text.size() && text[position] == '[') {
+                size_t line_end = skip_line(text, position);
+                size_t name_start = ++position;
+                while (position < line_end && !is_pgn_space(text[position]) && text[position] != '"' && text[position] != ']') {
+                    ++position;
+                }
+                pgn_tag tag;
+                tag.name = text.substr(name_start, position - name_start);
+
+                size_t value_start = text.find('"', position);
+                if (value_start != std::string_view::npos && value_start < line_end) {
+                    size_t value_end = ++value_start;
+                    while (value_end < line_end && text[value_end] != '"') {
+                        value_end += text[value_end] == '\\' ? 2 : 1;
+                    }
+                    tag.value = text.substr(value_start, (value_end < line_end ? value_end : line_end) - value_start);
+                }
+                game.tags.push_back(tag);
+
+                position = line_end;
+                while (position < text.size() && is_pgn_space(text[position])) {
+                    ++position;
+                }
+            }
+
+            // Games set up from another position say so with a FEN tag
+            bool playing = resolve_moves;
+            if (playing) {
+                std::string_view fen = game.get_tag("FEN");
+                try {
+                    board.from_fen(fen.empty() ? std::string_view(STARTING_POSITION_FEN) : fen);
+                    if (!fen.empty()) {
+                        board.update_game_state();
+                    }
+                } catch (const std::runtime_error&) {
+                    game.error = fen;
+                    playing = false;
+                }
+            }
+
+            // Movetext - runs to the result or to the tags of the next game when the result is missing
+            size_t movetext_start = position;
+            size_t movetext_end = position;
+            while (position < text.size()) {
+                char c = text[position];
+                if (is_pgn_space(c)) {
+                    ++position;
+                    continue;
+                }
+                if ((c == '[' || c == '%') && (position == 0 || text[position - 1] == '\n')) {
+                    if (c == '[') {
+                        break;
+                    }
+                    position = skip_line(text, position);
+                    continue;
+                }
+                if (c == '{' || c == ';' || c == '(') {
+                    position = skip_annotation(text, position);
+                    movetext_end = position;
+                    continue;
+                }
+
+                size_t token_start = position;
+                while (position < text.size() && !is_pgn_space(text[position]) && text[position] != '{' && text[position] != ';'
+                    && text[position] != '(' && text[position] != ')') {
+                    ++position;
+                }
+                if (position == token_start) {
+                    ++position;
+                    continue;
+                }
+                movetext_end = position;
+
+                std::string_view token = text.substr(token_start, position - token_start);
+                if (is_pgn_result(token)) {
+                    game.result = token;
+                    break;
+                }
+
+                // Move numbers may be written straight against the move that follows them - 12.e4 or 12...e5
+                size_t move_start = 0;
+                while (move_start < token.size() && ((token[move_start] >= '0' && token[move_start] <= '9') || token[move_start] == '.')) {
+                    ++move_start;
+                }
+                token.remove_prefix(move_start);
+                if (token.empty() || token[0] == '$' || !playing) {
+                    continue;
+                }
+
+                board_move move = board.find_san_move(token);
+                if (move.first.first == -1) {
+                    game.error = token;
+                    playing = false;
+                    continue;
+                }
+                game.moves.push_back(move);
+                board.make_move(move.first, move.second);
+
+                // Only the opening was wanted - resolving the rest is most of the cost of reading a game
+                if (max_plies > 0 && game.moves.size() >= max_plies) {
+                    playing = false;
+                }
+            }
+
+            game.movetext = text.substr(movetext_start, movetext_end - movetext_start);
+            ++games_read;
+            on_game(game);
+        }
+
+        return games_read;
+    }
+}
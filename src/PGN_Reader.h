@@ -0,0 +1,64 @@
+#ifndef CPLUSPLUS_CHESS_PGN_READER
+#define CPLUSPLUS_CHESS_PGN_READER
+
+#include <vector>
+#include <string>
+#include <string_view>  // std::string_view
+#include <functional>   // std::function
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // A tag pair from the header of a game - the value is between the quotes with any escapes left as they were written
+    struct pgn_tag {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // One game read from a PGN - every view points into the text being read and is only valid while that text is
+    struct pgn_game {
+        std::vector<pgn_tag> tags;          // Tag pairs in the order they were written
+        std::string_view movetext;          // Everything after the tags up to and including the result
+        std::vector<board_move> moves;      // Moves of the main line played out from the starting position - empty when moves aren't resolved
+        std::string_view result;            // 1-0, 0-1, 1/2-1/2 or * - empty if the game ended without one
+        std::string_view error;             // Move that couldn't be played - moves holds everything before it - empty when the whole game was played
+
+        // Returns the value of the tag - empty if the game doesn't have it
+        std::string_view get_tag(std::string_view name) const;
+
+        // Returns the half points white scored by the result - 0, 1 or 2 - -1 if the game has no result
+        int get_white_half_points() const;
+    };
+
+    // Called with each game as soon as it has been read - the game is reused for the next one once the call returns
+    typedef std::function<void(const pgn_game&)> pgn_callback;
+
+    // Streams the games of a PGN file one at a time without copying any of it
+    // The file is mapped into memory and read in place so memory use stays the same however large the file is
+    class PGN_Reader {
+    public:
+        // Maps the whole file at file_path into memory - throws a runtime_error if the file cannot be opened or mapped
+        PGN_Reader(const std::string& file_path);
+
+        // Reads every game of the file and hands each one to on_game - returns the number of games read
+        // resolve_moves false only splits out the tags and movetext which skips playing through every game
+        // max_plies above 0 stops resolving moves after that many plies - the rest of the game is still read past
+        size_t read_games(pgn_callback on_game, bool resolve_moves = true, int max_plies = 0) const;
+
+        // Reads every game in text and hands each one to on_game - returns the number of games read
+        // Comments, variations, annotation glyphs and move numbers are skipped - only the main line is played
+        // max_plies above 0 stops resolving moves after that many plies - the rest of the game is still read past
+        static size_t read_games(std::string_view text, pgn_callback on_game, bool resolve_moves = true, int max_plies = 0);
+
+        // Returns the whole mapped file
+        std::string_view get_text() const {return std::string_view(reinterpret_cast<const char *>(file.data()), file.size());}
+
+    private:
+        Mapped_File file;   // File the games are read from
+    };
+}
+
+#endif
@@ -0,0 +1,74 @@
+#include "Packed_Position.h"
+
+#include <cstring>      // memcmp
+
+namespace Chess_API {
+    // Identifies a packed position file - padded to 8 bytes so the records after it stay aligned in the mapping
+    static const char PACKED_POSITION_MAGIC[8] = {'C', 'P', 'P', '1', 0, 0, 0, 0};
+
+    // Creates the file at file_path - anything already there is replaced
+    Packed_Position_Writer::Packed_Position_Writer(const std::string& file_path) : output(file_path, std::ios::binary | std::ios::trunc), file_path(file_path) {
+        if (!output) {
+            throw std::runtime_error("Unable to write the packed positions to " + file_path);
+        }
+        output.write(PACKED_POSITION_MAGIC, sizeof(PACKED_POSITION_MAGIC));
+        buffer.reserve(PACKED_POSITION_BUFFER_COUNT);
+    }
+
+    // Writes out whatever positions are still gathered - an error here is swallowed so call flush first to find out if everything was written
+    Packed_Position_Writer::~Packed_Position_Writer() {
+        try {
+            flush();
+        } catch (const std::runtime_error&) {
+            // A destructor has no way to report the failure
+        }
+    }
+
+    // Packs the current position of the game with its score for the side to move and the half points white scored - -1 if not known yet
+    // Scores beyond what 16 bits hold are clamped - mate scores still sort above every other score
+    void Packed_Position_Writer::write(const Game& game, int score, int white_half_points) {
+        packed_position position;
+        game.to_packed(position);
+        position.score = static_cast<int16_t>(score > INT16_MAX ? INT16_MAX : (score < -INT16_MAX ? -INT16_MAX : score));
+        position.set_white_half_points(white_half_points);
+        write(position);
+    }
+
+    // Adds the packed position to the end of the file - throws a runtime_error if a full buffer cannot be written out
+    void Packed_Position_Writer::write(const packed_position& position) {
+        buffer.push_back(position);
+        ++position_count;
+        if (buffer.size() >= PACKED_POSITION_BUFFER_COUNT) {
+            flush();
+        }
+    }
+
+    // Writes out every gathered position - throws a runtime_error if the file cannot be written
+    void Packed_Position_Writer::flush() {
+        if (!buffer.empty()) {
+            output.write(reinterpret_cast<const char *>(buffer.data()), buffer.size() * sizeof(packed_position));
+            buffer.clear();
+        }
+        output.flush();
+        if (!output) {
+            throw std::runtime_error("Unable to write the packed positions to " + file_path);
+        }
+    }
+
+    // Maps the whole file at file_path into memory
+    // A file cut off part way through a record is refused rather than read past its end
+    Packed_Position_Reader::Packed_Position_Reader(const std::string& file_path) : file(file_path) {
+        if (file.size() < sizeof(PACKED_POSITION_MAGIC) || memcmp(file.data(), PACKED_POSITION_MAGIC, sizeof(PACKED_POSITION_MAGIC)) != 0
+            || (file.size() - sizeof(PACKED_POSITION_MAGIC)) % sizeof(packed_position) != 0) {
+            throw std::runtime_error(file_path + " isn't a packed position file");
+        }
+        positions = reinterpret_cast<const packed_position *>(file.data() + sizeof(PACKED_POSITION_MAGIC));
+        position_count = (file.size() - sizeof(PACKED_POSITION_MAGIC)) / sizeof(packed_position);
+    }
+
+    // Decodes the position at index into the game - once the game has held a full board decoding allocates nothing
+    // Throws a runtime_error if the record is damaged
+    void Packed_Position_Reader::load_position(size_t index, Game& game) const {
+        game.from_packed(positions[index]);
+    }
+}
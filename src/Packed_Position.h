@@ -0,0 +1,71 @@
+#ifndef CPLUSPLUS_CHESS_PACKED_POSITION
+#define CPLUSPLUS_CHESS_PACKED_POSITION
+
+#include <vector>
+#include <string>
+#include <fstream>      // std::ofstream
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // Positions gathered in memory before they are written out - 1 MB of records
+    const size_t PACKED_POSITION_BUFFER_COUNT = (size_t(1) << 20) / sizeof(packed_position);
+
+    // Streams packed positions into a file - an 8 byte header followed by one 32 byte record per position
+    // Records are gathered in memory and written out in large blocks - throws a runtime_error if the file cannot be written
+    class Packed_Position_Writer {
+    public:
+        // Creates the file at file_path - anything already there is replaced
+        Packed_Position_Writer(const std::string& file_path);
+
+        // Writes out whatever positions are still gathered - an error here is swallowed so call flush first to find out if everything was written
+        ~Packed_Position_Writer();
+
+        // Packs the current position of the game with its score for the side to move and the half points white scored - -1 if not known yet
+        void write(const Game& game, int score, int white_half_points);
+
+        // Adds the packed position to the end of the file - throws a runtime_error if a full buffer cannot be written out
+        void write(const packed_position& position);
+
+        // Writes out every gathered position - throws a runtime_error if the file cannot be written
+        void flush();
+
+        // Returns the number of positions written
+        size_t get_position_count() const {return position_count;}
+
+    private:
+        std::ofstream output;                   // File being written
+        std::string file_path;                  // Named in the error when the file cannot be written
+        std::vector<packed_position> buffer;    // Positions not yet written out
+        size_t position_count = 0;
+    };
+
+    // Reads packed positions from a file written by Packed_Position_Writer - the file is mapped and the records are used in place
+    // Records are a fixed size so any position can be reached directly by its index
+    // Throws a runtime_error if the file cannot be opened or isn't a packed position file
+    class Packed_Position_Reader {
+    public:
+        // Maps the whole file at file_path into memory
+        Packed_Position_Reader(const std::string& file_path);
+
+        // Returns the number of positions in the file
+        size_t get_position_count() const {return position_count;}
+
+        // Returns the position at index - must be less than the position count
+        const packed_position& get_position(size_t index) const {return positions[index];}
+
+        // Decodes the position at index into the game - once the game has held a full board decoding allocates nothing
+        // Throws a runtime_error if the record is damaged
+        void load_position(size_t index, Game& game) const;
+
+    private:
+        Mapped_File file;                           // File being read
+        const packed_position * positions;          // First record - straight after the header
+        size_t position_count;
+    };
+}
+
+#endif
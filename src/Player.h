@@ -3,7 +3,10 @@
 
 #include <tuple> // std::pair
 #include <string>
+#include <future>   // std::future
+#include <memory>   // std::shared_ptr
 #include "Chess_API_vars.h"
+#include "Cancellation_Token.h"
 
 namespace Chess_API {
     class Player {
@@ -12,6 +15,11 @@ namespace Chess_API {
         GAME_PIECE_COLOR player_color;  // Piece color to help identifying the player further
         std::string name;               // Players name
 
+        // Converts a board position into the {char}{num} format used for player input - for example {0, 0} becomes "a1"
+        static std::string position_to_string(const std::pair<int, int>& position) {
+            return std::string(1, VALID_CHARS.at(position.second)) + VALID_NUMS.at(position.first);
+        }
+
         // Sets up the player id to destinguish different players
         void set_player_id() {
             static int next_player_id = 0; 
@@ -39,6 +47,13 @@ namespace Chess_API {
         
         // Prompts the player to take their turn
         virtual std::pair<std::string, std::string> take_turn() const = 0;
+
+        // Starts the players turn without blocking - the move arrives through the future once the player has decided
+        // The token lets the caller cancel the turn or give it a deadline - a cancelled turn delivers a runtime_error instead of a move
+        virtual std::future<std::pair<std::string, std::string>> take_turn_async(std::shared_ptr<const Cancellation_Token> token) const = 0;
+
+        // Asks a turn started by take_turn_async to finish now - called once its token is cancelled or past its deadline
+        virtual void cancel_turn() const {}
     };
 }
 
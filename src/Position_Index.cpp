@@ -0,0 +1,268 @@
+#include "Position_Index.h"
+#include "PGN_Reader.h"
+
+#include <fstream>      // std::ofstream
+#include <algorithm>    // std::sort, std::lower_bound
+#include <cstring>      // memcmp
+
+namespace Chess_API {
+    static const char POSITION_INDEX_MAGIC[8] = {'C', 'P', 'I', '2', 0, 0, 0, 0};     // Identifies a position index - padded to keep the tables after it aligned
+    static const int BUCKET_BITS = 16;                                                  // Top bits of a key that pick its bucket
+    static const size_t BUCKET_COUNT = size_t(1) << BUCKET_BITS;
+    static const int BOARD_SQUARES = DEFAULT_CHESS_BOARD_SIZE * DEFAULT_CHESS_BOARD_SIZE;
+    static const uint16_t NO_STORED_MOVE = 0xFFFF;                                      // Posting of the position a game ended in
+
+    // Fixed part at the start of an index - followed by the buckets, the entries, the moves and finally the postings
+    struct position_index_header {
+        char magic[8];
+        uint64_t key_count;
+        uint64_t move_count;
+        uint64_t postings_size;
+    };
+
+    // Counts one more game with the half points white scored in it - -1 if the game has no result
+    void position_stats::add_game(int white_half_points) {
+        ++games;
+        white_wins += white_half_points == 2 ? 1 : 0;
+        draws += white_half_points == 1 ? 1 : 0;
+        black_wins += white_half_points == 0 ? 1 : 0;
+    }
+
+    // Packs a move into the two bytes the position index and the opening tree store it in - start square * 64 + end square
+    uint16_t encode_stored_move(const board_move& move) {
+        int start = (move.first.first * DEFAULT_CHESS_BOARD_SIZE) + move.first.second;
+        int end = (move.second.first * DEFAULT_CHESS_BOARD_SIZE) + move.second.second;
+        return static_cast<uint16_t>((start * BOARD_SQUARES) + end);
+    }
+
+    // Unpacks a move packed by encode_stored_move
+    board_move decode_stored_move(uint16_t move) {
+        int start = move / BOARD_SQUARES;
+        int end = move % BOARD_SQUARES;
+        return std::make_pair(std::make_pair(start / DEFAULT_CHESS_BOARD_SIZE, start % DEFAULT_CHESS_BOARD_SIZE),
+            std::make_pair(end / DEFAULT_CHESS_BOARD_SIZE, end % DEFAULT_CHESS_BOARD_SIZE));
+    }
+
+    // Creates a builder holding no games
+    Position_Index_Builder::Position_Index_Builder()
+        : board(Game::make_scratch_board()) {}
+
+    // Adds every position of the game - start_fen is empty for the standard starting position
+    // The moves are trusted rather than validated - they must come from somewhere that checked them such as PGN_Reader
+    void Position_Index_Builder::add_game(uint32_t game_id, const std::string& start_fen, const std::vector<board_move>& moves, int white_half_points) {
+        // Each position is posted with the move the game played from it
+        board.from_fen(start_fen.empty() ? STARTING_POSITION_FEN : start_fen);
+        for (int i = 0; i < moves.size(); ++i) {
+            postings.push_back({board.get_hash_key(), game_id, static_cast<int16_t>(white_half_points), encode_stored_move(moves[i])});
+            board.make_move(moves[i].first, moves[i].second);
+        }
+        postings.push_back({board.get_hash_key(), game_id, static_cast<int16_t>(white_half_points), NO_STORED_MOVE});
+
+        if (game_id >= next_game_id) {
+            next_game_id = game_id + 1;
+        }
+    }
+
+    // Adds every game of the PGN file numbered on from the last game added - returns the number of games added
+    // Games with a move that can't be played are skipped but still take their number so ids always match the order of the file
+    // Throws a runtime_error if the file cannot be opened
+    size_t Position_Index_Builder::add_pgn(const std::string& file_path) {
+        PGN_Reader reader(file_path);
+        size_t added = 0;
+        reader.read_games([this, &added](const pgn_game& game) {
+            uint32_t game_id = next_game_id++;
+            if (!game.error.empty()) {
+                return;
+            }
+
+            add_game(game_id, std::string(game.get_tag("FEN")), game.moves, game.get_white_half_points());
+            ++added;
+        });
+        return added;
+    }
+
+    // Appends value seven bits at a time - the high bit of each byte says another byte follows
+    static void write_varint(uint64_t value, std::vector<unsigned char>& out) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    // Sorts the positions and writes the index to file_path - throws a runtime_error if the file cannot be written
+    // Each position's game ids are stored as the gaps between them so most take a single byte
+    // The moves played from each position follow the entries in the same order - most played first as in the opening tree
+    void Position_Index_Builder::write(const std::string& file_path) {
+        std::sort(postings.begin(), postings.end(), [](const index_posting& first, const index_posting& second) {
+            if (first.key != second.key) {
+                return first.key < second.key;
+            }
+            return first.game_id != second.game_id ? first.game_id < second.game_id : first.move < second.move;
+        });
+
+        std::vector<Position_Index::index_entry> entries;
+        std::vector<Position_Index::index_move> moves;
+        std::vector<unsigned char> game_ids;
+        std::vector<uint64_t> buckets(BUCKET_COUNT + 1, 0);
+        for (size_t i = 0; i < postings.size(); ) {
+            Position_Index::index_entry entry;
+            entry.key = postings[i].key;
+            entry.postings_offset = game_ids.size();
+            entry.moves_offset = moves.size();
+
+            uint32_t last_game_id = 0;
+            for (size_t first = i; i < postings.size() && postings[i].key == entry.key; ++i) {
+                const index_posting& posting = postings[i];
+
+                // A move played again from a position that came back within a game counts once like the position
+                bool repeated_move = i > first && postings[i - 1].game_id == posting.game_id && postings[i - 1].move == posting.move;
+                if (posting.move != NO_STORED_MOVE && !repeated_move) {
+                    size_t m = entry.moves_offset;
+                    while (m < moves.size() && moves[m].move != posting.move) {
+                        ++m;
+                    }
+                    if (m == moves.size()) {
+                        moves.push_back(Position_Index::index_move());
+                        moves[m].move = posting.move;
+                        moves[m].reserved = 0;
+                    }
+                    moves[m].stats.add_game(posting.white_half_points);
+                }
+
+                // A position that came back within a game counts once
+                if (entry.stats.games > 0 && posting.game_id == last_game_id) {
+                    continue;
+                }
+                write_varint(entry.stats.games == 0 ? posting.game_id : posting.game_id - last_game_id, game_ids);
+                last_game_id = posting.game_id;
+                entry.stats.add_game(posting.white_half_points);
+            }
+
+            std::sort(moves.begin() + entry.moves_offset, moves.end(), [](const Position_Index::index_move& first, const Position_Index::index_move& second) {
+                return first.stats.games != second.stats.games ? first.stats.games > second.stats.games : first.move < second.move;
+            });
+            ++buckets[(entry.key >> (64 - BUCKET_BITS)) + 1];
+            entries.push_back(entry);
+        }
+
+        // Each bucket starts where the ones below it end
+        for (size_t b = 1; b <= BUCKET_COUNT; ++b) {
+            buckets[b] += buckets[b - 1];
+        }
+
+        std::ofstream output(file_path, std::ios::binary | std::ios::trunc);
+        if (!output) {
+            throw std::runtime_error("Unable to write the position index to " + file_path);
+        }
+
+        position_index_header header;
+        memcpy(header.magic, POSITION_INDEX_MAGIC, sizeof(POSITION_INDEX_MAGIC));
+        header.key_count = entries.size();
+        header.move_count = moves.size();
+        header.postings_size = game_ids.size();
+        output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char *>(buckets.data()), buckets.size() * sizeof(uint64_t));
+        output.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Position_Index::index_entry));
+        output.write(reinterpret_cast<const char *>(moves.data()), moves.size() * sizeof(Position_Index::index_move));
+        output.write(reinterpret_cast<const char *>(game_ids.data()), game_ids.size());
+        if (!output) {
+            throw std::runtime_error("Unable to write the position index to " + file_path);
+        }
+    }
+
+    // Maps the index at file_path into memory
+    // The sizes in the header are checked against the file so a cut off index is refused rather than read past its end
+    Position_Index::Position_Index(const std::string& file_path) : file(file_path) {
+        const position_index_header * header = reinterpret_cast<const position_index_header *>(file.data());
+        size_t tables_size = sizeof(position_index_header) + ((BUCKET_COUNT + 1) * sizeof(uint64_t));
+        if (file.size() < tables_size || memcmp(header->magic, POSITION_INDEX_MAGIC, sizeof(POSITION_INDEX_MAGIC)) != 0
+            || header->key_count > (file.size() - tables_size) / sizeof(index_entry)
+            || header->move_count > (file.size() - tables_size - (header->key_count * sizeof(index_entry))) / sizeof(index_move)
+            || header->postings_size != file.size() - tables_size - (header->key_count * sizeof(index_entry)) - (header->move_count * sizeof(index_move))) {
+            throw std::runtime_error(file_path + " isn't a position index");
+        }
+
+        key_count = header->key_count;
+        move_count = header->move_count;
+        postings_size = header->postings_size;
+        buckets = reinterpret_cast<const uint64_t *>(file.data() + sizeof(position_index_header));
+        entries = reinterpret_cast<const index_entry *>(file.data() + tables_size);
+        stored_moves = reinterpret_cast<const index_move *>(file.data() + tables_size + (key_count * sizeof(index_entry)));
+        postings = file.data() + tables_size + (key_count * sizeof(index_entry)) + (move_count * sizeof(index_move));
+    }
+
+    // Returns the entry for the key - nullptr if the position isn't in the index
+    // The bucket of the top bits of the key narrows the binary search to the few entries sharing them
+    const Position_Index::index_entry * Position_Index::lookup(uint64_t key) const {
+        size_t bucket = key >> (64 - BUCKET_BITS);
+        const index_entry * first = entries + buckets[bucket];
+        const index_entry * last = entries + buckets[bucket + 1];
+        const index_entry * found = std::lower_bound(first, last, key, [](const index_entry& entry, uint64_t value) {
+            return entry.key < value;
+        });
+        return found != last && found->key == key ? found : nullptr;
+    }
+
+    // Fills in stats for the position with the hash key - returns false if the position isn't in the index
+    bool Position_Index::find(uint64_t key, position_stats& stats) const {
+        const index_entry * entry = lookup(key);
+        if (entry == nullptr) {
+            return false;
+        }
+        stats = entry->stats;
+        return true;
+    }
+
+    // Replaces game_ids with the ids of every game the position was reached in from lowest to highest - returns false if it isn't in the index
+    // Throws a runtime_error if the postings run past the end of the file
+    bool Position_Index::find_games(uint64_t key, std::vector<uint32_t>& game_ids) const {
+        game_ids.clear();
+        const index_entry * entry = lookup(key);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        game_ids.reserve(entry->stats.games);
+        size_t position = entry->postings_offset;
+        uint32_t game_id = 0;
+        for (uint32_t i = 0; i < entry->stats.games; ++i) {
+            uint32_t gap = 0;
+            for (int shift = 0; ; shift += 7) {
+                if (position >= postings_size || shift > 28) {
+                    throw std::runtime_error(INVALID_POSITION_INDEX_ERROR_MSG);
+                }
+                unsigned char byte = postings[position++];
+                gap |= uint32_t(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            game_id = i == 0 ? gap : game_id + gap;
+            game_ids.push_back(game_id);
+        }
+        return true;
+    }
+
+    // Replaces moves with every move played from the position with the hash key - the most played first - returns the number of moves
+    // Throws a runtime_error if the moves of the position run past the end of the file
+    size_t Position_Index::get_moves(uint64_t key, std::vector<position_move>& moves) const {
+        moves.clear();
+        const index_entry * entry = lookup(key);
+        if (entry == nullptr) {
+            return 0;
+        }
+
+        uint64_t moves_end = entry + 1 < entries + key_count ? (entry + 1)->moves_offset : move_count;
+        if (entry->moves_offset > moves_end || moves_end > move_count) {
+            throw std::runtime_error(INVALID_POSITION_INDEX_ERROR_MSG);
+        }
+        for (uint64_t m = entry->moves_offset; m < moves_end; ++m) {
+            position_move move;
+            move.move = decode_stored_move(stored_moves[m].move);
+            move.stats = stored_moves[m].stats;
+            moves.push_back(move);
+        }
+        return moves.size();
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef CPLUSPLUS_CHESS_POSITION_INDEX
+#define CPLUSPLUS_CHESS_POSITION_INDEX
+
+#include <vector>
+#include <string>
+#include <cstdint>      // uint32_t, uint64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Mapped_File.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // What happened in the games a position was reached in
+    struct position_stats {
+        uint32_t games = 0;             // Games the position was reached in - each game counts once however often it came back
+        uint32_t white_wins = 0;
+        uint32_t draws = 0;
+        uint32_t black_wins = 0;        // Games without a result count towards games alone
+
+        // Counts one more game with the half points white scored in it - -1 if the game has no result
+        void add_game(int white_half_points);
+    };
+
+    // A move played from a position with what happened in the games it was played in
+    struct position_move {
+        board_move move;
+        position_stats stats;           // Each game counts once however often the move was played from the position in it
+    };
+
+    // Packs a move into the two bytes the position index and the opening tree store it in - start square * 64 + end square
+    uint16_t encode_stored_move(const board_move& move);
+
+    // Unpacks a move packed by encode_stored_move
+    board_move decode_stored_move(uint16_t move);
+
+    // Gathers every position of a set of games and writes them out as a sorted index that Position_Index can search in place
+    // Every position reached is held in memory until write so the archive indexed at once has to fit - 16 bytes a position
+    class Position_Index_Builder {
+    public:
+        // Creates a builder holding no games
+        Position_Index_Builder();
+
+        // Adds every position of the game - start_fen is empty for the standard starting position
+        // The moves are trusted rather than validated - they must come from somewhere that checked them such as PGN_Reader
+        void add_game(uint32_t game_id, const std::string& start_fen, const std::vector<board_move>& moves, int white_half_points);
+
+        // Adds every game of the PGN file numbered on from the last game added - returns the number of games added
+        // Games with a move that can't be played are skipped but still take their number so ids always match the order of the file
+        // Throws a runtime_error if the file cannot be opened
+        size_t add_pgn(const std::string& file_path);
+
+        // Sorts the positions and writes the index to file_path - throws a runtime_error if the file cannot be written
+        void write(const std::string& file_path);
+
+        // Returns the id the next game of add_pgn will get
+        uint32_t get_next_game_id() const {return next_game_id;}
+
+    private:
+        // One game reaching one position
+        struct index_posting {
+            uint64_t key;               // Hash key of the position
+            uint32_t game_id;
+            int16_t white_half_points;  // Half points white scored - -1 if the game has no result
+            uint16_t move;              // Move the game played next from the position packed by encode_stored_move - NO_STORED_MOVE where it ended
+        };
+
+        std::vector<index_posting> postings;    // Every position of every game added
+        Game board;                             // Replays the games
+        uint32_t next_game_id = 0;
+    };
+
+    // Answers whether a position has been seen, what happened in the games it came from and which moves they played from it
+    // The index file is mapped and searched in place - a lookup reads a handful of cache lines and never copies the file
+    // Throws a runtime_error if the file cannot be opened or isn't a position index
+    class Position_Index {
+    public:
+        // Maps the index at file_path into memory
+        Position_Index(const std::string& file_path);
+
+        // Returns the number of different positions in the index
+        size_t get_position_count() const {return key_count;}
+
+        // Fills in stats for the position with the hash key - returns false if the position isn't in the index
+        bool find(uint64_t key, position_stats& stats) const;
+
+        // Replaces game_ids with the ids of every game the position was reached in from lowest to highest - returns false if it isn't in the index
+        bool find_games(uint64_t key, std::vector<uint32_t>& game_ids) const;
+
+        // Replaces moves with every move played from the position with the hash key - the most played first - returns the number of moves
+        size_t get_moves(uint64_t key, std::vector<position_move>& moves) const;
+
+    private:
+        // Entry for one position - entries are sorted by key
+        struct index_entry {
+            uint64_t key;
+            uint64_t postings_offset;   // Start of the game ids of the position in the postings
+            uint64_t moves_offset;      // First of the moves played from the position - they run up to the next entry's first move
+            position_stats stats;
+        };
+
+        // A move played from the position of an entry
+        struct index_move {
+            uint16_t move;              // Packed by encode_stored_move
+            uint16_t reserved;
+            position_stats stats;
+        };
+
+        // Returns the entry for the key - nullptr if the position isn't in the index
+        const index_entry * lookup(uint64_t key) const;
+
+        Mapped_File file;                       // Index being searched
+        const uint64_t * buckets = nullptr;     // First entry for each value of the top 16 bits of a key - one more than there are values
+        const index_entry * entries = nullptr;
+        const index_move * stored_moves = nullptr;
+        const unsigned char * postings = nullptr;
+        size_t key_count = 0;
+        size_t move_count = 0;
+        size_t postings_size = 0;
+
+        friend class Position_Index_Builder;
+    };
+}
+
+#endif
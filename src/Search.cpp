@@ -0,0 +1,557 @@
+#include "Search.h"
+#include "Evaluation.h"
+#include "Human_Player.h"
+
+#include <sstream>      // std::ostringstream
+#include <iomanip>      // std::setprecision
+#include <algorithm>    // std::find, std::stable_sort
+
+namespace Chess_API {
+    static const int INFINITE_SCORE = MATE_SCORE + 1;   // Wider than any score the search can return
+    static const uint64_t NODES_BETWEEN_CHECKS = 256;   // How often the clock and the stop flag are looked at
+    static const int NULL_MOVE_MIN_DEPTH = 3;           // Shallowest depth a null move is tried at
+    static const int NULL_MOVE_REDUCTION = 2;           // Extra plies taken off the search after a null move
+
+    // Converts a move into the {char}{num}{char}{num} format of the info lines - for example e2e4
+    std::string move_to_string(const board_move& move) {
+        std::string text;
+        text += VALID_CHARS.at(move.first.second);
+        text += VALID_NUMS.at(move.first.first);
+        text += VALID_CHARS.at(move.second.second);
+        text += VALID_NUMS.at(move.second.first);
+        return text;
+    }
+
+    // Mate scores are stored relative to the position rather than the root so they stay correct when reached at another ply
+    static int score_to_table(int score, int ply) {
+        if (score > MATE_SCORE - MAX_SEARCH_PLY) {
+            return score + ply;
+        } else if (score < -MATE_SCORE + MAX_SEARCH_PLY) {
+            return score - ply;
+        }
+        return score;
+    }
+
+    // Converts a stored score back to be relative to the root
+    static int score_from_table(int score, int ply) {
+        if (score > MATE_SCORE - MAX_SEARCH_PLY) {
+            return score - ply;
+        } else if (score < -MATE_SCORE + MAX_SEARCH_PLY) {
+            return score + ply;
+        }
+        return score;
+    }
+
+    // The table is shared with whoever else searches for the same player - bitbases may be nullptr
+    Searcher::Searcher(std::shared_ptr<Transposition_Table> table_in, std::shared_ptr<const Bitbase_Set> bitbases_in)
+        : table(table_in), bitbases(bitbases_in), stop_requested(false), deadline_ms(0), token(nullptr) {}
+
+    // Stops the running search as soon as possible - the last completed iteration is returned - safe to call from any thread
+    void Searcher::stop() {
+        stop_requested = true;
+    }
+
+    // Replaces the running searches time limit with move_time_ms from now - safe to call from any thread
+    void Searcher::set_move_time(int move_time_ms) {
+        deadline_ms = move_time_ms > 0 ? steady_time_ms() + move_time_ms : 0;
+    }
+
+    // Replaces the token the running search watches - safe to call from any thread - the token must outlive the search
+    void Searcher::set_token(const Cancellation_Token * token_in) {
+        token = token_in;
+    }
+
+    // Counts the node and checks the limits every so often - returns true once the search has to stop
+    // A stop or a cancelled token ends any iteration - the deadline and the node limit let the first iteration finish so the move played was searched
+    bool Searcher::check_limits() {
+        ++nodes;
+        if (stopped) {
+            return stopped;
+        }
+
+        bool first_iteration = iteration_depth <= 1;
+        if (!first_iteration && node_limit != 0 && nodes >= node_limit) {
+            stopped = true;
+        } else if (nodes % NODES_BETWEEN_CHECKS == 0) {
+            int64_t deadline = deadline_ms;
+            const Cancellation_Token * search_token = token;
+            if (stop_requested || (search_token != nullptr && search_token->is_cancelled())) {
+                stopped = true;
+            } else if (!first_iteration && ((deadline != 0 && steady_time_ms() >= deadline) || (search_token != nullptr && search_token->is_past_deadline()))) {
+                stopped = true;
+            }
+        }
+        return stopped;
+    }
+
+    // Searches the position within the limits and returns the best move found
+    search_result Searcher::search(const Game& root_game, const search_limits& limits) {
+        prepare(limits);
+        return run(root_game);
+    }
+
+    // Readies the limits for the next run - lets another thread stop or re-time a search before it has started
+    void Searcher::prepare(const search_limits& limits) {
+        stop_requested = false;
+        node_limit = limits.nodes;
+        max_depth = limits.depth > 0 ? limits.depth : MAX_SEARCH_PLY - 1;
+        set_move_time(limits.move_time_ms);
+        token = limits.token;
+        on_info = limits.on_info;
+        on_iteration = limits.on_iteration;
+        multi_pv = limits.multi_pv > 1 ? limits.multi_pv : 1;
+        allowed_root_moves = limits.root_moves;
+    }
+
+    // Runs the search readied by prepare and returns the best move found
+    search_result Searcher::run(const Game& root_game) {
+        search_result result;
+
+        // The root is copied into a game kept between searches so its board and pieces are reused rather than allocated every turn
+        // Stand-in players take the place of the callers so the searcher never keeps them alive
+        if (search_game == nullptr) {
+            search_players[0].reset(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+            search_players[1].reset(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            search_game.reset(new Game(root_game));
+        } else {
+            *search_game = root_game;
+        }
+        search_game->set_players(search_players[0], search_players[1]);
+        Game& game = *search_game;
+
+        // The game state the search relies on for check is only kept up to date by update_game_state
+        game.update_game_state();
+
+        stopped = false;
+        nodes = 0;
+        statistics = search_statistics();
+        int64_t start_ms = steady_time_ms();
+
+        root_in_bitbase = bitbases != nullptr && bitbases->probe(game) != BITBASE_INVALID;
+
+        // Everything the search needs from here on is carved from the arena - the last turn's memory is reused
+        arena.reset();
+        board_move * root_moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+        board_move * line = arena.allocate_array<board_move>(MAX_SEARCH_PLY);
+
+        int root_move_count = game.get_valid_moves(root_moves);
+        if (!allowed_root_moves.empty()) {
+            int allowed_count = 0;
+            for (int i = 0; i < root_move_count; ++i) {
+                if (std::find(allowed_root_moves.begin(), allowed_root_moves.end(), root_moves[i]) != allowed_root_moves.end()) {
+                    root_moves[allowed_count++] = root_moves[i];
+                }
+            }
+            root_move_count = allowed_count;
+        }
+        if (root_move_count == 0) {
+            deadline_ms = 0;
+            token = nullptr;
+            on_info = nullptr;
+            on_iteration = nullptr;
+            return result;
+        }
+
+        // Always have a move ready - the first iteration runs past the deadline and the node limit so this move only goes unsearched after a stop or a cancel
+        // Neither of those plays the move - a stopped ponder search is thrown away and a cancelled turn throws instead
+        result.best_move = root_moves[0];
+
+        board_move no_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        for (int i = 0; i < MAX_SEARCH_PLY; ++i) {
+            for (int j = 0; j < KILLER_MOVES_PER_PLY; ++j) {
+                killers[i][j] = no_move;
+            }
+        }
+
+        // Never more lines than there are moves to start them with
+        int line_count = multi_pv < root_move_count ? multi_pv : root_move_count;
+        uint64_t root_key = game.get_hash_key();
+        std::vector<search_line> iteration_lines;
+        iteration_lines.reserve(line_count);
+        statistics.iteration_ms.reserve(max_depth);
+
+        for (int depth = 1; depth <= max_depth; ++depth) {
+            iteration_depth = depth;
+            int64_t iteration_start_ms = steady_time_ms();
+            iteration_lines.clear();
+            excluded_root_moves.clear();
+
+            // Each further line searches the root again without the moves that already lead a line - the table makes the repeat searches cheap
+            for (int i = 0; i < line_count && !stopped; ++i) {
+                root_best_move = i == 0 ? result.best_move : no_move;
+                int score = negamax(game, depth, -INFINITE_SCORE, INFINITE_SCORE, 0);
+                if (stopped) {
+                    break;
+                }
+
+                search_line found_line;
+                found_line.move = root_best_move;
+                found_line.score = score;
+                found_line.depth = depth;
+                iteration_lines.push_back(found_line);
+                excluded_root_moves.push_back(root_best_move);
+            }
+
+            // An unfinished iteration is thrown away - the previous iteration's lines are kept
+            if (stopped) {
+                break;
+            }
+
+            // Later lines can outscore earlier ones once the table knows more - the root entry is left with the best line
+            if (iteration_lines.size() > 1) {
+                std::stable_sort(iteration_lines.begin(), iteration_lines.end(), [](const search_line& first, const search_line& second) {
+                    return first.score > second.score;
+                });
+            }
+            excluded_root_moves.clear();
+            table->store(root_key, depth, score_to_table(iteration_lines[0].score, 0), TT_EXACT,
+                position_to_square(iteration_lines[0].move.first), position_to_square(iteration_lines[0].move.second));
+
+            // Each line is followed through the table from the position after its first move
+            bool all_mates = true;
+            for (int i = 0; i < iteration_lines.size(); ++i) {
+                search_line& found_line = iteration_lines[i];
+                Game::move_record record = game.make_move(found_line.move.first, found_line.move.second);
+                int max_length = depth < MAX_SEARCH_PLY ? depth - 1 : MAX_SEARCH_PLY - 1;
+                int line_length = extract_principal_variation(game, line, max_length);
+                game.unmake_move(record);
+
+                found_line.principal_variation.assign(1, found_line.move);
+                found_line.principal_variation.insert(found_line.principal_variation.end(), line, line + line_length);
+                if (found_line.score <= MATE_SCORE - MAX_SEARCH_PLY && found_line.score >= -MATE_SCORE + MAX_SEARCH_PLY) {
+                    all_mates = false;
+                }
+            }
+
+            result.lines = iteration_lines;
+            result.best_move = iteration_lines[0].move;
+            result.score = iteration_lines[0].score;
+            result.depth = depth;
+            result.principal_variation = iteration_lines[0].principal_variation;
+            statistics.depth = depth;
+            statistics.iteration_ms.push_back(steady_time_ms() - iteration_start_ms);
+
+            if (on_info || on_iteration) {
+                finish_statistics(start_ms);
+                result.nodes = nodes;
+                result.statistics = statistics;
+                for (int i = 0; on_info && i < result.lines.size(); ++i) {
+                    on_info(format_search_info(result, i));
+                }
+                if (on_iteration) {
+                    on_iteration(result);
+                }
+            }
+
+            // Nothing more to learn once every line ends in a forced mate
+            if (all_mates) {
+                break;
+            }
+        }
+
+        if (result.principal_variation.empty()) {
+            result.principal_variation.assign(1, result.best_move);
+        }
+        if (result.principal_variation.size() > 1) {
+            result.ponder_move = result.principal_variation[1];
+        }
+        finish_statistics(start_ms);
+        result.nodes = nodes;
+        result.statistics = statistics;
+        deadline_ms = 0;
+        token = nullptr;
+        on_info = nullptr;
+        on_iteration = nullptr;
+        return result;
+    }
+
+    // Fills in the rates and timings of the statistics gathered so far
+    void Searcher::finish_statistics(int64_t start_ms) {
+        statistics.nodes = nodes;
+        statistics.elapsed_ms = steady_time_ms() - start_ms;
+
+        double seconds = statistics.elapsed_ms > 0 ? statistics.elapsed_ms / 1000.0 : 0.001;
+        statistics.nodes_per_second = nodes / seconds;
+        statistics.table_hit_rate = statistics.table_probes == 0 ? 0.0 : double(statistics.table_hits) / statistics.table_probes;
+        statistics.first_move_cutoff_rate = statistics.cutoffs == 0 ? 0.0 : double(statistics.first_move_cutoffs) / statistics.cutoffs;
+        statistics.null_move_success_rate = statistics.null_move_tries == 0 ? 0.0 : double(statistics.null_move_cutoffs) / statistics.null_move_tries;
+    }
+
+    // Negamax alpha-beta - returns the score of the position from the perspective of the current player
+    // allow_null is cleared straight after a null move so two passes are never played in a row
+    int Searcher::negamax(Game& game, int depth, int alpha, int beta, int ply, bool allow_null) {
+        if (check_limits()) {
+            return 0;
+        }
+
+        if (ply > statistics.selective_depth) {
+            statistics.selective_depth = ply;
+        }
+
+        // A repeated position is scored as a draw at once - repeating it twice more can't be stopped by either side if it was good for them
+        if (ply > 0 && (game.get_halfmove_clock() >= FIFTY_MOVE_RULE_HALFMOVES || game.is_repetition(1))) {
+            return 0;
+        }
+
+        bool in_check = game.get_current_game_state() == Game::CHECK;
+
+        // Never stop searching while in check - there may be no quiet position to evaluate
+        if (in_check && ply < MAX_SEARCH_PLY - 1) {
+            ++depth;
+        }
+
+        if (depth <= 0 || ply >= MAX_SEARCH_PLY - 1) {
+            return quiescence(game, alpha, beta, ply);
+        }
+
+        uint64_t key = game.get_hash_key();
+        board_move hash_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        tt_entry entry;
+        ++statistics.table_probes;
+        if (table->probe(key, entry)) {
+            ++statistics.table_hits;
+            if (entry.start_square != 255) {
+                hash_move = std::make_pair(square_to_position(entry.start_square), square_to_position(entry.end_square));
+            }
+
+            if (ply > 0 && entry.depth >= depth) {
+                int table_score = score_from_table(entry.score, ply);
+                if (entry.bound == TT_EXACT
+                    || (entry.bound == TT_LOWER && table_score >= beta)
+                    || (entry.bound == TT_UPPER && table_score <= alpha)) {
+                    return table_score;
+                }
+            }
+        }
+
+        // Endgames covered by a bitbase are known without searching - the evaluation still guides the winning side forward
+        // Once the root itself is covered every move left to search keeps the same result so the search is left to find the way through
+        if (ply > 0 && bitbases != nullptr && !root_in_bitbase) {
+            BITBASE_RESULT bitbase_result = bitbases->probe(game);
+            if (bitbase_result == BITBASE_WIN) {
+                return KNOWN_WIN_SCORE + evaluate(game);
+            } else if (bitbase_result == BITBASE_LOSS) {
+                return -KNOWN_WIN_SCORE + evaluate(game);
+            } else if (bitbase_result == BITBASE_DRAW) {
+                return 0;
+            }
+        }
+
+        // Null move pruning - if the position still holds above beta after passing then a real move will almost always do as well
+        // Not tried in check or without pieces other than pawns where passing may really be the best move
+        if (allow_null && ply > 0 && !in_check && depth >= NULL_MOVE_MIN_DEPTH && beta < MATE_SCORE - MAX_SEARCH_PLY
+            && game.has_non_pawn_material() && evaluate(game) >= beta) {
+            ++statistics.null_move_tries;
+            Game::move_record record = game.make_null_move();
+            int score = -negamax(game, depth - 1 - NULL_MOVE_REDUCTION, -beta, -beta + 1, ply + 1, false);
+            game.unmake_null_move(record);
+
+            if (stopped) {
+                return 0;
+            }
+
+            // A mate found after passing isn't proven for the real moves so only beta is returned
+            if (score >= beta) {
+                ++statistics.null_move_cutoffs;
+                return beta;
+            }
+        }
+
+        // The move lists live in the arena until this ply returns
+        Arena_Scope scope(arena);
+        Move_Picker picker(game, arena, hash_move, killers[ply], true);
+
+        int original_alpha = alpha;
+        int best_score = -INFINITE_SCORE;
+        board_move best_move;
+        board_move move;
+        int moves_searched = 0;
+
+        while (picker.next(move)) {
+            // Moves already leading a line of a multi-PV search are left out at the root as are moves the search wasn't allowed
+            if (ply == 0 && (std::find(excluded_root_moves.begin(), excluded_root_moves.end(), move) != excluded_root_moves.end()
+                || (!allowed_root_moves.empty() && std::find(allowed_root_moves.begin(), allowed_root_moves.end(), move) == allowed_root_moves.end()))) {
+                continue;
+            }
+
+            Game::move_record record = game.make_move(move.first, move.second);
+            table->prefetch(game.get_hash_key());
+            int score = -negamax(game, depth - 1, -beta, -alpha, ply + 1);
+            game.unmake_move(record);
+            ++moves_searched;
+
+            if (stopped) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                best_move = move;
+
+                if (score > alpha) {
+                    alpha = score;
+                    if (ply == 0) {
+                        root_best_move = move;
+                    }
+                }
+
+                if (alpha >= beta) {
+                    ++statistics.cutoffs;
+                    if (moves_searched == 1) {
+                        ++statistics.first_move_cutoffs;
+                    }
+                    if (!game.is_capture_or_promotion(move)) {
+                        store_killer(move, ply);
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (moves_searched == 0) {
+            return in_check ? -MATE_SCORE + ply : 0;
+        }
+
+        TT_BOUND bound = best_score >= beta ? TT_LOWER : (best_score > original_alpha ? TT_EXACT : TT_UPPER);
+        table->store(key, depth, score_to_table(best_score, ply), bound, position_to_square(best_move.first), position_to_square(best_move.second));
+
+        return best_score;
+    }
+
+    // Searches captures only until the position is quiet so the evaluation isn't taken in the middle of an exchange
+    int Searcher::quiescence(Game& game, int alpha, int beta, int ply) {
+        if (check_limits()) {
+            return 0;
+        }
+
+        ++statistics.quiescence_nodes;
+        if (ply > statistics.selective_depth) {
+            statistics.selective_depth = ply;
+        }
+
+        bool in_check = game.get_current_game_state() == Game::CHECK;
+
+        // Standing pat - the current player can usually do at least as well as the position is now by not capturing
+        if (!in_check) {
+            int stand_pat = evaluate(game);
+            if (stand_pat >= beta || ply >= MAX_SEARCH_PLY - 1) {
+                return stand_pat;
+            }
+            if (stand_pat > alpha) {
+                alpha = stand_pat;
+            }
+        }
+
+        // Every escape is searched when in check - otherwise only captures
+        Arena_Scope scope(arena);
+        Move_Picker picker(game, arena, std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1)), nullptr, in_check);
+
+        int best_score = in_check ? -MATE_SCORE + ply : alpha;
+        board_move move;
+        while (picker.next(move)) {
+            Game::move_record record = game.make_move(move.first, move.second);
+            int score = -quiescence(game, -beta, -alpha, ply + 1);
+            game.unmake_move(record);
+
+            if (stopped) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                if (score > alpha) {
+                    alpha = score;
+                }
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+
+        return best_score;
+    }
+
+    // Remembers a quiet move that caused a cutoff so it is tried early in sibling positions
+    void Searcher::store_killer(const board_move& move, int ply) {
+        if (killers[ply][0] == move) {
+            return;
+        }
+        for (int i = KILLER_MOVES_PER_PLY - 1; i > 0; --i) {
+            killers[ply][i] = killers[ply][i - 1];
+        }
+        killers[ply][0] = move;
+    }
+
+    // Walks the hash moves from the root to recover the expected line of play - writes up to max_length moves into line and returns how many
+    // The moves are played on game and taken back again so no copy of the game is needed
+    int Searcher::extract_principal_variation(Game& game, board_move * line, int max_length) const {
+        Game::move_record records[MAX_SEARCH_PLY];
+        int line_length = 0;
+
+        while (line_length < max_length) {
+            tt_entry entry;
+            if (!table->probe(game.get_hash_key(), entry) || entry.start_square == 255) {
+                break;
+            }
+
+            board_move move = std::make_pair(square_to_position(entry.start_square), square_to_position(entry.end_square));
+
+            // A different position sharing the slot could hand back a move that isn't playable here
+            if (game.is_valid_move(move.first, move.second) != Game::VALID_MOVE) {
+                break;
+            }
+
+            line[line_length] = move;
+            records[line_length] = game.make_move(move.first, move.second);
+            ++line_length;
+        }
+
+        for (int i = line_length - 1; i >= 0; --i) {
+            game.unmake_move(records[i]);
+        }
+
+        return line_length;
+    }
+
+    // Builds the one line summary of a search result - depth, score, statistics and the principal variation
+    // line_index picks which of the results lines is summarised - a multi-PV search numbers its lines from 1
+    // Mate scores are given in moves - negative when the searching player is the one being mated
+    std::string format_search_info(const search_result& result, int line_index) {
+        const search_statistics& statistics = result.statistics;
+        bool has_line = line_index >= 0 && line_index < result.lines.size();
+        int depth = has_line ? result.lines[line_index].depth : result.depth;
+        int score = has_line ? result.lines[line_index].score : result.score;
+        const std::vector<board_move>& principal_variation = has_line ? result.lines[line_index].principal_variation : result.principal_variation;
+
+        std::ostringstream info;
+        info << "info depth " << depth << " seldepth " << statistics.selective_depth;
+        if (result.lines.size() > 1) {
+            info << " multipv " << line_index + 1;
+        }
+
+        if (score > MATE_SCORE - MAX_SEARCH_PLY) {
+            info << " score mate " << (MATE_SCORE - score + 1) / 2;
+        } else if (score < -MATE_SCORE + MAX_SEARCH_PLY) {
+            info << " score mate -" << (MATE_SCORE + score) / 2;
+        } else {
+            info << " score cp " << score;
+        }
+
+        int64_t iteration_ms = statistics.iteration_ms.empty() ? 0 : statistics.iteration_ms.back();
+        info << " nodes " << statistics.nodes << " qnodes " << statistics.quiescence_nodes
+             << " nps " << static_cast<uint64_t>(statistics.nodes_per_second)
+             << " time " << statistics.elapsed_ms << " itertime " << iteration_ms
+             << std::fixed << std::setprecision(1)
+             << " tthit " << statistics.table_hit_rate * 100.0
+             << " fmc " << statistics.first_move_cutoff_rate * 100.0
+             << " nullcut " << statistics.null_move_success_rate * 100.0;
+
+        if (!principal_variation.empty()) {
+            info << " pv";
+            for (int i = 0; i < principal_variation.size(); ++i) {
+                info << " " << move_to_string(principal_variation[i]);
+            }
+        }
+        return info.str();
+    }
+}
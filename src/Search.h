@@ -0,0 +1,177 @@
+#ifndef CPLUSPLUS_CHESS_SEARCH
+#define CPLUSPLUS_CHESS_SEARCH
+
+#include <vector>
+#include <string>
+#include <functional>   // std::function
+#include <memory>       // std::shared_ptr
+#include <atomic>       // std::atomic
+#include <cstdint>      // uint64_t
+
+#include "Game.h"
+#include "Bitbase.h"
+#include "Transposition_Table.h"
+#include "Cancellation_Token.h"
+#include "Search_Arena.h"
+#include "Move_Picker.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    const int MATE_SCORE = 100000;          // Score for delivering checkmate - reduced by the plies it takes to get there
+    const int KNOWN_WIN_SCORE = 20000;      // Score for a bitbase win - below any mate so real mates are still preferred
+    const int MAX_SEARCH_PLY = 64;          // Deepest ply the search will ever reach including captures
+
+    // Called on the searching thread with a one line summary after every completed iteration
+    typedef std::function<void(const std::string&)> search_info_callback;
+
+    // Called on the searching thread with the result so far after every completed iteration
+    struct search_result;
+    typedef std::function<void(const search_result&)> search_iteration_callback;
+
+    // Limits placed on a single search - a value of 0 means that limit isn't used
+    struct search_limits {
+        int depth = 0;              // Deepest iteration to search
+        int move_time_ms = 0;       // Milliseconds allowed for the search
+        uint64_t nodes = 0;         // Positions allowed to be visited
+        const Cancellation_Token * token = nullptr;     // Stops the search once cancelled or past its deadline - must outlive the search
+        search_info_callback on_info;                   // Receives the info line of each iteration - may be empty
+        search_iteration_callback on_iteration;         // Receives the result of each iteration - may be empty
+        int multi_pv = 1;                               // Number of best moves to find a line for
+        std::vector<board_move> root_moves;             // Only these moves are searched at the root - empty searches every move
+    };
+
+    // Counters describing how a search went - charted to catch performance regressions
+    // Rates are fractions from 0 to 1 and are 0 when nothing was counted
+    struct search_statistics {
+        uint64_t nodes = 0;                 // Positions visited including the quiescence search
+        uint64_t quiescence_nodes = 0;      // Positions visited by the quiescence search
+        double nodes_per_second = 0.0;
+        int depth = 0;                      // Deepest completed iteration
+        int selective_depth = 0;            // Deepest ply reached once checks and captures are followed
+        uint64_t table_probes = 0;          // Transposition table lookups
+        uint64_t table_hits = 0;            // Lookups that found the position
+        double table_hit_rate = 0.0;
+        uint64_t cutoffs = 0;               // Moves that failed high
+        uint64_t first_move_cutoffs = 0;    // Fail highs on the first move searched - how good the move ordering is
+        double first_move_cutoff_rate = 0.0;
+        uint64_t null_move_tries = 0;       // Null moves searched
+        uint64_t null_move_cutoffs = 0;     // Null moves that held the position above beta
+        double null_move_success_rate = 0.0;
+        std::vector<int64_t> iteration_ms;  // Milliseconds taken by each completed iteration
+        int64_t elapsed_ms = 0;             // Milliseconds taken by the whole search
+    };
+
+    // One of the best moves at the root with the line of play expected to follow it
+    struct search_line {
+        board_move move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));
+        int score = 0;                                  // Score of the move from the perspective of the searching player
+        int depth = 0;                                  // Depth the move was searched to
+        std::vector<board_move> principal_variation;    // Expected line of play starting with move
+    };
+
+    // The outcome of a search
+    struct search_result {
+        board_move best_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));     // Best move found - {-1, -1} positions if there was no move
+        board_move ponder_move = std::make_pair(std::make_pair(-1, -1), std::make_pair(-1, -1));   // Expected reply to the best move - {-1, -1} positions if unknown
+        std::vector<board_move> principal_variation;    // Expected line of play starting with best_move
+        int score = 0;                                  // Score of best_move from the perspective of the searching player
+        int depth = 0;                                  // Deepest completed iteration
+        uint64_t nodes = 0;                             // Positions visited
+        search_statistics statistics;                   // How the search went
+        std::vector<search_line> lines;                 // Best moves from best to worst - one for each of multi_pv - the first leads with best_move
+    };
+
+    // Builds the one line summary of a search result - depth, score, statistics and the principal variation
+    // line_index picks which of the results lines is summarised - a multi-PV search numbers its lines from 1
+    std::string format_search_info(const search_result& result, int line_index = 0);
+
+    // Converts a move into the {char}{num}{char}{num} format of the info lines - for example e2e4
+    std::string move_to_string(const board_move& move);
+
+    // Iterative deepening alpha-beta search over Game - moves come from Game so the search always plays by the games rules
+    // A search runs on the calling thread but may be stopped or given a deadline from any other thread
+    // With multi_pv above 1 every iteration searches the root once per line leaving out the moves that already lead a line
+    class Searcher {
+    public:
+        // The table is shared with whoever else searches for the same player - bitbases may be nullptr
+        Searcher(std::shared_ptr<Transposition_Table> table_in, std::shared_ptr<const Bitbase_Set> bitbases_in);
+
+        // Searches the position within the limits and returns the best move found
+        search_result search(const Game& root_game, const search_limits& limits);
+
+        // Readies the limits for the next run - lets another thread stop or re-time a search before it has started
+        void prepare(const search_limits& limits);
+
+        // Runs the search readied by prepare and returns the best move found
+        search_result run(const Game& root_game);
+
+        // Stops the running search as soon as possible - the last completed iteration is returned - safe to call from any thread
+        void stop();
+
+        // Replaces the running searches time limit with move_time_ms from now - safe to call from any thread
+        void set_move_time(int move_time_ms);
+
+        // Replaces the token the running search watches - safe to call from any thread - the token must outlive the search
+        void set_token(const Cancellation_Token * token_in);
+
+        // Replaces the bitbases probed inside the search - nullptr disables probing - not safe while searching
+        void set_bitbases(std::shared_ptr<const Bitbase_Set> bitbases_in) {bitbases = bitbases_in;}
+
+    private:
+        // Negamax alpha-beta - returns the score of the position from the perspective of the current player
+        // allow_null is cleared straight after a null move so two passes are never played in a row
+        int negamax(Game& game, int depth, int alpha, int beta, int ply, bool allow_null = true);
+
+        // Searches captures only until the position is quiet so the evaluation isn't taken in the middle of an exchange
+        int quiescence(Game& game, int alpha, int beta, int ply);
+
+        // Remembers a quiet move that caused a cutoff so it is tried early in sibling positions
+        void store_killer(const board_move& move, int ply);
+
+        // Counts the node and checks the limits every so often - returns true once the search has to stop
+        bool check_limits();
+
+        // Fills in the rates and timings of the statistics gathered so far
+        void finish_statistics(int64_t start_ms);
+
+        // Walks the hash moves from the root to recover the expected line of play - writes up to max_length moves into line and returns how many
+        // The moves are played on game and taken back again so no copy of the game is needed
+        int extract_principal_variation(Game& game, board_move * line, int max_length) const;
+
+        std::shared_ptr<Transposition_Table> table;     // Results shared between searches
+        std::shared_ptr<const Bitbase_Set> bitbases;    // Endgame bitbases probed inside the search
+
+        std::atomic<bool> stop_requested;               // Set by stop - checked by the search
+        std::atomic<int64_t> deadline_ms;               // Steady clock time the search must finish by - 0 for no deadline
+        std::atomic<const Cancellation_Token *> token;  // Token of whoever asked for the search - nullptr if there is none
+        bool stopped = false;                           // Set once the running search has hit a limit
+        uint64_t node_limit = 0;                        // Node limit of the running search
+        int max_depth = 0;                              // Deepest iteration of the running search
+        uint64_t nodes = 0;                             // Nodes visited by the running search
+        search_statistics statistics;                   // Counters of the running search
+        search_info_callback on_info;                   // Receives the info line of each iteration of the running search
+        search_iteration_callback on_iteration;         // Receives the result of each iteration of the running search
+        int multi_pv = 1;                               // Lines wanted by the running search
+        std::vector<board_move> excluded_root_moves;    // Root moves that already lead a line in the running iteration
+        std::vector<board_move> allowed_root_moves;     // Root moves the running search is limited to - empty allows every move
+        bool root_in_bitbase = false;                   // Set when a bitbase covers the root - the bitbases aren't probed inside the tree then
+        int iteration_depth = 0;                        // Depth of the running iteration
+        board_move root_best_move;                      // Best move found so far in the running iteration
+        Search_Arena arena;                             // Scratch memory of the running search - reset at the start of every run
+        std::unique_ptr<Game> search_game;              // Copy of the root the search plays its moves on - kept between searches so it is never allocated again
+        std::shared_ptr<Player> search_players[2];      // White and black stand-ins for the players of search_game
+        board_move killers[MAX_SEARCH_PLY][KILLER_MOVES_PER_PLY];   // Quiet moves that caused cutoffs at each ply of the running search
+    };
+
+    // Converts a board position into a square number - x * 8 + y
+    inline uint8_t position_to_square(const std::pair<int, int>& position) {
+        return static_cast<uint8_t>((position.first * DEFAULT_CHESS_BOARD_SIZE) + position.second);
+    }
+
+    // Converts a square number back into a board position
+    inline std::pair<int, int> square_to_position(uint8_t square) {
+        return std::make_pair(square / DEFAULT_CHESS_BOARD_SIZE, square % DEFAULT_CHESS_BOARD_SIZE);
+    }
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "Search_Arena.h"
+
+#include <cstdint>      // uintptr_t
+
+namespace Chess_API {
+    // Rounds the address up to the next multiple of alignment - alignment must be a power of two
+    static size_t align_offset(const char * base, size_t offset, size_t alignment) {
+        uintptr_t address = reinterpret_cast<uintptr_t>(base + offset);
+        uintptr_t aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        return offset + (aligned - address);
+    }
+
+    // Creates an arena whose first block holds block_size bytes - the block is only allocated once it is needed
+    Search_Arena::Search_Arena(size_t block_size) : block_size(block_size == 0 ? DEFAULT_SEARCH_ARENA_BYTES : block_size) {}
+
+    // Returns bytes of memory aligned to alignment - a new block is added if the current blocks are full
+    void* Search_Arena::allocate(size_t bytes, size_t alignment) {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+
+        // Move through the blocks kept from earlier plies before asking the heap for another
+        while (current_block < blocks.size()) {
+            arena_block& block = blocks[current_block];
+            size_t start = align_offset(block.memory.get(), current_offset, alignment);
+            if (start + bytes <= block.size) {
+                current_offset = start + bytes;
+                return block.memory.get() + start;
+            }
+
+            ++current_block;
+            current_offset = 0;
+        }
+
+        add_block(bytes, alignment);
+        arena_block& block = blocks[current_block];
+        size_t start = align_offset(block.memory.get(), 0, alignment);
+        current_offset = start + bytes;
+        return block.memory.get() + start;
+    }
+
+    // Returns the current point in the arena
+    Search_Arena::marker Search_Arena::get_marker() const {
+        marker current;
+        current.block = current_block;
+        current.offset = current_offset;
+        return current;
+    }
+
+    // Releases everything allocated since the marker was taken - the memory stays with the arena for reuse
+    void Search_Arena::rewind(const marker& to) {
+        current_block = to.block;
+        current_offset = to.offset;
+    }
+
+    // Releases everything in the arena - when the last search needed more than one block they are merged
+    // into a single block so the next search fits without adding blocks
+    void Search_Arena::reset() {
+        if (blocks.size() > 1) {
+            size_t total = get_capacity();
+            blocks.clear();
+            add_block(total, 1);
+        }
+
+        current_block = 0;
+        current_offset = 0;
+    }
+
+    // Returns the total bytes held by the arena
+    size_t Search_Arena::get_capacity() const {
+        size_t total = 0;
+        for (int i = 0; i < blocks.size(); ++i) {
+            total += blocks[i].size;
+        }
+        return total;
+    }
+
+    // Adds a block large enough for bytes aligned to alignment
+    void Search_Arena::add_block(size_t bytes, size_t alignment) {
+        arena_block block;
+        // Aligning the start of the block can skip at most alignment - 1 bytes
+        size_t needed = bytes + alignment - 1;
+        block.size = needed > block_size ? needed : block_size;
+        block.memory.reset(new char[block.size]);
+        blocks.push_back(std::move(block));
+        current_block = blocks.size() - 1;
+        current_offset = 0;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef CPLUSPLUS_CHESS_SEARCH_ARENA
+#define CPLUSPLUS_CHESS_SEARCH_ARENA
+
+#include <vector>
+#include <memory>       // std::unique_ptr
+#include <cstddef>      // size_t
+#include <type_traits>  // std::is_trivially_destructible
+
+namespace Chess_API {
+    // Bytes in the first block of a search arena - enough for every move list of a deep search
+    const size_t DEFAULT_SEARCH_ARENA_BYTES = size_t(1) << 16;
+
+    // Bump allocator handing out the scratch memory of a single search - move lists, scores and lines of play
+    // Memory is never given back one allocation at a time - a search rewinds to a marker when a ply is done and resets once per turn
+    // After the first few searches the arena has grown large enough that a search never reaches the global heap
+    class Search_Arena {
+    public:
+        // A point in the arena that can be rewound to - everything allocated after it is released together
+        struct marker {
+            size_t block = 0;   // Block in use when the marker was taken
+            size_t offset = 0;  // Bytes used in that block
+        };
+
+        // Creates an arena whose first block holds block_size bytes - the block is only allocated once it is needed
+        Search_Arena(size_t block_size = DEFAULT_SEARCH_ARENA_BYTES);
+
+        // Blocks are owned by the arena and therefore it cannot be copied
+        Search_Arena(const Search_Arena&) = delete;
+        Search_Arena& operator=(const Search_Arena&) = delete;
+
+        // Returns bytes of memory aligned to alignment - a new block is added if the current blocks are full
+        void* allocate(size_t bytes, size_t alignment);
+
+        // Returns room for count objects of type T - the objects are left uninitialized and are never destroyed
+        template <typename T>
+        T* allocate_array(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "Search_Arena never runs destructors");
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        // Returns the current point in the arena
+        marker get_marker() const;
+
+        // Releases everything allocated since the marker was taken - the memory stays with the arena for reuse
+        void rewind(const marker& to);
+
+        // Releases everything in the arena - when the last search needed more than one block they are merged
+        // into a single block so the next search fits without adding blocks
+        void reset();
+
+        // Returns the total bytes held by the arena
+        size_t get_capacity() const;
+
+        // Returns the number of blocks held by the arena
+        size_t get_block_count() const {return blocks.size();}
+
+    private:
+        // A single allocation from the global heap
+        struct arena_block {
+            std::unique_ptr<char[]> memory;     // The memory itself
+            size_t size = 0;                    // Bytes in memory
+        };
+
+        // Adds a block large enough for bytes aligned to alignment
+        void add_block(size_t bytes, size_t alignment);
+
+        std::vector<arena_block> blocks;    // Every block the arena holds - kept in order of use
+        size_t block_size;                  // Smallest block the arena will add
+        size_t current_block = 0;           // Block allocations are coming from
+        size_t current_offset = 0;          // Bytes used in the current block
+    };
+
+    // Takes a marker on construction and rewinds to it on destruction - releases a plys scratch memory however it returns
+    class Arena_Scope {
+    public:
+        Arena_Scope(Search_Arena& arena_in) : arena(arena_in), start(arena_in.get_marker()) {}
+        ~Arena_Scope() {arena.rewind(start);}
+
+        Arena_Scope(const Arena_Scope&) = delete;
+        Arena_Scope& operator=(const Arena_Scope&) = delete;
+
+    private:
+        Search_Arena& arena;            // Arena being scoped
+        Search_Arena::marker start;     // Point the arena is rewound to
+    };
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include "Thread_Pool.h"
+
+#include <atomic>       // std::atomic
+#include <exception>    // std::exception_ptr
+
+namespace Chess_API {
+    // Everything the threads running the shares of one run_shares call have in common
+    // Held by every task submitted for it so a worker that only gets to its task after the call returned finds no share left rather than freed memory
+    struct share_state {
+        const std::function<void(unsigned int)> * share = nullptr;
+        unsigned int share_count = 0;
+        std::atomic<unsigned int> next_share;           // Next share a thread may claim
+        std::mutex done_mutex;                          // Guards everything below
+        std::condition_variable all_done;               // Signalled once the last share has finished
+        unsigned int shares_done = 0;
+        std::exception_ptr error;                       // First exception a share threw
+    };
+
+    // Claims and runs shares until none are left
+    static void run_claimed_shares(share_state& state) {
+        while (true) {
+            unsigned int index = state.next_share++;
+            if (index >= state.share_count) {
+                return;
+            }
+
+            std::exception_ptr error;
+            try {
+                (*state.share)(index);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(state.done_mutex);
+            if (error != nullptr && state.error == nullptr) {
+                state.error = error;
+            }
+            if (++state.shares_done == state.share_count) {
+                state.all_done.notify_all();
+            }
+        }
+    }
+
+    // Starts thread_count workers - 0 uses one worker per core
+    Thread_Pool::Thread_Pool(unsigned int thread_count) {
+        thread_count = resolve_thread_count(thread_count);
+        for (unsigned int i = 0; i < thread_count; ++i) {
+            workers.emplace_back(&Thread_Pool::worker_loop, this);
+        }
+    }
+
+    // Runs every task still queued and then joins the workers
+    Thread_Pool::~Thread_Pool() {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            stopping = true;
+        }
+        tasks_available.notify_all();
+
+        for (int i = 0; i < workers.size(); ++i) {
+            workers[i].join();
+        }
+    }
+
+    // Queues the task to run on the next free worker - safe to call from any thread including the workers
+    void Thread_Pool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            tasks.push(std::move(task));
+        }
+        tasks_available.notify_one();
+    }
+
+    // Runs share(0) to share(share_count - 1) across the workers with the calling thread taking shares as well - returns once every share has run
+    // The caller runs whatever shares no worker is free for so it is safe to call from a task running on the pool
+    // Throws the first exception a share threw once every share has finished
+    void Thread_Pool::run_shares(unsigned int share_count, const std::function<void(unsigned int)>& share) {
+        if (share_count == 0) {
+            return;
+        }
+
+        std::shared_ptr<share_state> state = std::make_shared<share_state>();
+        state->share = &share;
+        state->share_count = share_count;
+        state->next_share = 0;
+
+        // The calling thread is one of the threads so one fewer worker is asked to help
+        unsigned int helpers = share_count - 1 < workers.size() ? share_count - 1 : workers.size();
+        for (unsigned int i = 0; i < helpers; ++i) {
+            submit([state]() {run_claimed_shares(*state);});
+        }
+        run_claimed_shares(*state);
+
+        std::unique_lock<std::mutex> lock(state->done_mutex);
+        state->all_done.wait(lock, [&state, share_count]() {return state->shares_done == share_count;});
+        if (state->error != nullptr) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    // Returns the number of threads to use when thread_count were asked for - 0 uses one thread per core and there is always at least one
+    unsigned int Thread_Pool::resolve_thread_count(unsigned int thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::thread::hardware_concurrency();
+        }
+        return thread_count == 0 ? 1 : thread_count;
+    }
+
+    // Returns the pool shared by the parallel jobs - one worker per core created on first use
+    std::shared_ptr<Thread_Pool> Thread_Pool::get_default() {
+        static std::shared_ptr<Thread_Pool> default_pool = std::make_shared<Thread_Pool>();
+        return default_pool;
+    }
+
+    // Runs tasks until the pool is destroyed and the queue is empty
+    // Tasks are expected to catch their own exceptions - one escaping a task ends the program like any other thread
+    void Thread_Pool::worker_loop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(tasks_mutex);
+                tasks_available.wait(lock, [this]() {return stopping || !tasks.empty();});
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+}
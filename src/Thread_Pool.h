@@ -0,0 +1,56 @@
+#ifndef CPLUSPLUS_CHESS_THREAD_POOL
+#define CPLUSPLUS_CHESS_THREAD_POOL
+
+#include <vector>
+#include <queue>
+#include <thread>               // std::thread
+#include <mutex>                // std::mutex
+#include <condition_variable>   // std::condition_variable
+#include <functional>           // std::function
+#include <memory>               // std::shared_ptr
+
+namespace Chess_API {
+    // A fixed set of worker threads running submitted tasks in the order they were submitted
+    // Lets many games share a few threads instead of each game blocking a thread of its own
+    class Thread_Pool {
+    public:
+        // Starts thread_count workers - 0 uses one worker per core
+        Thread_Pool(unsigned int thread_count = 0);
+
+        // Runs every task still queued and then joins the workers
+        ~Thread_Pool();
+
+        // Workers are owned by the pool and therefore it cannot be copied
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        // Queues the task to run on the next free worker - safe to call from any thread including the workers
+        void submit(std::function<void()> task);
+
+        // Returns the number of workers
+        unsigned int get_thread_count() const {return workers.size();}
+
+        // Runs share(0) to share(share_count - 1) across the workers with the calling thread taking shares as well - returns once every share has run
+        // The caller runs whatever shares no worker is free for so it is safe to call from a task running on the pool
+        // Throws the first exception a share threw once every share has finished
+        void run_shares(unsigned int share_count, const std::function<void(unsigned int)>& share);
+
+        // Returns the number of threads to use when thread_count were asked for - 0 uses one thread per core and there is always at least one
+        static unsigned int resolve_thread_count(unsigned int thread_count);
+
+        // Returns the pool shared by the parallel jobs - one worker per core created on first use
+        static std::shared_ptr<Thread_Pool> get_default();
+
+    private:
+        // Runs tasks until the pool is destroyed and the queue is empty
+        void worker_loop();
+
+        std::vector<std::thread> workers;               // Threads running the tasks
+        std::queue<std::function<void()>> tasks;        // Tasks waiting for a worker
+        std::mutex tasks_mutex;                         // Guards tasks and stopping
+        std::condition_variable tasks_available;        // Wakes a worker when a task is queued or the pool is stopping
+        bool stopping = false;                          // Set by the destructor
+    };
+}
+
+#endif
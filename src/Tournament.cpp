@@ -0,0 +1,207 @@
+#include "Tournament.h"
+#include "Thread_Pool.h"
+
+#include <mutex>        // std::mutex
+#include <atomic>       // std::atomic
+#include <random>       // std::mt19937_64, std::random_device
+#include <cmath>        // log, log10, pow, sqrt
+
+namespace Chess_API {
+    static const double CONFIDENCE_Z = 1.96;        // Standard deviations either side of the Elo estimate for 95% confidence
+    static const double SCORE_LIMIT = 0.001;        // Keeps a perfect score from giving an infinite Elo
+
+    // Converts an expected score into an Elo difference
+    static double score_to_elo(double score) {
+        if (score < SCORE_LIMIT) {
+            score = SCORE_LIMIT;
+        } else if (score > 1.0 - SCORE_LIMIT) {
+            score = 1.0 - SCORE_LIMIT;
+        }
+        return -400.0 * log10((1.0 / score) - 1.0);
+    }
+
+    // Converts an Elo difference into an expected score
+    static double elo_to_score(double elo) {
+        return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+    }
+
+    // Converts a {char}{num} square typed by a player into a board position - {-1, -1} if it isn't a square
+    static std::pair<int, int> string_to_position(const std::string& square) {
+        if (square.size() != 2 || VALID_CHARS.find(square[0]) == std::string::npos || VALID_NUMS.find(square[1]) == std::string::npos) {
+            return std::make_pair(-1, -1);
+        }
+        return std::make_pair(static_cast<int>(VALID_NUMS.find(square[1])), static_cast<int>(VALID_CHARS.find(square[0])));
+    }
+
+    // The first engine is the one being tested - results are reported from its perspective
+    Tournament::Tournament(const tournament_engine& first_in, const tournament_engine& second_in) : first(first_in), second(second_in) {}
+
+    // Creates a computer player for one side of a game
+    // Pondering is turned off so each game keeps to the one thread it was given
+    std::shared_ptr<Computer_Player> Tournament::make_player(const tournament_engine& settings, GAME_PIECE_COLOR color) const {
+        std::shared_ptr<Computer_Player> player(new Computer_Player(nullptr, color, settings.difficulty));
+        player->set_pondering(false);
+        player->set_engine(settings.engine);
+        if (settings.hash_megabytes != 0) {
+            player->set_hash_size(settings.hash_megabytes);
+        }
+        return player;
+    }
+
+    // Plays a single game from the opening - returns the half points the first engine scored - 0, 1 or 2
+    // A player handing back a move that can't be played loses the game
+    int Tournament::play_game(const std::vector<board_move>& opening, bool first_is_white, int max_plies) const {
+        std::shared_ptr<Computer_Player> white = make_player(first_is_white ? first : second, GAME_PIECE_COLOR::WHITE);
+        std::shared_ptr<Computer_Player> black = make_player(first_is_white ? second : first, GAME_PIECE_COLOR::BLACK);
+        Game game(white, black);
+        game.setup_default_board_state();
+        white->set_internal_game(&game);
+        black->set_internal_game(&game);
+
+        for (int i = 0; i < opening.size(); ++i) {
+            game.make_move(opening[i].first, opening[i].second);
+        }
+        game.update_game_state();
+
+        int white_half_points = 1;
+        for (int ply = 0; ply < max_plies; ++ply) {
+            Game::GAME_STATE state = game.get_current_game_state();
+            if (state == Game::CHECKMATE) {
+                white_half_points = game.get_current_player() == white ? 0 : 2;
+                break;
+            } else if (state == Game::STALEMATE || state == Game::THREEFOLD_REPETITION || state == Game::FIFTY_MOVE_RULE) {
+                break;
+            }
+
+            std::pair<std::string, std::string> move = game.get_current_player()->take_turn();
+            std::pair<int, int> start_pos = string_to_position(move.first);
+            std::pair<int, int> end_pos = string_to_position(move.second);
+            if (start_pos.first == -1 || end_pos.first == -1 || game.is_valid_move(start_pos, end_pos) != Game::VALID_MOVE) {
+                white_half_points = game.get_current_player() == white ? 0 : 2;
+                break;
+            }
+
+            game.make_move(start_pos, end_pos);
+            game.update_game_state();
+        }
+
+        return first_is_white ? white_half_points : 2 - white_half_points;
+    }
+
+    // Builds a random opening of up to plies moves from the start position - the same seed always builds the same opening
+    // An opening that would end the game stops short of the move that ends it
+    std::vector<board_move> Tournament::make_opening(uint64_t seed, int plies) {
+        Game game = Game::make_scratch_board();
+        game.setup_default_board_state();
+
+        std::mt19937_64 random(seed);
+        std::vector<board_move> opening;
+        board_move moves[MAX_POSITION_MOVES];
+        for (int ply = 0; ply < plies; ++ply) {
+            int move_count = game.get_valid_moves(moves);
+            if (move_count == 0) {
+                break;
+            }
+
+            board_move move = moves[random() % move_count];
+            Game::move_record record = game.make_move(move.first, move.second);
+            game.update_game_state();
+            if (game.get_current_game_state() != Game::NORMAL && game.get_current_game_state() != Game::CHECK) {
+                game.unmake_move(record);
+                break;
+            }
+            opening.push_back(move);
+        }
+        return opening;
+    }
+
+    // Returns the log likelihood ratio that the results come from an Elo difference of elo1 rather than elo0
+    // Uses the normal approximation to the game results - the variance of a game is measured from the results themselves
+    double Tournament::compute_llr(int wins, int draws, int losses, double elo0, double elo1) {
+        double games = wins + draws + losses;
+        if (games == 0) {
+            return 0.0;
+        }
+
+        double score = (wins + (draws / 2.0)) / games;
+        double variance = ((wins * (1.0 - score) * (1.0 - score)) + (draws * (0.5 - score) * (0.5 - score)) + (losses * score * score)) / games;
+        if (variance <= 0.0) {
+            return 0.0;
+        }
+
+        double score0 = elo_to_score(elo0);
+        double score1 = elo_to_score(elo1);
+        return games * (score1 - score0) * ((2.0 * score) - score0 - score1) / (2.0 * variance);
+    }
+
+    // Plays games until the limits are reached or the test decides - on_game may be empty
+    tournament_result Tournament::run(const tournament_limits& limits, tournament_callback on_game) const {
+        int64_t start_ms = steady_time_ms();
+        tournament_result result;
+        result.lower_bound = log(limits.beta / (1.0 - limits.alpha));
+        result.upper_bound = log((1.0 - limits.beta) / limits.alpha);
+
+        unsigned int thread_count = Thread_Pool::resolve_thread_count(limits.threads);
+
+        std::random_device device;
+        uint64_t seed = limits.seed != 0 ? limits.seed : (uint64_t(device()) << 32) | device();
+
+        std::atomic<int> next_game(0);
+        std::atomic<bool> decided(false);
+        std::mutex result_mutex;
+
+        // Each thread claims the next game until every game is claimed or the test has decided
+        auto play_games = [&](unsigned int) {
+            while (!decided) {
+                int game_index = next_game++;
+                if (game_index >= limits.games) {
+                    break;
+                }
+
+                // Both games of a pair share an opening with the colors swapped
+                std::vector<board_move> opening = make_opening(seed + (game_index / 2), limits.opening_plies);
+                int half_points = play_game(opening, game_index % 2 == 0, limits.max_plies);
+
+                std::lock_guard<std::mutex> lock(result_mutex);
+                if (result.sprt_result != SPRT_CONTINUE) {
+                    continue;
+                }
+                if (half_points == 2) {
+                    ++result.wins;
+                } else if (half_points == 1) {
+                    ++result.draws;
+                } else {
+                    ++result.losses;
+                }
+
+                int games = result.wins + result.draws + result.losses;
+                double score = (result.wins + (result.draws / 2.0)) / games;
+                double variance = ((result.wins * (1.0 - score) * (1.0 - score)) + (result.draws * (0.5 - score) * (0.5 - score))
+                    + (result.losses * score * score)) / games;
+                double deviation = sqrt(variance / games);
+                result.elo = score_to_elo(score);
+                result.elo_error = (score_to_elo(score + (CONFIDENCE_Z * deviation)) - score_to_elo(score - (CONFIDENCE_Z * deviation))) / 2.0;
+                result.llr = compute_llr(result.wins, result.draws, result.losses, limits.elo0, limits.elo1);
+
+                if (limits.sprt && result.llr >= result.upper_bound) {
+                    result.sprt_result = SPRT_ACCEPT_H1;
+                    decided = true;
+                } else if (limits.sprt && result.llr <= result.lower_bound) {
+                    result.sprt_result = SPRT_ACCEPT_H0;
+                    decided = true;
+                }
+
+                result.elapsed_ms = steady_time_ms() - start_ms;
+                if (on_game) {
+                    on_game(result);
+                }
+            }
+        };
+
+        // The calling thread plays games alongside the workers
+        Thread_Pool::get_default()->run_shares(thread_count, play_games);
+
+        result.elapsed_ms = steady_time_ms() - start_ms;
+        return result;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef CPLUSPLUS_CHESS_TOURNAMENT
+#define CPLUSPLUS_CHESS_TOURNAMENT
+
+#include <vector>
+#include <string>
+#include <functional>   // std::function
+#include <cstdint>      // uint64_t, int64_t
+#include <cstddef>      // size_t
+
+#include "Game.h"
+#include "Computer_Player.h"
+#include "Chess_API_vars.h"
+
+namespace Chess_API {
+    // How one side of a tournament plays
+    struct tournament_engine {
+        DIFFICULTY difficulty = DEFAULT_COMPUTER_DIFFICULTY;
+        COMPUTER_ENGINE engine = ALPHA_BETA;
+        size_t hash_megabytes = 0;      // Size of the transposition table - 0 keeps the default size
+    };
+
+    // Settings for a tournament and the sequential probability ratio test that can end it early
+    struct tournament_limits {
+        int games = 1000;               // Most games to play - each opening is played twice with the colors swapped
+        unsigned int threads = 0;       // Games played at once - 0 plays one game per hardware thread
+        int opening_plies = 8;          // Random moves played from the start position so the games don't all repeat each other
+        int max_plies = 400;            // Games still going after this many plies count as draws
+        uint64_t seed = 0;              // Seeds the openings - 0 picks a random seed
+        bool sprt = true;               // Whether to stop as soon as the test reaches a decision
+        double elo0 = 0.0;              // Elo difference of the hypothesis that the first engine is no stronger
+        double elo1 = 5.0;              // Elo difference of the hypothesis that the first engine is stronger
+        double alpha = 0.05;            // Chance of accepting elo1 when elo0 is true
+        double beta = 0.05;             // Chance of accepting elo0 when elo1 is true
+    };
+
+    // Where the sequential probability ratio test stands
+    enum SPRT_RESULT {
+        SPRT_CONTINUE,      // Not enough games to decide
+        SPRT_ACCEPT_H0,     // The first engine is no stronger than elo0
+        SPRT_ACCEPT_H1      // The first engine is stronger by at least elo1
+    };
+
+    // Standing of a tournament - every count is from the perspective of the first engine
+    struct tournament_result {
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+        double elo = 0.0;               // Estimated Elo difference of the first engine over the second
+        double elo_error = 0.0;         // Half the width of the 95% confidence interval around elo
+        double llr = 0.0;               // Log likelihood ratio of the test
+        double lower_bound = 0.0;       // The test accepts elo0 once llr falls to this
+        double upper_bound = 0.0;       // The test accepts elo1 once llr reaches this
+        SPRT_RESULT sprt_result = SPRT_CONTINUE;
+        int64_t elapsed_ms = 0;
+    };
+
+    // Called with the standing after every finished game - calls never overlap but come from the threads playing the games
+    typedef std::function<void(const tournament_result&)> tournament_callback;
+
+    // Plays two computer player configurations against each other to show whether a change made the engine stronger or weaker
+    // Games run in parallel one to a thread - each opening is played with both colors so neither engine gains from a lucky opening
+    class Tournament {
+    public:
+        // The first engine is the one being tested - results are reported from its perspective
+        Tournament(const tournament_engine& first_in, const tournament_engine& second_in);
+
+        // Plays games until the limits are reached or the test decides - on_game may be empty
+        tournament_result run(const tournament_limits& limits, tournament_callback on_game = nullptr) const;
+
+        // Plays a single game from the opening - returns the half points the first engine scored - 0, 1 or 2
+        int play_game(const std::vector<board_move>& opening, bool first_is_white, int max_plies) const;
+
+        // Builds a random opening of up to plies moves from the start position - the same seed always builds the same opening
+        static std::vector<board_move> make_opening(uint64_t seed, int plies);
+
+        // Returns the log likelihood ratio that the results come from an Elo difference of elo1 rather than elo0
+        static double compute_llr(int wins, int draws, int losses, double elo0, double elo1);
+
+    private:
+        // Creates a computer player for one side of a game
+        std::shared_ptr<Computer_Player> make_player(const tournament_engine& settings, GAME_PIECE_COLOR color) const;
+
+        tournament_engine first;    // Engine being tested
+        tournament_engine second;   // Engine it is measured against
+    };
+}
+
+#endif
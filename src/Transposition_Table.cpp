@@ -0,0 +1,136 @@
+#include "Transposition_Table.h"
+#include "Chess_API_vars.h"
+#include "Thread_Pool.h"
+
+#include <vector>
+
+#ifdef _WIN32
+#   include <Windows.h>     // VirtualAlloc, VirtualFree
+#else
+#   include <sys/mman.h>    // madvise
+#   include <stdlib.h>      // posix_memalign, free
+#endif
+
+namespace Chess_API {
+    static const size_t HUGE_PAGE_BYTES = size_t(2) << 20;          // Size of a huge page - larger tables are aligned to it
+    static const size_t CACHE_LINE_BYTES = 64;                      // Alignment of smaller tables
+    static const size_t PARALLEL_CLEAR_BYTES = size_t(32) << 20;    // Tables smaller than this are cleared on the calling thread
+
+    // Allocates the memory for a table of bytes bytes - returns nullptr if it cannot be allocated
+    // Linux is asked to back the table with transparent huge pages - Windows commits the pages up front
+    static tt_entry * allocate_entries(size_t bytes) {
+#ifdef _WIN32
+        return static_cast<tt_entry *>(VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+        size_t alignment = bytes >= HUGE_PAGE_BYTES ? HUGE_PAGE_BYTES : CACHE_LINE_BYTES;
+        void * memory = nullptr;
+        if (posix_memalign(&memory, alignment, bytes) != 0) {
+            return nullptr;
+        }
+#ifdef MADV_HUGEPAGE
+        if (bytes >= HUGE_PAGE_BYTES) {
+            madvise(memory, bytes, MADV_HUGEPAGE);
+        }
+#endif
+        return static_cast<tt_entry *>(memory);
+#endif
+    }
+
+    // Releases memory from allocate_entries
+    static void free_entries(tt_entry * entries) {
+        if (entries == nullptr) {
+            return;
+        }
+#ifdef _WIN32
+        VirtualFree(entries, 0, MEM_RELEASE);
+#else
+        free(entries);
+#endif
+    }
+
+    // Creates a table with room for entry_count entries - rounded down to a power of two
+    // Throws a runtime_error if the memory cannot be allocated
+    Transposition_Table::Transposition_Table(size_t entry_count) {
+        resize(entry_count);
+    }
+
+    // Releases the table memory
+    Transposition_Table::~Transposition_Table() {
+        free_entries(entries);
+    }
+
+    // Replaces the table with an empty one of entry_count entries - rounded down to a power of two
+    // Throws a runtime_error if the memory cannot be allocated - the old table is kept in that case
+    void Transposition_Table::resize(size_t entry_count) {
+        size_t size = 1;
+        while (size * 2 <= entry_count) {
+            size *= 2;
+        }
+
+        tt_entry * new_entries = allocate_entries(size * sizeof(tt_entry));
+        if (new_entries == nullptr) {
+            throw std::runtime_error(TABLE_ALLOCATION_ERROR_MSG);
+        }
+
+        free_entries(entries);
+        entries = new_entries;
+        index_mask = size - 1;
+        clear();
+    }
+
+    // Replaces the table with the largest empty one that fits in megabytes - at least one entry
+    void Transposition_Table::resize_megabytes(size_t megabytes) {
+        resize((megabytes << 20) / sizeof(tt_entry));
+    }
+
+    // Copies the entry for the key into entry - returns false if the position has no entry
+    bool Transposition_Table::probe(uint64_t key, tt_entry& entry) const {
+        const tt_entry& slot = entries[key & index_mask];
+        if (slot.bound == TT_NONE || slot.key != key) {
+            return false;
+        }
+        entry = slot;
+        return true;
+    }
+
+    // Stores a search result - replaces the slots entry unless it holds a deeper search of the same position
+    void Transposition_Table::store(uint64_t key, int depth, int score, TT_BOUND bound, uint8_t start_square, uint8_t end_square) {
+        tt_entry& slot = entries[key & index_mask];
+        if (slot.key == key && slot.depth > depth && bound != TT_EXACT) {
+            return;
+        }
+
+        // Keeping the old best move if this search didn't find one
+        if (start_square == 255 && slot.key == key) {
+            start_square = slot.start_square;
+            end_square = slot.end_square;
+        }
+
+        slot.key = key;
+        slot.score = score;
+        slot.depth = static_cast<int16_t>(depth);
+        slot.start_square = start_square;
+        slot.end_square = end_square;
+        slot.bound = static_cast<uint8_t>(bound);
+    }
+
+    // Forgets every entry - large tables are split between thread_count threads where 0 uses every hardware thread
+    // Each thread writes its own slice so the pages of a fresh table are also spread over the memory of every core
+    void Transposition_Table::clear(unsigned int thread_count) {
+        size_t entry_count = get_entry_count();
+        thread_count = Thread_Pool::resolve_thread_count(thread_count);
+        if (get_size_bytes() < PARALLEL_CLEAR_BYTES) {
+            thread_count = 1;
+        }
+
+        // Each share clears one slice on the shared pool - the calling thread clears whichever slices the workers don't get to
+        tt_entry * table_entries = entries;
+        size_t slice = entry_count / thread_count;
+        Thread_Pool::get_default()->run_shares(thread_count, [table_entries, entry_count, slice, thread_count](unsigned int share) {
+            size_t end = share == thread_count - 1 ? entry_count : slice * (share + 1);
+            for (size_t i = slice * share; i < end; ++i) {
+                table_entries[i] = tt_entry();
+            }
+        });
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef CPLUSPLUS_CHESS_TRANSPOSITION_TABLE
+#define CPLUSPLUS_CHESS_TRANSPOSITION_TABLE
+
+#include <cstdint>      // uint64_t
+#include <cstddef>      // size_t
+#include <stdexcept>    // std::runtime_error
+
+#ifdef _MSC_VER
+#   include <xmmintrin.h>   // _mm_prefetch
+#endif
+
+namespace Chess_API {
+    // How the score stored in an entry relates to the true score of the position
+    enum TT_BOUND {
+        TT_NONE,
+        TT_EXACT,   // The score is exact
+        TT_LOWER,   // The search failed high - the true score is at least the stored score
+        TT_UPPER    // The search failed low - the true score is at most the stored score
+    };
+
+    // A single remembered search result - squares are numbered x * 8 + y with 255 meaning no move
+    struct tt_entry {
+        uint64_t key = 0;           // Full hash key of the position - guards against two positions sharing a slot
+        int32_t score = 0;          // Score from the perspective of the player on move
+        int16_t depth = -1;         // Depth the position was searched to
+        uint8_t start_square = 255; // Best move found for the position
+        uint8_t end_square = 255;
+        uint8_t bound = TT_NONE;    // TT_BOUND describing the score
+    };
+
+    // Remembers search results by position hash so positions reached through different move orders are only searched once
+    // The table is kept between searches - pondering and later moves reuse what earlier searches learned
+    // Large tables are backed by huge pages where the operating system offers them so probes into a multi-gigabyte table don't miss the TLB
+    class Transposition_Table {
+    public:
+        // Creates a table with room for entry_count entries - rounded down to a power of two
+        // Throws a runtime_error if the memory cannot be allocated
+        Transposition_Table(size_t entry_count);
+
+        // Releases the table memory
+        ~Transposition_Table();
+
+        // The table owns its memory and therefore it cannot be copied
+        Transposition_Table(const Transposition_Table&) = delete;
+        Transposition_Table& operator=(const Transposition_Table&) = delete;
+
+        // Replaces the table with an empty one of entry_count entries - rounded down to a power of two
+        // Throws a runtime_error if the memory cannot be allocated - the old table is kept in that case
+        // Not safe while a search is using the table
+        void resize(size_t entry_count);
+
+        // Replaces the table with the largest empty one that fits in megabytes - at least one entry
+        void resize_megabytes(size_t megabytes);
+
+        // Copies the entry for the key into entry - returns false if the position has no entry
+        bool probe(uint64_t key, tt_entry& entry) const;
+
+        // Stores a search result - replaces the slots entry unless it holds a deeper search of the same position
+        void store(uint64_t key, int depth, int score, TT_BOUND bound, uint8_t start_square, uint8_t end_square);
+
+        // Starts loading the slot for the key into the cache - called as soon as a move is made so the probe that follows doesn't wait on memory
+        void prefetch(uint64_t key) const {
+#ifdef _MSC_VER
+            _mm_prefetch(reinterpret_cast<const char *>(&entries[key & index_mask]), _MM_HINT_T0);
+#else
+            __builtin_prefetch(&entries[key & index_mask]);
+#endif
+        }
+
+        // Forgets every entry - large tables are split between thread_count threads where 0 uses every hardware thread
+        void clear(unsigned int thread_count = 0);
+
+        // Returns the number of entries the table has room for
+        size_t get_entry_count() const {return index_mask + 1;}
+
+        // Returns the memory used by the entries in bytes
+        size_t get_size_bytes() const {return get_entry_count() * sizeof(tt_entry);}
+
+    private:
+        tt_entry * entries = nullptr;   // The table itself
+        size_t index_mask = 0;          // Mask turning a key into a slot - the entry count - 1
+    };
+}
+
+#endif
@@ -3,11 +3,144 @@
 using namespace std;
 using namespace Chess_API;
 
+// Tests playing a human turn and a computer turn asynchronously - the computer thinks on a shared thread pool within a deadline
+bool test_async_turns() {
+    shared_ptr<Thread_Pool> thread_pool(new Thread_Pool(1));
+    Chess new_game(DEFAULT_HUMAN_NAME, DIFFICULTY::EXPERT);
+    new_game.set_thread_pool(thread_pool);
+
+    // The human turn waits until the move is submitted
+    new_game.start_turn();
+    if (new_game.poll_turn()) {
+        return false;
+    }
+
+    shared_ptr<Human_Player> human = dynamic_pointer_cast<Human_Player>(new_game.get_current_player());
+    if (human == nullptr || !human->submit_move(make_pair("e2", "e4")) || !new_game.poll_turn()) {
+        return false;
+    }
+
+    // The computer has far longer than the deadline to think at its difficulty - the deadline has to cut it short
+    shared_ptr<Cancellation_Token> token(new Cancellation_Token(200));
+    new_game.start_turn(token);
+    auto start = chrono::steady_clock::now();
+    while (!new_game.poll_turn()) {
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    return elapsed < DIFFICULTY_MOVE_TIMES_MS[DIFFICULTY::EXPERT] && new_game.get_current_player() == human;
+}
+
+// Tests that cancelling a human turn ends it without a move and lets the next turn start
+bool test_cancel_turn() {
+    Chess new_game(DEFAULT_HUMAN_NAME, DEFAULT_HUMAN_NAME);
+    shared_ptr<Player> player = new_game.get_current_player();
+
+    new_game.start_turn();
+    new_game.cancel_turn();
+
+    bool cancelled = false;
+    try {
+        new_game.poll_turn();
+    } catch (runtime_error e) {
+        cancelled = string(e.what()) == TURN_CANCELLED_ERROR_MSG;
+    }
+
+    // A turn past its deadline is ended the next time it is polled
+    new_game.start_turn(shared_ptr<Cancellation_Token>(new Cancellation_Token(1)));
+    this_thread::sleep_for(chrono::milliseconds(5));
+    bool timed_out = false;
+    try {
+        while (!new_game.poll_turn()) {}
+    } catch (runtime_error e) {
+        timed_out = string(e.what()) == TURN_DEADLINE_ERROR_MSG;
+    }
+
+    return cancelled && timed_out && !new_game.is_turn_pending() && new_game.get_current_player() == player;
+}
+
+// Tests that a suspended game is restored from its record to the same position and hands back the same record
+bool test_restore_game() {
+    // Fools mate - f3 e5 g4 Qh4#
+    game_record record;
+    record.moves = {make_pair(make_pair(1, 5), make_pair(2, 5)), make_pair(make_pair(6, 4), make_pair(4, 4)),
+        make_pair(make_pair(1, 6), make_pair(3, 6)), make_pair(make_pair(7, 3), make_pair(3, 7))};
+    std::vector<board_move> moves = record.moves;
+
+    // Part way through it is the computers turn with the black pieces
+    game_record partial = record;
+    partial.moves.pop_back();
+    Chess unfinished(std::move(partial), DEFAULT_HUMAN_NAME, DIFFICULTY::EASY);
+    if (dynamic_pointer_cast<Computer_Player>(unfinished.get_current_player()) == nullptr || unfinished.is_in_check_mate()
+        || unfinished.get_game_record().moves.size() != 3) {
+        return false;
+    }
+
+    Chess finished(std::move(record), DEFAULT_HUMAN_NAME, DEFAULT_HUMAN_NAME);
+    game_record restored = finished.get_game_record();
+    if (!finished.is_in_check_mate() || restored.moves != moves || restored.white_half_points != 0 || !restored.start_fen.empty()) {
+        return false;
+    }
+
+    // Past moves given as player input are played on the game they were handed with rather than only kept as history
+    Game start = Game::make_scratch_board();
+    start.setup_default_board_state();
+    std::vector<std::pair<std::string, std::string>> past_moves = {make_pair("f2", "f3"), make_pair("e7", "e5"), make_pair("g2", "g4"), make_pair("D8", "H4")};
+    Chess replayed(std::move(start), std::move(past_moves));
+    if (!replayed.is_in_check_mate() || replayed.get_game_record().moves != moves || !replayed.get_game_record().start_fen.empty()) {
+        return false;
+    }
+
+    // A game set up from a FEN keeps its starting position through a save and restore - e4 fxe3 en passant only works from there
+    game_record from_fen;
+    from_fen.start_fen = "r3k2r/8/8/8/5p2/8/4P3/R3K2R w KQkq - 0 1";
+    from_fen.moves = {make_pair(make_pair(1, 4), make_pair(3, 4)), make_pair(make_pair(3, 5), make_pair(2, 4))};
+    game_record expected = from_fen;
+    Chess saved(std::move(from_fen), DEFAULT_HUMAN_NAME, DEFAULT_HUMAN_NAME);
+    Chess reloaded(saved.get_game_record(), DEFAULT_HUMAN_NAME, DEFAULT_HUMAN_NAME);
+    game_record round_trip = reloaded.get_game_record();
+    return round_trip.start_fen == expected.start_fen && round_trip.moves == expected.moves && reloaded.get_current_player()->get_player_color() == GAME_PIECE_COLOR::WHITE;
+}
+
 // Executes all of the unit tests for the Chess object - if any fail it will return an integer to describe the number that failed
 int run_chess_tests() {
     int errors = 0;
 
-    std::cout << "Testing the chess object - tests to come at a later time..." << std::endl;
+    // Testing asynchronous turns
+    try {
+        if (!test_async_turns()) {
+            cout << "   ERROR: The asynchronous turns were not played within their deadline" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_async_turns threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing cancelling turns
+    try {
+        if (!test_cancel_turn()) {
+            cout << "   ERROR: The turn did not end after being cancelled or running out of time" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_cancel_turn threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing restoring games
+    try {
+        if (!test_restore_game()) {
+            cout << "   ERROR: The restored game did not reach the same position or hand back the same record" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_restore_game threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
     return errors;
-}
\ No newline at end of file
+}
@@ -3,6 +3,8 @@
 
 #include "Chess.h"
 #include <iostream>
+#include <chrono>     // measuring time passed
+#include <thread>     // this_thread::sleep_for
 
 // Executes all of the unit tests for the Chess object - if any fail it will return an integer to describe the number that failed
 int run_chess_tests();
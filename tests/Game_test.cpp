@@ -4,6 +4,29 @@ using namespace Chess_API;
 using namespace std;
 using namespace std::chrono;
 
+// Allocations made by the calling thread while counting_allocations is set - used to check the search allocates nothing once warmed up
+static thread_local bool counting_allocations = false;
+static thread_local int counted_allocations = 0;
+
+void* operator new(std::size_t size) {
+    if (counting_allocations) {
+        ++counted_allocations;
+    }
+    void * memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void * memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
 // Helper test function - determines if a move is valid and then returns useful information regarding the validity
 std::pair<bool, std::string> check_move_error_codes(Game& game_in, const std::pair<int, int> start_pos, const std::pair<int, int> end_pos) {
     Game::MOVE_ERROR_CODE error_code = game_in.is_valid_move(start_pos, end_pos);
@@ -46,6 +69,10 @@ void print_game_state(Game& game_in) {
         cout << "The game is in a stalemate!" << endl;
     } else if (state == Game::GAME_STATE::CHECK) {
         cout << "The game is in check!" << endl;
+    } else if (state == Game::GAME_STATE::THREEFOLD_REPETITION) {
+        cout << "The game is drawn by threefold repetition!" << endl;
+    } else if (state == Game::GAME_STATE::FIFTY_MOVE_RULE) {
+        cout << "The game is drawn by the fifty move rule!" << endl;
     } else {
         cout << "The game is in normal play right now." << endl;
     }
@@ -1902,401 +1929,2288 @@ bool test_stale_mate() {
     return true;
 }
 
-// Use only when messing with the display settings - not an important unit test
-void test_display() {
+// Tests that every one of the twenty opening moves is generated for the default board
+bool test_valid_moves_default_board() {
     shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
     shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
     Game new_game(player1, player2);
     new_game.setup_default_board_state();
-    new_game.show_board();
+
+    std::vector<board_move> moves = new_game.get_valid_moves();
+    if (moves.size() != 20) {
+        return false;
+    }
+
+    // Every generated move must also be accepted by is_valid_move
+    for (int i = 0; i < moves.size(); ++i) {
+        if (new_game.is_valid_move(moves[i].first, moves[i].second) != Game::MOVE_ERROR_CODE::VALID_MOVE) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-// Use only when messing with play functions - useful for simulating games without needing the higher level API
-void test_simulating_play() {
+// Tests the retro moves on a bare board - a king in the middle could have come from any of its eight neighbours and a pawn on its fourth row from either of the two rows behind it
+bool test_retro_moves() {
     shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
     shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
     Game new_game(player1, player2);
-    new_game.setup_default_board_state();
-    new_game.show_board();
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::WHITE, std::make_pair(4, 4));
+    new_game.add_piece(GAME_PIECE_TYPE::PAWN, GAME_PIECE_COLOR::WHITE, std::make_pair(3, 0));
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::BLACK, std::make_pair(7, 7));
+    new_game.swap_current_player(); // Blacks turn - white played last
 
-    // Player 1's turn
-    std::pair<int, int> player_1_move_start = std::make_pair(1, 5);
-    std::pair<int, int> player_1_move_end = std::make_pair(2, 5);
+    std::vector<board_move> retro_moves = new_game.get_retro_moves();
+    if (retro_moves.size() != 10) {
+        return false;
+    }
 
-    // Player 2's turn
-    std::pair<int, int> player_2_move_start = std::make_pair(6, 4);
-    std::pair<int, int> player_2_move_end = std::make_pair(4, 4);
+    // The pawn double move must be one of them
+    auto double_move = std::find(retro_moves.cbegin(), retro_moves.cend(), std::make_pair(std::make_pair(1, 0), std::make_pair(3, 0)));
+    return double_move != retro_moves.cend();
+}
 
-    // F2 - F3
-    if (check_move_error_codes(new_game, player_1_move_start, player_1_move_end).first) {
-        new_game.play_move(player_1_move_start, player_1_move_end);
-    }    
-    new_game.show_board();
-    new_game.swap_current_player();
-    new_game.update_game_state();
-    print_game_state(new_game);
+// Tests that a pawn reaching the far side of the board is promoted to a queen
+bool test_pawn_promotion() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::WHITE, std::make_pair(0, 4));
+    new_game.add_piece(GAME_PIECE_TYPE::PAWN, GAME_PIECE_COLOR::WHITE, std::make_pair(6, 0));
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::BLACK, std::make_pair(7, 7));
 
-    // E7 - E5
-    if (check_move_error_codes(new_game, player_2_move_start, player_2_move_end).first) {
-        new_game.play_move(player_2_move_start, player_2_move_end);
-    }    
-    new_game.show_board();
-    new_game.swap_current_player();
-    new_game.update_game_state();
-    print_game_state(new_game);
+    if (check_move_error_codes(new_game, std::make_pair(6, 0), std::make_pair(7, 0)).first) {
+        new_game.play_move(std::make_pair(6, 0), std::make_pair(7, 0));
+    }
 
-    // Player 1's turn
-    player_1_move_start = std::make_pair(1, 6);
-    player_1_move_end = std::make_pair(3, 6);
+    game_piece promoted = new_game.get_location(std::make_pair(7, 0));
+    return promoted.type == GAME_PIECE_TYPE::QUEEN && promoted.color == GAME_PIECE_COLOR::WHITE;
+}
 
-    // Player 2's turn
-    player_2_move_start = std::make_pair(7, 3);
-    player_2_move_end = std::make_pair(3, 7);
+// Generates the KQK, KRK and KPK bitbases into the directory - KQK first so KPK resolves its promotions with it
+static void generate_test_bitbases(const std::filesystem::path& directory) {
+    std::filesystem::create_directories(directory);
+    Bitbase_Generator generator(2);
+    generator.generate_to_file(KQK, (directory / ("KQK" + BITBASE_FILE_EXTENSION)).string());
+    generator.generate_to_file(KRK, (directory / ("KRK" + BITBASE_FILE_EXTENSION)).string());
+    generator.generate_to_file(KPK, (directory / ("KPK" + BITBASE_FILE_EXTENSION)).string());
+}
 
-    // G2 - G4
-    if (check_move_error_codes(new_game, player_1_move_start, player_1_move_end).first) {
-        new_game.play_move(player_1_move_start, player_1_move_end);
-    }    
-    new_game.show_board();
-    new_game.swap_current_player();
-    new_game.update_game_state();
-    print_game_state(new_game);
+// Tests that generated bitbases give the known results of a few hand checked positions - from either side and for either player to move
+bool test_bitbase_generation() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_bitbase_test";
+    generate_test_bitbases(directory);
+
+    const std::pair<std::string, BITBASE_RESULT> positions[] = {
+        std::make_pair("4k3/4P3/4K3/8/8/8/8/8 b - - 0 1", BITBASE_DRAW),       // Stalemate
+        std::make_pair("1k6/8/K7/P7/8/8/8/8 w - - 0 1", BITBASE_DRAW),         // Rook pawn with the king in front of it
+        std::make_pair("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", BITBASE_WIN),
+        std::make_pair("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", BITBASE_LOSS),
+        std::make_pair("7k/8/8/8/8/8/8/K5R1 w - - 0 1", BITBASE_WIN),
+        std::make_pair("8/8/8/8/8/8/1k6/R6K b - - 0 1", BITBASE_DRAW),         // The rook is hanging
+        std::make_pair("k5r1/8/8/8/8/8/8/7K b - - 0 1", BITBASE_WIN),         // Black is the strong side
+        std::make_pair("8/8/8/8/8/8/8/K1k4R w - - 0 1", BITBASE_INVALID),      // The player not on move is in check
+        std::make_pair("8/8/8/8/8/8/1k6/BN5K w - - 0 1", BITBASE_INVALID)      // KBNK wasn't generated
+    };
 
-    // D8 - H4 - Checkmate
-    if (check_move_error_codes(new_game, player_2_move_start, player_2_move_end).first) {
-        new_game.play_move(player_2_move_start, player_2_move_end);
-    }    
-    new_game.show_board();
-    new_game.swap_current_player();
-    new_game.update_game_state();
-    print_game_state(new_game);
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    bool correct = true;
+    {
+        Bitbase_Set bitbases(directory.string());
+        Bitbase krk((directory / ("KRK" + BITBASE_FILE_EXTENSION)).string());
+        correct = !bitbases.empty() && krk.get_endgame() == KRK;
+        for (int i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i) {
+            new_game.from_fen(positions[i].first);
+            correct = correct && bitbases.probe(new_game) == positions[i].second;
+        }
+
+        // A single bitbase only answers for its own endgame
+        new_game.from_fen(positions[0].first);
+        correct = correct && krk.probe(new_game) == BITBASE_INVALID;
+    }
+    std::filesystem::remove_all(directory);
+    return correct;
 }
 
-// Executes all of the unit tests for the Chess object - if any fail it will return an integer to describe the number that failed
-int run_game_tests() {
-    int errors = 0;
+// Tests that the KBNK bitbase loads from its mapped file and gives the known results of a few positions - won with either side strong and drawn once the pieces can't force mate
+bool test_kbnk_bitbase() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_kbnk_bitbase_test";
+    std::filesystem::create_directories(directory);
+    Bitbase_Generator generator(2);
+    std::string file_path = (directory / ("KBNK" + BITBASE_FILE_EXTENSION)).string();
+    generator.generate_to_file(KBNK, file_path);
+
+    const std::pair<std::string, BITBASE_RESULT> positions[] = {
+        std::make_pair("7k/8/8/8/8/8/8/KBN5 w - - 0 1", BITBASE_WIN),
+        std::make_pair("7k/8/8/8/8/8/8/KBN5 b - - 0 1", BITBASE_LOSS),
+        std::make_pair("knb5/8/8/8/8/8/8/7K b - - 0 1", BITBASE_WIN),         // Black is the strong side
+        std::make_pair("k7/8/1K6/8/8/8/7B/6N1 b - - 0 1", BITBASE_DRAW),       // Stalemated in the corner
+        std::make_pair("8/8/8/8/8/8/1k6/BN5K b - - 0 1", BITBASE_DRAW),        // Either piece is taken leaving no mating material
+        std::make_pair("8/8/8/8/8/8/1k6/BN5K w - - 0 1", BITBASE_INVALID)      // The player not on move is in check
+    };
 
-    // Testing instantiation
-    try {
-        if(!test_create_game()) {
-            cout << "   ERROR: An error occured while attempting to create a new game object" << endl;
-            ++errors;
+    Game new_game = Game::make_scratch_board();
+    bool correct = true;
+    {
+        Bitbase kbnk(file_path);
+        Bitbase_Set bitbases(directory.string());
+        correct = kbnk.get_endgame() == KBNK && !bitbases.empty();
+        for (int i = 0; i < sizeof(positions) / sizeof(positions[0]); ++i) {
+            new_game.from_fen(positions[i].first);
+            correct = correct && kbnk.probe(new_game) == positions[i].second && bitbases.probe(new_game) == positions[i].second;
         }
-    // Case where deallocation was a problem
-    } catch(exception e) {
-        cout << "   ERROR: test_create_game threw an error: " << e.what() << endl;
-        ++errors;
     }
+    std::filesystem::remove_all(directory);
+    return correct;
+}
 
-    
-    // Testing stability with many instantiations
-    try {
-        if(!test_creating_many_games()) {
-            cout << "   ERROR: An error occured while attempting to create many game objects" << endl;
-            ++errors;
+// Plays the computer against itself from the position until the game ends or max_plies have been played - returns the final game state
+static Game::GAME_STATE play_computer_game(const std::string& fen, std::shared_ptr<const Bitbase_Set> bitbases, int max_plies) {
+    shared_ptr<Computer_Player> white(new Computer_Player(nullptr, GAME_PIECE_COLOR::WHITE, DIFFICULTY::MEDIUM));
+    shared_ptr<Computer_Player> black(new Computer_Player(nullptr, GAME_PIECE_COLOR::BLACK, DIFFICULTY::MEDIUM));
+    Game new_game(white, black);
+    new_game.from_fen(fen);
+    new_game.update_game_state();
+    white->set_internal_game(&new_game);
+    black->set_internal_game(&new_game);
+    white->set_bitbases(bitbases);
+    black->set_bitbases(bitbases);
+    white->set_pondering(false);
+    black->set_pondering(false);
+
+    for (int ply = 0; ply < max_plies; ++ply) {
+        if (new_game.get_current_game_state() != Game::NORMAL && new_game.get_current_game_state() != Game::CHECK) {
+            break;
         }
-    // Case where deallocation was a problem
-    } catch(exception e) {
-        cout << "   ERROR: test_creating_many_games threw an error: " << e.what() << endl;
-        ++errors;
-    }
-    
 
-    // Testing getting a simple location
-    try {
-        if (!test_getting_rand_location_board_empty()) {
-            cout << "   ERROR: The empty board is not full of invalid pieces" << endl;
-            ++errors;
+        std::pair<std::string, std::string> move = new_game.get_current_player()->take_turn();
+        std::pair<int, int> start_pos = std::make_pair(static_cast<int>(VALID_NUMS.find(move.first[1])), static_cast<int>(VALID_CHARS.find(move.first[0])));
+        std::pair<int, int> end_pos = std::make_pair(static_cast<int>(VALID_NUMS.find(move.second[1])), static_cast<int>(VALID_CHARS.find(move.second[0])));
+        if (new_game.is_valid_move(start_pos, end_pos) != Game::VALID_MOVE) {
+            break;
         }
-    } catch(exception e) {
-        cout << "   ERROR: test_getting_rand_location_board_empty threw an error: " << e.what() << endl;
-        ++errors;
+        new_game.make_move(start_pos, end_pos);
+        new_game.update_game_state();
     }
+    return new_game.get_current_game_state();
+}
 
+// Tests that the computer turns won bitbase positions into checkmate instead of shuffling between winning moves until the game is drawn
+bool test_bitbase_conversion() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_bitbase_conversion_test";
+    generate_test_bitbases(directory);
 
-    // Testing that you cannot select outside the bounds
-    try {
-        if (!test_no_access_to_out_of_bounds()) {
-            cout << "   ERROR: The game allowed a selection out-of-bounds" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_no_access_to_out_of_bounds threw an error: " << e.what() << endl;
-        ++errors;
+    bool converted = true;
+    {
+        std::shared_ptr<const Bitbase_Set> bitbases(new Bitbase_Set(directory.string()));
+        converted = converted && play_computer_game("7k/8/8/8/8/8/8/K5R1 w - - 0 1", bitbases, 100) == Game::CHECKMATE;
+        converted = converted && play_computer_game("8/8/8/4k3/8/8/3PK3/8 w - - 0 1", bitbases, 100) == Game::CHECKMATE;
     }
+    std::filesystem::remove_all(directory);
+    return converted;
+}
 
-    
-    // Testing adding a random piece to the board
-    try {
-        if (!test_adding_piece_to_board()) {
-            cout << "   ERROR: The board was unable to successfully add a new random piece" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_adding_piece_to_board threw an error: " << e.what() << endl;
-        ++errors;
-    }
+// Tests that a second search of a position allocates only for the result it hands back rather than anything per node - and that probing a bitbase allocates nothing
+bool test_search_allocations() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "chess_search_allocation_test";
+    generate_test_bitbases(directory);
 
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    bool allocation_free = true;
+    {
+        std::shared_ptr<const Bitbase_Set> bitbases(new Bitbase_Set(directory.string()));
+        new_game.from_fen("7k/8/8/8/8/8/8/K5R1 w - - 0 1");
+        counted_allocations = 0;
+        counting_allocations = true;
+        BITBASE_RESULT result = bitbases->probe(new_game);
+        counting_allocations = false;
+        allocation_free = result == BITBASE_WIN && counted_allocations == 0;
+
+        std::shared_ptr<Transposition_Table> table(new Transposition_Table(1 << 16));
+        Searcher searcher(table, bitbases);
+        search_limits limits;
+        limits.depth = 4;
+        new_game.from_fen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+
+        // The first search sizes the arena and the searchers copy of the board
+        searcher.search(new_game, limits);
+        table->clear(1);
+        counted_allocations = 0;
+        counting_allocations = true;
+        search_result second = searcher.search(new_game, limits);
+        counting_allocations = false;
+
+        // A few allocations per iteration build the returned lines - nothing that grows with the nodes searched
+        allocation_free = allocation_free && second.nodes > 1000 && counted_allocations <= 10 * limits.depth;
+    }
+    std::filesystem::remove_all(directory);
+    return allocation_free;
+}
 
-    // Testing modifying a piece grabbed - ensuring constness from and external source
-    try {
-        if (!test_constness_get_location()) {
-            cout << "   ERROR: The game allowed pieces to be modified externally" << endl;
-            ++errors;
+// Tests that unmaking every opening move and every reply restores the board and the hash key
+bool test_make_unmake_move() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+    uint64_t start_key = new_game.get_hash_key();
+
+    std::vector<board_move> moves = new_game.get_valid_moves();
+    for (int i = 0; i < moves.size(); ++i) {
+        Game::move_record record = new_game.make_move(moves[i].first, moves[i].second);
+        if (new_game.get_hash_key() == start_key) {
+            return false;
         }
-    } catch(exception e) {
-        cout << "   ERROR: test_constness_get_location threw an error: " << e.what() << endl;
-        ++errors;
-    }
 
+        std::vector<board_move> replies = new_game.get_valid_moves();
+        for (int j = 0; j < replies.size(); ++j) {
+            uint64_t key = new_game.get_hash_key();
+            Game::move_record reply_record = new_game.make_move(replies[j].first, replies[j].second);
+            new_game.unmake_move(reply_record);
+            if (new_game.get_hash_key() != key) {
+                return false;
+            }
+        }
 
-    // Testing adding a random piece to the board
-    try {
-        if (!test_adding_piece_to_same_spot()) {
-            cout << "   ERROR: The board allowed a piece to be placed on top of another piece" << endl;
-            ++errors;
+        new_game.unmake_move(record);
+        if (new_game.get_hash_key() != start_key || !(*new_game.get_current_player() == *player1)) {
+            return false;
         }
-    } catch(exception e) {
-        cout << "   ERROR: test_adding_piece_to_same_spot threw an error: " << e.what() << endl;
-        ++errors;
     }
 
-
-    // Testing adding many pieces to the board
-    try {
-        if (!test_adding_many_pieces()) {
-            cout << "   ERROR: An issue occured while attempting to add many pieces to the game board" << endl;
-            ++errors;
+    // The board itself must be back to the default setup
+    Game default_game(player1, player2);
+    default_game.setup_default_board_state();
+    for (int i = 0; i < DEFAULT_CHESS_BOARD_SIZE; ++i) {
+        for (int j = 0; j < DEFAULT_CHESS_BOARD_SIZE; ++j) {
+            game_piece piece = new_game.get_location(std::make_pair(i, j));
+            game_piece default_piece = default_game.get_location(std::make_pair(i, j));
+            if (piece.type != default_piece.type || piece.color != default_piece.color) {
+                return false;
+            }
         }
-    } catch(exception e) {
-        cout << "   ERROR: test_adding_many_pieces threw an error: " << e.what() << endl;
-        ++errors;
     }
 
+    return true;
+}
 
-    // Testing adding pieces to invalid locations on the board
-    try {
-        if (!test_adding_piece_to_invalid_location()) {
-            cout << "   ERROR: The board allowed a piece to be created outside the board bounds" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_adding_piece_to_invalid_location threw an error: " << e.what() << endl;
-        ++errors;
+// Back rank mate shared by the search tests - the rook to a8 is the only mate
+static const std::string BACK_RANK_MATE_FEN = "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1";
+
+// Tests that the computer finds a mate in one and keeps pondering without getting in the way of the next turn
+bool test_computer_finds_mate() {
+    shared_ptr<Computer_Player> computer(new Computer_Player(nullptr, GAME_PIECE_COLOR::WHITE, DIFFICULTY::MEDIUM));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(computer, player2);
+    computer->set_internal_game(&new_game);
+    computer->set_bitbases(nullptr);
+
+    new_game.from_fen(BACK_RANK_MATE_FEN);
+
+    std::pair<std::string, std::string> move = computer->take_turn();
+    if (move != std::make_pair(std::string("a1"), std::string("a8"))) {
+        return false;
     }
 
+    // Asking again while the ponder search runs on the unchanged position has to give the same answer
+    move = computer->take_turn();
+    return move == std::make_pair(std::string("a1"), std::string("a8"));
+}
 
-    // Testing removing pieces from the game board
-    try {
-        if (!test_removing_piece()) {
-            cout << "   ERROR: The board did not successfully remove the piece" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_removing_piece threw an error: " << e.what() << endl;
-        ++errors;
+// Tests that the ponder search never keeps the computer alive - the last owner letting go stops the search on its own thread
+bool test_ponder_releases_players() {
+    shared_ptr<Computer_Player> computer(new Computer_Player(nullptr, GAME_PIECE_COLOR::WHITE, DIFFICULTY::EXPERT));
+    std::weak_ptr<Computer_Player> watcher = computer;
+    {
+        shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+        Game new_game(computer, player2);
+        new_game.setup_default_board_state();
+        computer->set_internal_game(&new_game);
+        computer->set_bitbases(nullptr);
+        computer->take_turn();
+        computer->set_internal_game(nullptr);
     }
 
+    // The ponder search is still running - its copy of the game must not be holding on to the computer
+    computer.reset();
+    return watcher.expired();
+}
 
-    // Testing removing nothing from the game board
+// Tests that the computer refuses to make up a move when it has no game or the position has no legal move
+bool test_computer_without_move() {
+    shared_ptr<Computer_Player> computer(new Computer_Player(nullptr, GAME_PIECE_COLOR::BLACK, DIFFICULTY::EASY));
+    computer->set_bitbases(nullptr);
+    bool threw = false;
     try {
-        if (!test_removing_no_piece()) {
-            cout << "   ERROR: The game had an issue attempting to remove nothing from the board" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_removing_no_piece threw an error: " << e.what() << endl;
-        ++errors;
+        computer->take_turn();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    if (!threw) {
+        return false;
     }
-    
 
-    // Testing removing invalid locations from the board
+    // Stalemated in the corner
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    Game new_game(player1, computer);
+    new_game.from_fen("k7/8/1Q6/8/8/8/8/7K b - - 0 1");
+    computer->set_internal_game(&new_game);
+    threw = false;
     try {
-        if (!test_removing_invalid_locations()) {
-            cout << "   ERROR: The game allowed removal of locations outside the bounds" << endl;
-            ++errors;
-        }
-    } catch(exception e) {
-        cout << "   ERROR: test_removing_invalid_locations threw an error: " << e.what() << endl;
-        ++errors;
+        computer->take_turn();
+    } catch (const std::runtime_error&) {
+        threw = true;
     }
+    computer->set_internal_game(nullptr);
+    return threw;
+}
+
+// Tests that moving the knights out and back twice draws by threefold repetition - and only on the third time
+bool test_threefold_repetition() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
 
+    // G1 - F3, G8 - F6, F3 - G1, F6 - G8
+    std::vector<board_move> knight_moves = {
+        std::make_pair(std::make_pair(0, 6), std::make_pair(2, 5)), std::make_pair(std::make_pair(7, 6), std::make_pair(5, 5)),
+        std::make_pair(std::make_pair(2, 5), std::make_pair(0, 6)), std::make_pair(std::make_pair(5, 5), std::make_pair(7, 6))
+    };
 
-    // Testing the assignment operator to ensure deep copying
-    try {
-        if (!test_assignment_operator() ) {
-            cout << "   ERROR: The game assignment operator did not assign deep data" << endl;
-            ++errors;
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        for (int i = 0; i < knight_moves.size(); ++i) {
+            new_game.make_move(knight_moves[i].first, knight_moves[i].second);
+            new_game.update_game_state();
+
+            bool last_move = repeat == 1 && i == knight_moves.size() - 1;
+            if ((new_game.get_current_game_state() == Game::GAME_STATE::THREEFOLD_REPETITION) != last_move) {
+                return false;
+            }
         }
-    } catch(exception e) {
-        cout << "   ERROR: test_assignment_operator threw an error: " << e.what() << endl;
-        ++errors;
     }
 
+    return new_game.get_halfmove_clock() == 8;
+}
 
-    // Testing the assignment operator to ensure separate data - removal on one copy does not effect the original
-    try {
+// Tests that the halfmove clock counts quiet moves, resets on pawn moves and captures and is restored by unmake_move
+bool test_halfmove_clock() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+
+    // G1 - F3, E7 - E5, B8 - C6, F3 - E5
+    new_game.make_move(std::make_pair(0, 6), std::make_pair(2, 5));
+    if (new_game.get_halfmove_clock() != 1) {
+        return false;
+    }
+
+    new_game.make_move(std::make_pair(6, 4), std::make_pair(4, 4));
+    if (new_game.get_halfmove_clock() != 0) {
+        return false;
+    }
+
+    Game::move_record record = new_game.make_move(std::make_pair(7, 1), std::make_pair(5, 2));
+    Game::move_record capture = new_game.make_move(std::make_pair(2, 5), std::make_pair(4, 4));
+    if (new_game.get_halfmove_clock() != 0) {
+        return false;
+    }
+
+    new_game.unmake_move(capture);
+    if (new_game.get_halfmove_clock() != 1) {
+        return false;
+    }
+
+    new_game.unmake_move(record);
+    return new_game.get_halfmove_clock() == 0;
+}
+
+// Tests that a sliding piece may capture a checking piece even though the squares it slides over would leave the king in check
+bool test_sliding_capture_out_of_check() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+
+    // The black queen on D2 checks the white king on H2 - the white queen on B2 can take it
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::WHITE, std::make_pair(1, 7));
+    new_game.add_piece(GAME_PIECE_TYPE::QUEEN, GAME_PIECE_COLOR::WHITE, std::make_pair(1, 1));
+    new_game.add_piece(GAME_PIECE_TYPE::QUEEN, GAME_PIECE_COLOR::BLACK, std::make_pair(1, 3));
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::BLACK, std::make_pair(7, 0));
+
+    if (new_game.is_valid_move(std::make_pair(1, 1), std::make_pair(1, 3)) != Game::VALID_MOVE) {
+        return false;
+    }
+
+    // Stopping short of the queen still leaves the king in check
+    return new_game.is_valid_move(std::make_pair(1, 1), std::make_pair(1, 2)) == Game::CHECK_MOVE;
+}
+
+// Tests that the search arena hands out aligned memory, reuses it after a rewind and merges its blocks on reset
+bool test_search_arena() {
+    Search_Arena arena(64);
+
+    Search_Arena::marker start = arena.get_marker();
+    char * first_byte = arena.allocate_array<char>(1);
+    uint64_t * first_array = arena.allocate_array<uint64_t>(4);
+    if (reinterpret_cast<uintptr_t>(first_array) % alignof(uint64_t) != 0) {
+        return false;
+    }
+
+    // Larger than a block - a second block has to be added
+    board_move * moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+    if (arena.get_block_count() != 2) {
+        return false;
+    }
+
+    // Rewinding hands back the same memory
+    arena.rewind(start);
+    if (arena.allocate_array<char>(1) != first_byte) {
+        return false;
+    }
+
+    {
+        Arena_Scope scope(arena);
+        arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+    }
+    if (arena.allocate_array<uint64_t>(4) != first_array) {
+        return false;
+    }
+
+    // After a reset everything fits in a single block without asking for more memory
+    size_t capacity = arena.get_capacity();
+    arena.reset();
+    arena.allocate_array<uint64_t>(4);
+    moves = arena.allocate_array<board_move>(MAX_POSITION_MOVES);
+    moves[MAX_POSITION_MOVES - 1] = std::make_pair(std::make_pair(0, 0), std::make_pair(7, 7));
+    return arena.get_block_count() == 1 && arena.get_capacity() == capacity;
+}
+
+// Tests that the mate solver finds the shortest mate with its longest defence and reports when there is no mate
+bool test_mate_solver() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+
+    // White king F6 and rook B1 against the black king on H8 - no mate in 1 but K G6 forces mate in 2
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::WHITE, std::make_pair(5, 5));
+    new_game.add_piece(GAME_PIECE_TYPE::ROOK, GAME_PIECE_COLOR::WHITE, std::make_pair(0, 1));
+    new_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::BLACK, std::make_pair(7, 7));
+
+    Mate_Solver solver;
+    mate_limits limits;
+    limits.max_moves = 1;
+    if (solver.solve(new_game, limits).result != NO_MATE) {
+        return false;
+    }
+
+    limits.max_moves = 3;
+    mate_solution solution = solver.solve(new_game, limits);
+    if (solution.result != MATE_FOUND || solution.mate_in != 2 || solution.line.size() != 3) {
+        return false;
+    }
+
+    // The line has to end in checkmate
+    for (int i = 0; i < solution.line.size(); ++i) {
+        if (new_game.is_valid_move(solution.line[i].first, solution.line[i].second) != Game::VALID_MOVE) {
+            return false;
+        }
+        new_game.make_move(solution.line[i].first, solution.line[i].second);
+    }
+    new_game.update_game_state();
+    if (new_game.get_current_game_state() != Game::GAME_STATE::CHECKMATE) {
+        return false;
+    }
+
+    // A budget too small to decide leaves the answer unknown
+    Game budget_game(player1, player2);
+    budget_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::WHITE, std::make_pair(5, 5));
+    budget_game.add_piece(GAME_PIECE_TYPE::ROOK, GAME_PIECE_COLOR::WHITE, std::make_pair(0, 1));
+    budget_game.add_piece(GAME_PIECE_TYPE::KING, GAME_PIECE_COLOR::BLACK, std::make_pair(7, 7));
+    limits.nodes = 2;
+    return solver.solve(budget_game, limits).result == MATE_UNKNOWN;
+}
+
+// Tests that the Monte Carlo engine finds a mate in one on several threads and reports its playouts
+bool test_monte_carlo_finds_mate() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+
+    new_game.from_fen(BACK_RANK_MATE_FEN);
+
+    Monte_Carlo_Searcher searcher;
+    monte_carlo_limits limits;
+    limits.playouts = 3000;
+    limits.threads = 2;
+    limits.seed = 1;
+    monte_carlo_result result = searcher.search(new_game, limits);
+
+    board_move mate = std::make_pair(std::make_pair(0, 0), std::make_pair(7, 0));
+    if (result.best_move != mate || result.playouts < limits.playouts || result.threads != 2 || result.playouts_per_second_per_thread <= 0.0) {
+        return false;
+    }
+
+    // The computer player uses the same engine when asked to
+    shared_ptr<Computer_Player> computer(new Computer_Player(&new_game, GAME_PIECE_COLOR::WHITE, DIFFICULTY::MEDIUM));
+    computer->set_bitbases(nullptr);
+    computer->set_engine(MONTE_CARLO);
+    return computer->take_turn() == std::make_pair(std::string("a1"), std::string("a8"));
+}
+
+// Tests that every share runs once even when called from a worker of a busy pool and that a share's exception reaches the caller
+bool test_thread_pool_run_shares() {
+    std::shared_ptr<Thread_Pool> pool = std::make_shared<Thread_Pool>(2);
+    std::vector<std::atomic<int>> runs(8);
+    for (int i = 0; i < runs.size(); ++i) {
+        runs[i] = 0;
+    }
+
+    // Both workers are taken by the outer shares so the inner calls have to run their own shares
+    pool->run_shares(2, [&pool, &runs](unsigned int outer) {
+        pool->run_shares(4, [&runs, outer](unsigned int inner) {
+            ++runs[(outer * 4) + inner];
+        });
+    });
+    for (int i = 0; i < runs.size(); ++i) {
+        if (runs[i] != 1) {
+            return false;
+        }
+    }
+
+    try {
+        pool->run_shares(3, [](unsigned int share) {
+            if (share == 1) {
+                throw std::runtime_error("share failed");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        return Thread_Pool::resolve_thread_count(0) >= 1 && Thread_Pool::resolve_thread_count(3) == 3;
+    }
+    return false;
+}
+
+// Tests that a batch is searched on every worker and the results come back in the order of the positions
+bool test_analyze_batch() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game mate_game(player1, player2);
+    mate_game.from_fen(BACK_RANK_MATE_FEN);
+
+    Game opening_game(player1, player2);
+    opening_game.setup_default_board_state();
+
+    std::vector<Game> positions;
+    for (int i = 0; i < 6; ++i) {
+        positions.push_back(i % 2 == 0 ? mate_game : opening_game);
+    }
+
+    Batch_Analyzer analyzer(std::make_shared<Thread_Pool>(3));
+    analyzer.set_bitbases(nullptr);
+    search_limits limits;
+    limits.depth = 2;
+
+    std::vector<size_t> order;
+    std::vector<search_result> results(positions.size());
+    analyzer.analyze_batch(positions, limits, [&order, &results](size_t index, const search_result& result) {
+        order.push_back(index);
+        results[index] = result;
+    });
+
+    board_move mate = std::make_pair(std::make_pair(0, 0), std::make_pair(7, 0));
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (order[i] != i || results[i].best_move.first.first == -1) {
+            return false;
+        }
+        if (i % 2 == 0 && results[i].best_move != mate) {
+            return false;
+        }
+    }
+
+    // A searched position always has the same result whichever worker searched it
+    std::vector<search_result> again = analyzer.analyze_batch(positions, limits);
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (again[i].best_move != results[i].best_move || again[i].nodes != results[i].nodes) {
+            return false;
+        }
+    }
+    return order.size() == positions.size();
+}
+
+// Tests that the move picker hands out every legal move once with the hash move first and captures before quiet moves
+bool test_move_picker() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    // After 1. e4 d5 white can take on d5
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+    new_game.make_move(std::make_pair(1, 4), std::make_pair(3, 4));
+    new_game.make_move(std::make_pair(6, 3), std::make_pair(4, 3));
+    new_game.update_game_state();
+
+    std::vector<board_move> valid_moves = new_game.get_valid_moves();
+    board_move hash_move = std::make_pair(std::make_pair(0, 6), std::make_pair(2, 5));
+    board_move capture = std::make_pair(std::make_pair(3, 4), std::make_pair(4, 3));
+
+    Search_Arena arena;
+    std::vector<board_move> picked;
+    {
+        Arena_Scope scope(arena);
+        Move_Picker picker(new_game, arena, hash_move, nullptr, true);
+        board_move move;
+        while (picker.next(move)) {
+            picked.push_back(move);
+        }
+    }
+
+    if (picked.size() != valid_moves.size() || picked[0] != hash_move || picked[1] != capture) {
+        return false;
+    }
+    for (int i = 0; i < picked.size(); ++i) {
+        if (std::count(picked.begin(), picked.end(), picked[i]) != 1 || std::count(valid_moves.begin(), valid_moves.end(), picked[i]) != 1) {
+            return false;
+        }
+    }
+
+    // Without quiet moves the quiet hash move is dropped and only the capture is left
+    Arena_Scope scope(arena);
+    Move_Picker captures_only(new_game, arena, hash_move, nullptr, false);
+    board_move move;
+    if (!captures_only.next(move) || move != capture) {
+        return false;
+    }
+    return !captures_only.next(move);
+}
+
+// Tests that the hash key kept up by make_move matches the key worked out from the board after the same moves - castling included
+bool test_incremental_hash_key() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game made_game(player1, player2);
+    made_game.setup_default_board_state();
+    Game played_game(made_game);
+    uint64_t start_key = made_game.get_hash_key();
+
+    // 1. e4 e5 2. Nf3 Nc6 3. Bc4 Bc5 4. O-O
+    std::vector<board_move> moves = {
+        std::make_pair(std::make_pair(1, 4), std::make_pair(3, 4)), std::make_pair(std::make_pair(6, 4), std::make_pair(4, 4)),
+        std::make_pair(std::make_pair(0, 6), std::make_pair(2, 5)), std::make_pair(std::make_pair(7, 1), std::make_pair(5, 2)),
+        std::make_pair(std::make_pair(0, 5), std::make_pair(3, 2)), std::make_pair(std::make_pair(7, 5), std::make_pair(4, 2)),
+        std::make_pair(std::make_pair(0, 4), std::make_pair(0, 6))
+    };
+
+    std::vector<Game::move_record> records;
+    for (int i = 0; i < moves.size(); ++i) {
+        records.push_back(made_game.make_move(moves[i].first, moves[i].second));
+        played_game.play_move(moves[i].first, moves[i].second);
+        played_game.swap_current_player();
+        if (made_game.get_hash_key() != played_game.get_hash_key()) {
+            return false;
+        }
+    }
+
+    while (!records.empty()) {
+        made_game.unmake_move(records.back());
+        records.pop_back();
+    }
+    return made_game.get_hash_key() == start_key;
+}
+
+// Tests that the transposition table keeps entries until it is cleared or resized and sizes itself to powers of two
+bool test_transposition_table_resize() {
+    Transposition_Table table(1000);
+    if (table.get_entry_count() != 512) {
+        return false;
+    }
+
+    tt_entry entry;
+    table.store(12345, 4, 100, TT_EXACT, 12, 28);
+    table.prefetch(12345);
+    if (!table.probe(12345, entry) || entry.score != 100 || entry.start_square != 12) {
+        return false;
+    }
+
+    table.clear(4);
+    if (table.probe(12345, entry)) {
+        return false;
+    }
+
+    // A megabyte holds the largest power of two entries that fit
+    table.store(12345, 4, 100, TT_EXACT, 12, 28);
+    table.resize_megabytes(1);
+    if (table.probe(12345, entry) || table.get_size_bytes() > (size_t(1) << 20) || table.get_size_bytes() * 2 <= (size_t(1) << 20)) {
+        return false;
+    }
+
+    table.store(12345, 4, 100, TT_EXACT, 12, 28);
+    return table.probe(12345, entry);
+}
+
+// Tests that a search reports its statistics and an info line for every completed iteration
+bool test_search_statistics() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+
+    // Passing and taking the pass back leaves the same position
+    uint64_t start_key = new_game.get_hash_key();
+    Game::move_record record = new_game.make_null_move();
+    if (new_game.get_hash_key() == start_key || new_game.get_current_player() != player2) {
+        return false;
+    }
+    new_game.unmake_null_move(record);
+    if (new_game.get_hash_key() != start_key || new_game.get_current_player() != player1) {
+        return false;
+    }
+
+    Searcher searcher(std::make_shared<Transposition_Table>(DEFAULT_ANALYSIS_TABLE_ENTRIES), nullptr);
+    std::vector<std::string> lines;
+    search_limits limits;
+    limits.depth = 4;
+    limits.on_info = [&lines](const std::string& line) {
+        lines.push_back(line);
+    };
+
+    search_result result = searcher.search(new_game, limits);
+    const search_statistics& statistics = result.statistics;
+    if (result.depth != 4 || lines.size() != 4 || statistics.iteration_ms.size() != 4) {
+        return false;
+    }
+    for (int i = 0; i < lines.size(); ++i) {
+        if (lines[i].find("info depth " + std::to_string(i + 1) + " ") != 0 || lines[i].find(" pv ") == std::string::npos) {
+            return false;
+        }
+    }
+
+    if (statistics.nodes != result.nodes || statistics.depth != 4 || statistics.quiescence_nodes == 0 || statistics.quiescence_nodes >= statistics.nodes) {
+        return false;
+    }
+    if (statistics.selective_depth < 4 || statistics.table_probes == 0 || statistics.cutoffs == 0 || statistics.null_move_tries == 0) {
+        return false;
+    }
+    return statistics.table_hit_rate <= 1.0 && statistics.first_move_cutoff_rate > 0.0 && statistics.first_move_cutoff_rate <= 1.0
+        && statistics.null_move_success_rate <= 1.0;
+}
+
+// Tests that a multi-PV search finds a line for each of the best moves - best first and each led by a different move
+bool test_multi_pv() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game new_game(player1, player2);
+    new_game.from_fen(BACK_RANK_MATE_FEN);
+
+    Searcher searcher(std::make_shared<Transposition_Table>(DEFAULT_ANALYSIS_TABLE_ENTRIES), nullptr);
+    std::vector<std::string> info_lines;
+    search_limits limits;
+    limits.depth = 3;
+    limits.multi_pv = 3;
+    limits.on_info = [&info_lines](const std::string& line) {
+        info_lines.push_back(line);
+    };
+
+    search_result result = searcher.search(new_game, limits);
+    board_move mate = std::make_pair(std::make_pair(0, 0), std::make_pair(7, 0));
+    if (result.lines.size() != 3 || result.lines[0].move != mate || result.best_move != mate || result.score < MATE_SCORE - MAX_SEARCH_PLY) {
+        return false;
+    }
+
+    for (int i = 0; i < result.lines.size(); ++i) {
+        const search_line& line = result.lines[i];
+        if (line.depth != 3 || line.principal_variation.empty() || line.principal_variation[0] != line.move) {
+            return false;
+        }
+        for (int j = 0; j < i; ++j) {
+            if (result.lines[j].move == line.move || result.lines[j].score < line.score) {
+                return false;
+            }
+        }
+    }
+
+    // Every iteration reports each of its lines
+    return info_lines.size() == 9 && info_lines.back().find(" multipv 3 ") != std::string::npos;
+}
+
+// Tests that the evaluation adds up from its trace and that the tuner reads labelled positions and lowers their error on any number of threads
+bool test_evaluation_tuner() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+    new_game.make_move(std::make_pair(1, 4), std::make_pair(3, 4));
+    new_game.make_move(std::make_pair(7, 6), std::make_pair(5, 5));
+    new_game.remove_piece(std::make_pair(7, 1));
+
+    evaluation_trace trace = trace_evaluation(new_game);
+    int white_score = 0;
+    for (int i = 0; i < EVALUATION_TERM_COUNT; ++i) {
+        white_score += trace[i] * EVALUATION_WEIGHTS[i];
+    }
+    if (trace[TERM_KNIGHT] != 1 || evaluate(new_game) != white_score) {
+        return false;
+    }
+
+    // White a knight up wins, level positions are drawn and black a knight up wins - the last line has no result
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_tuner_test.epd").string();
+    {
+        std::ofstream output(file_path);
+        output << "r1bqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - c9 \"1-0\";" << std::endl;
+        output << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - c9 \"1/2-1/2\";" << std::endl;
+        output << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/R1BQKBNR w KQkq - c9 \"0-1\";" << std::endl;
+        output << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -" << std::endl;
+    }
+
+    Evaluation_Tuner tuner;
+    size_t loaded = tuner.load_positions(file_path);
+    std::filesystem::remove(file_path);
+    if (loaded != 3) {
+        return false;
+    }
+    for (int i = 0; i < 20; ++i) {
+        tuner.add_position(new_game, i % 4 == 0 ? 1 : 2);
+    }
+
+    tuner.fit_scaling(1);
+    double start_error = tuner.compute_error(tuner.get_weights(), 1);
+    if (fabs(start_error - tuner.compute_error(tuner.get_weights(), 3)) > 1e-12) {
+        return false;
+    }
+
+    tuning_limits limits;
+    limits.iterations = 50;
+    limits.threads = 2;
+    tuning_weights weights = tuner.tune(limits);
+    return tuner.compute_error(weights, 1) < start_error;
+}
+
+// Tests that the tournament plays every game with both colors and that the SPRT leans towards the engine that scores better
+bool test_tournament() {
+    // The same seed always builds the same opening
+    std::vector<board_move> opening = Tournament::make_opening(7, 6);
+    if (opening.size() != 6 || Tournament::make_opening(7, 6) != opening) {
+        return false;
+    }
+
+    if (Tournament::compute_llr(60, 20, 20, 0.0, 5.0) <= 0.0 || Tournament::compute_llr(20, 20, 60, 0.0, 5.0) >= 0.0
+        || Tournament::compute_llr(0, 0, 0, 0.0, 5.0) != 0.0) {
+        return false;
+    }
+
+    tournament_engine first;
+    tournament_engine second;
+    first.difficulty = DIFFICULTY::VERY_EASY;
+    second.difficulty = DIFFICULTY::VERY_EASY;
+
+    tournament_limits limits;
+    limits.games = 4;
+    limits.threads = 2;
+    limits.max_plies = 20;
+    limits.seed = 11;
+    limits.sprt = false;
+
+    int reports = 0;
+    Tournament tournament(first, second);
+    tournament_result result = tournament.run(limits, [&reports](const tournament_result&) {
+        ++reports;
+    });
+    if (reports != 4 || result.wins + result.draws + result.losses != 4 || result.sprt_result != SPRT_CONTINUE) {
+        return false;
+    }
+
+    // Identical engines score the same with either color from the same opening
+    return result.wins == result.losses && result.lower_bound < 0.0 && result.upper_bound > 0.0;
+}
+
+// Tests that the weak difficulties stay within their node limits and that their blunders depend only on the seed and the position
+bool test_weak_difficulty() {
+    int blunders = 0;
+    std::pair<std::string, std::string> first_moves[2];
+    for (uint64_t seed = 1; seed <= 40; ++seed) {
+        for (int replay = 0; replay < 2; ++replay) {
+            shared_ptr<Computer_Player> computer(new Computer_Player(nullptr, GAME_PIECE_COLOR::WHITE, DIFFICULTY::EASY));
+            shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            Game new_game(computer, player2);
+            new_game.setup_default_board_state();
+            computer->set_internal_game(&new_game);
+            computer->set_blunder_seed(seed);
+
+            first_moves[replay] = computer->take_turn();
+            search_result result = computer->get_last_search_result();
+            if (result.best_move.first.first == -1) {
+                blunders += replay == 0 ? 1 : 0;
+            } else if (result.nodes > DIFFICULTY_NODE_LIMITS[DIFFICULTY::EASY]) {
+                return false;
+            }
+        }
+
+        // The same seed in the same position always plays the same move
+        if (first_moves[0] != first_moves[1]) {
+            return false;
+        }
+    }
+
+    return blunders > 0 && blunders < 40;
+}
+
+// Tests that FEN strings load every part of the position and come back out unchanged
+bool test_fen() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+
+    Game default_game(player1, player2);
+    default_game.setup_default_board_state();
+    std::string start_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    if (default_game.to_fen() != start_fen) {
+        return false;
+    }
+
+    // E2 - E4 leaves an en passant square and black on move
+    default_game.make_move(std::make_pair(1, 4), std::make_pair(3, 4));
+    std::string after_fen = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1";
+    if (default_game.to_fen() != after_fen) {
+        return false;
+    }
+
+    Game new_game(player1, player2);
+    new_game.from_fen(after_fen);
+    if (new_game.to_fen() != after_fen || new_game.get_hash_key() != default_game.get_hash_key()) {
+        return false;
+    }
+
+    // Castling rights and the move counters survive the round trip - the kings side rook that lost its right can't castle
+    std::string castling_fen = "r3k2r/8/8/8/8/8/8/R3K2R w Qk - 5 20";
+    new_game.from_fen(castling_fen);
+    if (new_game.to_fen() != castling_fen || new_game.get_halfmove_clock() != 5 || new_game.get_fullmove_number() != 20) {
+        return false;
+    }
+    if (new_game.is_valid_move(std::make_pair(0, 4), std::make_pair(0, 6)) == Game::VALID_MOVE
+        || new_game.is_valid_move(std::make_pair(0, 4), std::make_pair(0, 2)) != Game::VALID_MOVE) {
+        return false;
+    }
+
+    // Every move of a busy position is found - missing counters take their starting values
+    new_game.from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+    if (new_game.get_valid_moves().size() != 48 || new_game.get_fullmove_number() != 1) {
+        return false;
+    }
+
+    // A malformed FEN leaves the game as it was
+    std::string before = new_game.to_fen();
+    const std::string bad_fens[] = {"8/8/8/8/8/8/8/8 w - - 0 1", "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1"};
+    for (const std::string& bad_fen : bad_fens) {
+        try {
+            new_game.from_fen(bad_fen);
+            return false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    return new_game.to_fen() == before;
+}
+
+// Tests that PGN games are split out with their tags and that their moves are played out to the same position
+bool test_pgn_reader() {
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_pgn_test.pgn").string();
+    {
+        std::ofstream output(file_path);
+        output << "[Event \"Paris\"]\n[White \"Morphy\"]\n[Black \"Duke of Brunswick and Count Isouard\"]\n[Result \"1-0\"]\n\n";
+        output << "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n";
+        output << "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n";
+        output << "14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n\n";
+
+        // Comments, variations, glyphs and move numbers against the moves - the last move is en passant
+        output << "[Event \"Annotated\"]\n\n";
+        output << "1.e4 {best by test} a6 (1...c5 2. Nf3 (2. c3) d6) 2. e5 $1 d5 ; a line comment\n3. exd6 1/2-1/2\n\n";
+
+        // Rooks on the same file need their rank - a knight promotion can't be played
+        output << "[FEN \"k7/P7/8/8/R7/8/8/R3K3 w - - 0 1\"]\n[SetUp \"1\"]\n\n1. R1a2 Kb7 2. a8=N *\n\n";
+
+        // A game without a result runs into the next one
+        output << "1. d4 d5\n[Event \"Last\"]\n\n1. c4 *\n";
+    }
+
+    std::vector<std::string> events;
+    std::vector<std::vector<board_move>> moves;
+    std::vector<std::string> results;
+    std::vector<std::string> errors;
+    std::vector<std::string> fens;
+    size_t games_read = 0;
+    {
+        PGN_Reader reader(file_path);
+        games_read = reader.read_games([&](const pgn_game& game) {
+            events.push_back(std::string(game.get_tag("Event")));
+            moves.push_back(game.moves);
+            results.push_back(std::string(game.result));
+            errors.push_back(std::string(game.error));
+
+            shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+            shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+            Game replay(player1, player2);
+            std::string_view fen = game.get_tag("FEN");
+            replay.from_fen(fen.empty() ? std::string_view(STARTING_POSITION_FEN) : fen);
+            for (int i = 0; i < game.moves.size(); ++i) {
+                replay.make_move(game.moves[i].first, game.moves[i].second);
+            }
+            fens.push_back(replay.to_fen());
+        });
+    }
+    std::filesystem::remove(file_path);
+
+    if (games_read != 5 || events[0] != "Paris" || events[1] != "Annotated" || events[4] != "Last") {
+        return false;
+    }
+
+    // The opera game ends in mate on d8
+    if (moves[0].size() != 33 || results[0] != "1-0" || !errors[0].empty() || fens[0] != "1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17") {
+        return false;
+    }
+
+    // Only the main line is played and the pawn taken en passant is gone
+    if (moves[1].size() != 5 || results[1] != "1/2-1/2" || fens[1] != "rnbqkbnr/1pp1pppp/p2P4/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3") {
+        return false;
+    }
+
+    if (moves[2].size() != 2 || errors[2] != "a8=N" || results[2] != "*" || moves[2][0] != std::make_pair(std::make_pair(0, 0), std::make_pair(1, 0))) {
+        return false;
+    }
+
+    return moves[3].size() == 2 && results[3].empty() && moves[4].size() == 1 && results[4] == "*";
+}
+
+// Tests that the PGN pipeline splits a file on game boundaries and hands back the same games and positions in order on any number of threads
+bool test_pgn_pipeline() {
+    std::string opera_game = "[Event \"Paris\"]\n[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+        "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n\n";
+    std::string short_game = "[Event \"Short\"]\n[Result \"1/2-1/2\"]\n\n1. e4 {a comment with [brackets]} a6 (1... c5) 2. e5 d5 3. exd6 1/2-1/2\n\n";
+    std::string bad_game = "[Event \"Bad\"]\n\n1. e4 e5 2. Ke3 *\n\n";
+
+    std::string text;
+    for (int i = 0; i < 20; ++i) {
+        text += i % 4 == 3 ? bad_game : (i % 2 == 0 ? opera_game : short_game);
+    }
+
+    // Every chunk ends where a game's tags begin
+    std::vector<std::string_view> chunks = PGN_Pipeline::split_chunks(text, 300);
+    size_t covered = 0;
+    for (int i = 0; i < chunks.size(); ++i) {
+        if (i > 0 && chunks[i].substr(0, 8) != "[Event \"") {
+            return false;
+        }
+        covered += chunks[i].size();
+    }
+    if (chunks.size() < 4 || covered != text.size()) {
+        return false;
+    }
+
+    pgn_pipeline_limits limits;
+    limits.position_stride = 10;
+    limits.skip_plies = 10;
+    pgn_chunk_result expected = PGN_Pipeline::read_chunk(text, limits);
+    if (expected.games != 20 || expected.white_wins != 10 || expected.draws != 5 || expected.no_results != 5 || expected.unplayable_games != 5
+        || expected.positions.size() != 20) {
+        return false;
+    }
+
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_pipeline_test.pgn").string();
+    {
+        std::ofstream output(file_path, std::ios::binary);
+        output << text;
+    }
+
+    // A chunk per game is far more chunks than the workers may run ahead of the callback
+    limits.threads = 3;
+    limits.chunk_bytes = 1;
+    std::vector<pgn_position> positions;
+    size_t next_index = 0;
+    bool in_order = true;
+    pgn_chunk_result total;
+    {
+        PGN_Pipeline pipeline(file_path);
+        total = pipeline.run(limits, [&](size_t index, const pgn_chunk_result& chunk) {
+            in_order = in_order && index == next_index++;
+            positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        });
+    }
+    std::filesystem::remove(file_path);
+
+    if (!in_order || total.games != expected.games || total.moves != expected.moves || total.unplayable_games != expected.unplayable_games
+        || positions.size() != expected.positions.size()) {
+        return false;
+    }
+    for (int i = 0; i < positions.size(); ++i) {
+        if (positions[i].fen != expected.positions[i].fen || positions[i].white_half_points != 2) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tests that game records come back from a file with the same moves and take about a byte per move
+bool test_game_record() {
+    std::string pgn = "1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+        "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n\n"
+        "[FEN \"r3k2r/8/8/8/5p2/8/4P3/R3K2R w KQkq - 0 1\"]\n\n1. e4 fxe3 2. O-O O-O-O 3. Rab1 *\n";
+    std::vector<game_record> records;
+    PGN_Reader::read_games(pgn, [&records](const pgn_game& game) {
+        game_record record;
+        record.start_fen = std::string(game.get_tag("FEN"));
+        record.white_half_points = game.get_white_half_points();
+        record.moves = game.moves;
+        records.push_back(record);
+    });
+    if (records.size() != 2 || records[0].moves.size() != 33 || records[1].moves.size() != 5) {
+        return false;
+    }
+
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_record_test.cgr").string();
+    {
+        Game_Record_Writer writer(file_path);
+        for (int i = 0; i < 100; ++i) {
+            writer.write(records[i % 2]);
+        }
+
+        // A move that can't be played is refused without leaving part of the record behind
+        game_record bad_record;
+        bad_record.moves.push_back(std::make_pair(std::make_pair(1, 4), std::make_pair(4, 4)));
+        try {
+            writer.write(bad_record);
+            return false;
+        } catch (const std::runtime_error&) {
+        }
+        writer.flush();
+    }
+
+    // Header byte plus a move count byte plus a byte per move - the second game also carries its FEN
+    size_t expected_size = 4 + (50 * (2 + 33)) + (50 * (2 + 1 + records[1].start_fen.size() + 5));
+    if (std::filesystem::file_size(file_path) != expected_size) {
+        std::filesystem::remove(file_path);
+        return false;
+    }
+
+    size_t records_read = 0;
+    bool same = true;
+    {
+        Game_Record_Reader reader(file_path);
+        game_record record;
+        while (reader.next(record)) {
+            const game_record& expected = records[records_read % 2];
+            same = same && record.start_fen == expected.start_fen && record.white_half_points == expected.white_half_points && record.moves == expected.moves;
+            ++records_read;
+        }
+    }
+    std::filesystem::remove(file_path);
+    if (!same || records_read != 100) {
+        return false;
+    }
+
+    // A record cut short is reported rather than read past its end
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game board(player1, player2);
+    std::vector<uint8_t> bytes;
+    encode_game_record(records[0], board, bytes);
+    game_record record;
+    if (decode_game_record(bytes.data(), bytes.size(), board, record) != bytes.size() || record.moves != records[0].moves) {
+        return false;
+    }
+    try {
+        decode_game_record(bytes.data(), bytes.size() - 1, board, record);
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+    return true;
+}
+
+// Tests that packed positions come back from a file as the same positions with their scores and results
+bool test_packed_position() {
+    std::vector<std::string> fens = {STARTING_POSITION_FEN, "rnbqkbnr/1pp1pppp/p7/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3",
+        "r3k2r/8/8/8/8/8/8/R3K2R b Kq - 12 40", "1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17", "8/8/8/4k3/8/8/8/4K3 w - - 99 300"};
+
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game board(player1, player2);
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_packed_test.cpp1").string();
+    {
+        Packed_Position_Writer writer(file_path);
+        for (int i = 0; i < fens.size(); ++i) {
+            board.from_fen(fens[i]);
+            writer.write(board, (i * 100) - 200, (i % 4) - 1);
+        }
+
+        // Mate scores are clamped to fit
+        writer.write(board, 1000000, 2);
+        writer.flush();
+    }
+
+    if (std::filesystem::file_size(file_path) != 8 + ((fens.size() + 1) * sizeof(packed_position))) {
+        std::filesystem::remove(file_path);
+        return false;
+    }
+
+    bool same = true;
+    {
+        Packed_Position_Reader reader(file_path);
+        same = reader.get_position_count() == fens.size() + 1 && reader.get_position(fens.size()).score == INT16_MAX;
+        for (int i = 0; same && i < fens.size(); ++i) {
+            reader.load_position(i, board);
+            const packed_position& position = reader.get_position(i);
+            same = board.to_fen() == fens[i] && position.score == (i * 100) - 200 && position.get_white_half_points() == (i % 4) - 1;
+        }
+    }
+    std::filesystem::remove(file_path);
+    if (!same) {
+        return false;
+    }
+
+    // A device that is always full fails the flush rather than losing the positions silently - only where there is one
+    if (std::filesystem::exists("/dev/full")) {
+        Packed_Position_Writer full_writer("/dev/full");
+        full_writer.write(board, 0, 1);
+        try {
+            full_writer.flush();
+            return false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+
+    // The position played on from a decoded board plays like the one loaded from the FEN - en passant included
+    board.from_fen(fens[1]);
+    packed_position packed;
+    board.to_packed(packed);
+    Game decoded(player1, player2);
+    decoded.from_packed(packed);
+    if (decoded.is_valid_move(std::make_pair(4, 4), std::make_pair(5, 3)) != Game::VALID_MOVE || decoded.get_hash_key() != board.get_hash_key()) {
+        return false;
+    }
+
+    // A second white king is refused and leaves the game as it was
+    packed.pieces[0] = static_cast<uint8_t>((packed.pieces[0] & 0xF0) | (GAME_PIECE_TYPE::KING - GAME_PIECE_TYPE::PAWN));
+    try {
+        decoded.from_packed(packed);
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+    return decoded.to_fen() == fens[1];
+}
+
+// Tests that self-play writes one file per thread holding every position it reports with the result of its game
+bool test_data_generator() {
+    std::string output_path = (std::filesystem::temp_directory_path() / "chess_datagen_test").string();
+    datagen_limits limits;
+    limits.games = 4;
+    limits.threads = 2;
+    limits.nodes = 300;
+    limits.max_plies = 30;
+    limits.skip_plies = 4;
+    limits.seed = 7;
+
+    Data_Generator generator(output_path);
+    int callbacks = 0;
+    datagen_result result = generator.run(limits, [&callbacks](const datagen_result&) {
+        ++callbacks;
+    });
+    if (result.games != 4 || callbacks != 4 || result.positions == 0 || result.white_wins + result.draws + result.black_wins != 4) {
+        return false;
+    }
+
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game board(player1, player2);
+    uint64_t positions = 0;
+    bool valid = true;
+    for (unsigned int t = 0; t < limits.threads; ++t) {
+        std::string shard_path = Data_Generator::get_shard_path(output_path, t);
+        {
+            Packed_Position_Reader reader(shard_path);
+            for (size_t i = 0; i < reader.get_position_count(); ++i) {
+                // Every position decodes and carries the result of a finished game
+                reader.load_position(i, board);
+                valid = valid && reader.get_position(i).get_white_half_points() >= 0 && board.get_current_game_state() == Game::NORMAL;
+            }
+            positions += reader.get_position_count();
+        }
+        std::filesystem::remove(shard_path);
+    }
+    return valid && positions == result.positions;
+}
+
+// Tests that EPD lines are read with their bm, am and id operations and that simple tactics are solved with their time to solution
+bool test_epd_suite() {
+    std::string file_path = (std::filesystem::temp_directory_path() / "chess_epd_test.epd").string();
+    {
+        std::ofstream output(file_path);
+        output << "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - bm Ra8#; id \"back rank; mate\";\n";
+        output << "\n; not a position\n";
+        output << "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - am Kf1 Kh1; id plain;\n";
+        output << "k7/8/1K6/8/8/8/8/7Q w - - hmvc 0; c0 \"no test\";\n";
+
+        // The queen wins the undefended rook
+        output << "4k3/8/8/8/8/8/3r4/3QK3 w - - bm Qxd2 Kxd2; id \"take the rook\";\n";
+    }
+
+    EPD_Suite suite;
+    size_t loaded = suite.load(file_path);
+    std::filesystem::remove(file_path);
+    const std::vector<epd_position>& positions = suite.get_positions();
+    if (loaded != 3 || positions[0].id != "back rank; mate" || positions[0].best_moves.size() != 1 || positions[1].avoid_moves.size() != 2
+        || positions[1].id != "plain" || positions[2].best_moves.size() != 2) {
+        return false;
+    }
+    if (positions[0].best_moves[0] != std::make_pair(std::make_pair(0, 0), std::make_pair(7, 0))) {
+        return false;
+    }
+
+    epd_limits limits;
+    limits.move_time_ms = 0;
+    limits.depth = 4;
+    limits.threads = 2;
+    std::vector<char> reported(positions.size(), 0);
+    epd_summary summary = suite.run(limits, [&reported](const epd_position&, const epd_result& result) {
+        reported[result.index] = result.solved && result.solve_depth >= 1 && result.solve_depth <= result.depth ? 1 : 2;
+    });
+    return summary.positions == 3 && summary.solved == 3 && reported == std::vector<char>(3, 1);
+}
+
+// Tests that the position index finds every position of the games with the games it came from, how they ended and the moves played from it
+bool test_position_index() {
+    std::string pgn_path = (std::filesystem::temp_directory_path() / "chess_index_test.pgn").string();
+    std::string index_path = (std::filesystem::temp_directory_path() / "chess_index_test.cpi").string();
+    {
+        std::ofstream output(pgn_path);
+        output << "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7\n"
+            "8. Nc3 c6 9. Bg5 b5 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7\n14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0\n\n";
+        output << "[Result \"1/2-1/2\"]\n\n1. Nf3 Nf6 2. Ng1 Ng8 3. e4 e5 1/2-1/2\n\n";
+        output << "[Result \"0-1\"]\n\n1. e4 e5 2. Ke3 0-1\n\n";
+        output << "[Result \"*\"]\n\n1. d4 *\n";
+    }
+
+    Position_Index_Builder builder;
+    size_t games = builder.add_pgn(pgn_path);
+    builder.write(index_path);
+    std::filesystem::remove(pgn_path);
+    if (games != 3 || builder.get_next_game_id() != 4) {
+        std::filesystem::remove(index_path);
+        return false;
+    }
+
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game board(player1, player2);
+    position_stats stats;
+    std::vector<uint32_t> game_ids;
+    bool found = true;
+    {
+        Position_Index index(index_path);
+
+        // The start is reached twice in the second game but counts once - the unplayable third game is left out
+        board.from_fen(STARTING_POSITION_FEN);
+        found = found && index.find(board.get_hash_key(), stats) && stats.games == 3 && stats.white_wins == 1 && stats.draws == 1 && stats.black_wins == 0;
+        found = found && index.find_games(board.get_hash_key(), game_ids) && game_ids == std::vector<uint32_t>({0, 1, 3});
+
+        // Both games that played e4 from the start count for it - the second game played Nf3 from there too before coming back
+        std::vector<position_move> moves;
+        found = found && index.get_moves(board.get_hash_key(), moves) == 3;
+        found = found && moves[0].move == std::make_pair(std::make_pair(1, 4), std::make_pair(3, 4)) && moves[0].stats.games == 2
+            && moves[0].stats.white_wins == 1 && moves[0].stats.draws == 1;
+        found = found && moves[1].move == std::make_pair(std::make_pair(0, 6), std::make_pair(2, 5)) && moves[1].stats.games == 1 && moves[1].stats.draws == 1;
+        found = found && moves[2].move == std::make_pair(std::make_pair(1, 3), std::make_pair(3, 3)) && moves[2].stats.games == 1 && moves[2].stats.white_wins == 0;
+
+        // After 1. e4 e5 the opera game and the drawn game meet
+        board.make_move(std::make_pair(1, 4), std::make_pair(3, 4));
+        board.make_move(std::make_pair(6, 4), std::make_pair(4, 4));
+        found = found && index.find_games(board.get_hash_key(), game_ids) && game_ids == std::vector<uint32_t>({0, 1});
+
+        // The final mate only happened in the opera game
+        board.from_fen("1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17");
+        found = found && index.find(board.get_hash_key(), stats) && stats.games == 1 && stats.white_wins == 1 && index.get_moves(board.get_hash_key(), moves) == 0;
+
+        board.from_fen("8/8/8/4k3/8/8/8/4K3 w - - 0 1");
+        found = found && !index.find(board.get_hash_key(), stats) && !index.find_games(board.get_hash_key(), game_ids) && game_ids.empty();
+        found = found && index.get_moves(board.get_hash_key(), moves) == 0 && index.get_position_count() > 30;
+    }
+    std::filesystem::remove(index_path);
+    return found;
+}
+
+// Tests that the opening tree counts the moves played from each position up to the ply limit and is played from like a book
+bool test_opening_tree() {
+    std::string pgn_path = (std::filesystem::temp_directory_path() / "chess_tree_test.pgn").string();
+    std::string tree_path = (std::filesystem::temp_directory_path() / "chess_tree_test.cot").string();
+    {
+        std::ofstream output(pgn_path);
+        output << "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 1-0\n\n";
+        output << "[Result \"1/2-1/2\"]\n\n1. Nf3 Nf6 2. Ng1 Ng8 3. e4 e5 1/2-1/2\n\n";
+        output << "[Result \"0-1\"]\n\n1. e4 e5 2. Ke3 0-1\n\n";
+        output << "[Result \"*\"]\n\n1. d4 *\n";
+    }
+
+    // Small chunks spread the games over both workers
+    opening_tree_limits limits;
+    limits.max_plies = 4;
+    limits.threads = 2;
+    limits.chunk_bytes = 64;
+    size_t games = Opening_Tree::build(pgn_path, tree_path, limits);
+    std::filesystem::remove(pgn_path);
+    if (games != 4) {
+        std::filesystem::remove(tree_path);
+        return false;
+    }
+
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game board(player1, player2);
+    board_move e4 = std::make_pair(std::make_pair(1, 4), std::make_pair(3, 4));
+    board_move nf3 = std::make_pair(std::make_pair(0, 6), std::make_pair(2, 5));
+    board_move d4 = std::make_pair(std::make_pair(1, 3), std::make_pair(3, 3));
+    std::vector<opening_tree_move> moves;
+    bool found = true;
+    {
+        std::shared_ptr<const Opening_Tree> tree(new Opening_Tree(tree_path));
+
+        // The most played move comes first - the unfinished game only counts towards games
+        board.from_fen(STARTING_POSITION_FEN);
+        found = found && tree->get_moves(board.get_hash_key(), moves) == 3 && moves[0].move == e4 && moves[0].stats.games == 2
+            && moves[0].stats.white_wins == 1 && moves[0].stats.black_wins == 1;
+        for (int i = 1; i < moves.size(); ++i) {
+            found = found && moves[i].stats.games == 1 && (moves[i].move == nf3 ? moves[i].stats.draws == 1 : moves[i].move == d4 && moves[i].stats.draws == 0);
+        }
+
+        // Every seed picks one of the moves played
+        for (uint64_t seed = 0; seed < 8; ++seed) {
+            board_move move = tree->choose_move(board, seed);
+            found = found && (move == e4 || move == nf3 || move == d4);
+        }
+
+        // The third game is counted up to the king move that can't be played
+        board.make_move(e4.first, e4.second);
+        found = found && tree->get_moves(board.get_hash_key(), moves) == 1 && moves[0].stats.games == 2;
+
+        // Nothing past the fourth ply is kept
+        board.make_move(std::make_pair(6, 4), std::make_pair(4, 4));
+        board.make_move(nf3.first, nf3.second);
+        board.make_move(std::make_pair(6, 3), std::make_pair(5, 3));
+        found = found && tree->get_moves(board.get_hash_key(), moves) == 0 && tree->choose_move(board, 0).first.first == -1;
+
+        // The computer player plays from the book without searching
+        board.from_fen(STARTING_POSITION_FEN);
+        shared_ptr<Computer_Player> computer(new Computer_Player(&board, GAME_PIECE_COLOR::WHITE, DIFFICULTY::HARD));
+        computer->set_opening_book(tree);
+        computer->set_pondering(false);
+        std::pair<std::string, std::string> move = computer->take_turn();
+        found = found && (move == std::make_pair(std::string("e2"), std::string("e4")) || move == std::make_pair(std::string("g1"), std::string("f3"))
+            || move == std::make_pair(std::string("d2"), std::string("d4"))) && computer->get_last_search_result().depth == 0;
+    }
+    std::filesystem::remove(tree_path);
+    return found;
+}
+
+// Use only when messing with the display settings - not an important unit test
+void test_display() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+    new_game.show_board();
+}
+
+// Use only when messing with play functions - useful for simulating games without needing the higher level API
+void test_simulating_play() {
+    shared_ptr<Player> player1(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::WHITE));
+    shared_ptr<Player> player2(new Human_Player(DEFAULT_HUMAN_NAME, GAME_PIECE_COLOR::BLACK));
+    Game new_game(player1, player2);
+    new_game.setup_default_board_state();
+    new_game.show_board();
+
+    // Player 1's turn
+    std::pair<int, int> player_1_move_start = std::make_pair(1, 5);
+    std::pair<int, int> player_1_move_end = std::make_pair(2, 5);
+
+    // Player 2's turn
+    std::pair<int, int> player_2_move_start = std::make_pair(6, 4);
+    std::pair<int, int> player_2_move_end = std::make_pair(4, 4);
+
+    // F2 - F3
+    if (check_move_error_codes(new_game, player_1_move_start, player_1_move_end).first) {
+        new_game.play_move(player_1_move_start, player_1_move_end);
+    }    
+    new_game.show_board();
+    new_game.swap_current_player();
+    new_game.update_game_state();
+    print_game_state(new_game);
+
+    // E7 - E5
+    if (check_move_error_codes(new_game, player_2_move_start, player_2_move_end).first) {
+        new_game.play_move(player_2_move_start, player_2_move_end);
+    }    
+    new_game.show_board();
+    new_game.swap_current_player();
+    new_game.update_game_state();
+    print_game_state(new_game);
+
+    // Player 1's turn
+    player_1_move_start = std::make_pair(1, 6);
+    player_1_move_end = std::make_pair(3, 6);
+
+    // Player 2's turn
+    player_2_move_start = std::make_pair(7, 3);
+    player_2_move_end = std::make_pair(3, 7);
+
+    // G2 - G4
+    if (check_move_error_codes(new_game, player_1_move_start, player_1_move_end).first) {
+        new_game.play_move(player_1_move_start, player_1_move_end);
+    }    
+    new_game.show_board();
+    new_game.swap_current_player();
+    new_game.update_game_state();
+    print_game_state(new_game);
+
+    // D8 - H4 - Checkmate
+    if (check_move_error_codes(new_game, player_2_move_start, player_2_move_end).first) {
+        new_game.play_move(player_2_move_start, player_2_move_end);
+    }    
+    new_game.show_board();
+    new_game.swap_current_player();
+    new_game.update_game_state();
+    print_game_state(new_game);
+}
+
+// Executes all of the unit tests for the Chess object - if any fail it will return an integer to describe the number that failed
+int run_game_tests() {
+    int errors = 0;
+
+    // Testing instantiation
+    try {
+        if(!test_create_game()) {
+            cout << "   ERROR: An error occured while attempting to create a new game object" << endl;
+            ++errors;
+        }
+    // Case where deallocation was a problem
+    } catch(exception e) {
+        cout << "   ERROR: test_create_game threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    
+    // Testing stability with many instantiations
+    try {
+        if(!test_creating_many_games()) {
+            cout << "   ERROR: An error occured while attempting to create many game objects" << endl;
+            ++errors;
+        }
+    // Case where deallocation was a problem
+    } catch(exception e) {
+        cout << "   ERROR: test_creating_many_games threw an error: " << e.what() << endl;
+        ++errors;
+    }
+    
+
+    // Testing getting a simple location
+    try {
+        if (!test_getting_rand_location_board_empty()) {
+            cout << "   ERROR: The empty board is not full of invalid pieces" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_getting_rand_location_board_empty threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing that you cannot select outside the bounds
+    try {
+        if (!test_no_access_to_out_of_bounds()) {
+            cout << "   ERROR: The game allowed a selection out-of-bounds" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_no_access_to_out_of_bounds threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    
+    // Testing adding a random piece to the board
+    try {
+        if (!test_adding_piece_to_board()) {
+            cout << "   ERROR: The board was unable to successfully add a new random piece" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_adding_piece_to_board threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing modifying a piece grabbed - ensuring constness from and external source
+    try {
+        if (!test_constness_get_location()) {
+            cout << "   ERROR: The game allowed pieces to be modified externally" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_constness_get_location threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing adding a random piece to the board
+    try {
+        if (!test_adding_piece_to_same_spot()) {
+            cout << "   ERROR: The board allowed a piece to be placed on top of another piece" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_adding_piece_to_same_spot threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing adding many pieces to the board
+    try {
+        if (!test_adding_many_pieces()) {
+            cout << "   ERROR: An issue occured while attempting to add many pieces to the game board" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_adding_many_pieces threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing adding pieces to invalid locations on the board
+    try {
+        if (!test_adding_piece_to_invalid_location()) {
+            cout << "   ERROR: The board allowed a piece to be created outside the board bounds" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_adding_piece_to_invalid_location threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing removing pieces from the game board
+    try {
+        if (!test_removing_piece()) {
+            cout << "   ERROR: The board did not successfully remove the piece" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_removing_piece threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing removing nothing from the game board
+    try {
+        if (!test_removing_no_piece()) {
+            cout << "   ERROR: The game had an issue attempting to remove nothing from the board" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_removing_no_piece threw an error: " << e.what() << endl;
+        ++errors;
+    }
+    
+
+    // Testing removing invalid locations from the board
+    try {
+        if (!test_removing_invalid_locations()) {
+            cout << "   ERROR: The game allowed removal of locations outside the bounds" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_removing_invalid_locations threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the assignment operator to ensure deep copying
+    try {
+        if (!test_assignment_operator() ) {
+            cout << "   ERROR: The game assignment operator did not assign deep data" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_assignment_operator threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the assignment operator to ensure separate data - removal on one copy does not effect the original
+    try {
         if (!test_assignment_operator_piece_removal()) {
             cout << "   ERROR: The game assignment operator does not separate the data" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_assignment_operator_piece_removal threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_assignment_operator_piece_removal threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the copy constructor to ensure deep copying
+    try {
+        if (!test_copy_constructor()) {
+            cout << "   ERROR: The game copy constructor does not perform a deep copy correctly" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_copy_constructor threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    
+    // Testing the copy constructor to ensure separation of data
+    try {
+        if (!test_copy_constructor_removal()) {
+            cout << "   ERROR: The game copy constructor does not partion separate memory for game copies" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_copy_constructor_removal threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the pawns moveset to ensure they can make valid moves
+    try {
+        if (!test_pawn_valid_moves()) {
+            cout << "   ERROR: The pawn was unable to utilize some of its valid moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_pawn_valid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the pawns moveset for invalid moves to ensure they cannot to illegal movess
+    try {
+        if (!test_pawn_invalid_moves()) {
+            cout << "   ERROR: The pawn was able to perform illegal moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_pawn_invalid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the kings moveset for valid moves
+    try {
+        if (!test_king_valid_moves()) {
+            cout << "   ERROR: The king was unable to utilize some of its valid moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_king_valid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the kings moveset for invalid moves to ensure they cannot to illegal movess
+    try {
+        if (!test_king_invalid_moves()) {
+            cout << "   ERROR: The king was able to perform illegal moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_king_invalid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the knights moveset for valid moves - acts as test completeness for restricted pieces
+    try {
+        if (!test_knight_valid_moves()) {
+            cout << "   ERROR: The knight was unable to utilize some of its valid moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_knight_valid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the knights moveset for invalid moves - acts as test completeness for restricted pieces
+    try {
+        if (!test_knight_invalid_moves()) {
+            cout << "   ERROR: The knight was able to perform illegal moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_knight_invalid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the queens moveset for valid moves - acts as test completeness for unrestricted pieces
+    try {
+        if (!test_queen_valid_moves()) {
+            cout << "   ERROR: The queen was unable to utilize some of its moveset" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_queen_valid_moves threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing the queens moveset for invalid moves - acts as test completeness for unrestricted pieces
+    try {
+        if (!test_queen_invalid_moves()) {
+            cout << "   ERROR: The queen was able to perform illegal moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_queen_invalid_moves threw an error: " << e.what() << endl;
         ++errors;
     }
 
 
-    // Testing the copy constructor to ensure deep copying
+    // Testing checkmate to ensure a checkmate can be achieved
     try {
-        if (!test_copy_constructor()) {
-            cout << "   ERROR: The game copy constructor does not perform a deep copy correctly" << endl;
+        if (!test_check_mate()) {
+            cout << "   ERROR: Check mate was note achieved on the Fools Checkmate" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_copy_constructor threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_check_mate threw an error: " << e.what() << endl;
         ++errors;
     }
 
-    
-    // Testing the copy constructor to ensure separation of data
+
+    // Testing checkmate many times for efficieny
     try {
-        if (!test_copy_constructor_removal()) {
-            cout << "   ERROR: The game copy constructor does not partion separate memory for game copies" << endl;
+        int tested_times = 1000;
+        int elapsed_time = test_check_mate_efficieny(tested_times);
+        cout << "TEST RESULTS: The check mate function was able to perform " << tested_times << " tests in a worst case scenario in " << elapsed_time << " microseconds or " << elapsed_time / tested_times << " microseconds per test " << endl;
+    } catch(exception e) {
+        cout << "   ERROR: test_check_mate_efficieny threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+
+    // Testing stalemate to ensure a stalemate can be achieved
+    try {
+        if (!test_stale_mate()) {
+            cout << "   ERROR: Stalemate did not detect the King + Pawn vs King stalemate condition" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_copy_constructor_removal threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_stale_mate threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing the full move list on the default board
+    try {
+        if (!test_valid_moves_default_board()) {
+            cout << "   ERROR: The default board did not generate the twenty opening moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_valid_moves_default_board threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing the pawns moveset to ensure they can make valid moves
+
+    // Testing the retro moves used for the endgame bitbases
     try {
-        if (!test_pawn_valid_moves()) {
-            cout << "   ERROR: The pawn was unable to utilize some of its valid moves" << endl;
+        if (!test_retro_moves()) {
+            cout << "   ERROR: The retro moves did not match the moves that could have been played" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_pawn_valid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_retro_moves threw an error: " << e.what() << endl;
         ++errors;
     }
 
 
-    // Testing the pawns moveset for invalid moves to ensure they cannot to illegal movess
+    // Testing pawn promotion
     try {
-        if (!test_pawn_invalid_moves()) {
-            cout << "   ERROR: The pawn was able to perform illegal moves" << endl;
+        if (!test_pawn_promotion()) {
+            cout << "   ERROR: The pawn was not promoted to a queen on the last row" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_pawn_invalid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_pawn_promotion threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing the generated bitbases
+    try {
+        if (!test_bitbase_generation()) {
+            cout << "   ERROR: The generated bitbases did not give the known results of the positions" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_bitbase_generation threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing the kings moveset for valid moves
+    // Testing the generated KBNK bitbase
     try {
-        if (!test_king_valid_moves()) {
-            cout << "   ERROR: The king was unable to utilize some of its valid moves" << endl;
+        if (!test_kbnk_bitbase()) {
+            cout << "   ERROR: The generated KBNK bitbase did not give the known results of the positions" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_king_valid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_kbnk_bitbase threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing that the computer wins the bitbase endgames
+    try {
+        if (!test_bitbase_conversion()) {
+            cout << "   ERROR: The computer did not turn won bitbase positions into checkmate" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_bitbase_conversion threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing the kings moveset for invalid moves to ensure they cannot to illegal movess
+    // Testing that the thread pool runs every share of a job
     try {
-        if (!test_king_invalid_moves()) {
-            cout << "   ERROR: The king was able to perform illegal moves" << endl;
+        if (!test_thread_pool_run_shares()) {
+            cout << "   ERROR: The thread pool did not run every share exactly once" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_king_invalid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_thread_pool_run_shares threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing that a warmed up search and a bitbase probe don't allocate per node
+    try {
+        if (!test_search_allocations()) {
+            cout << "   ERROR: The search allocated memory that grows with the nodes searched" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_search_allocations threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing the knights moveset for valid moves - acts as test completeness for restricted pieces
+    // Testing that unmaking moves restores the game
     try {
-        if (!test_knight_valid_moves()) {
-            cout << "   ERROR: The knight was unable to utilize some of its valid moves" << endl;
+        if (!test_make_unmake_move()) {
+            cout << "   ERROR: Unmaking a move did not restore the board and its hash key" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_knight_valid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_make_unmake_move threw an error: " << e.what() << endl;
         ++errors;
     }
 
 
-    // Testing the knights moveset for invalid moves - acts as test completeness for restricted pieces
+    // Testing the computers search
     try {
-        if (!test_knight_invalid_moves()) {
-            cout << "   ERROR: The knight was able to perform illegal moves" << endl;
+        if (!test_computer_finds_mate()) {
+            cout << "   ERROR: The computer did not find the mate in one" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_knight_invalid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_computer_finds_mate threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing that pondering doesn't keep the computer alive
+    try {
+        if (!test_ponder_releases_players()) {
+            cout << "   ERROR: The ponder search kept the computer player alive after its owners let go" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_ponder_releases_players threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing the queens moveset for valid moves - acts as test completeness for unrestricted pieces
+    // Testing that the computer never makes up a move
     try {
-        if (!test_queen_valid_moves()) {
-            cout << "   ERROR: The queen was unable to utilize some of its moveset" << endl;
+        if (!test_computer_without_move()) {
+            cout << "   ERROR: The computer played a move without a game or a legal move" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_queen_valid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_computer_without_move threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing threefold repetition
+    try {
+        if (!test_threefold_repetition()) {
+            cout << "   ERROR: Threefold repetition was not found on exactly the third repetition" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_threefold_repetition threw an error: " << e.what() << endl;
         ++errors;
     }
 
 
-    // Testing the queens moveset for invalid moves - acts as test completeness for unrestricted pieces
+    // Testing the halfmove clock for the fifty move rule
     try {
-        if (!test_queen_invalid_moves()) {
-            cout << "   ERROR: The queen was able to perform illegal moves" << endl;
+        if (!test_halfmove_clock()) {
+            cout << "   ERROR: The halfmove clock was not kept through captures, pawn moves and unmaking moves" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_queen_invalid_moves threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_halfmove_clock threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing that sliding pieces are only checked for check where they land
+    try {
+        if (!test_sliding_capture_out_of_check()) {
+            cout << "   ERROR: A sliding piece could not capture the piece checking its king" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_sliding_capture_out_of_check threw an error: " << e.what() << endl;
         ++errors;
     }
 
 
-    // Testing checkmate to ensure a checkmate can be achieved
+    // Testing the search arena used for the computers scratch memory
     try {
-        if (!test_check_mate()) {
-            cout << "   ERROR: Check mate was note achieved on the Fools Checkmate" << endl;
+        if (!test_search_arena()) {
+            cout << "   ERROR: The search arena did not reuse its memory after rewinding and resetting" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_check_mate threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_search_arena threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing the staged move picker used by the search
+    try {
+        if (!test_move_picker()) {
+            cout << "   ERROR: The move picker did not hand out every move once in stage order" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_move_picker threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing checkmate many times for efficieny
+    // Testing the proof-number mate solver
     try {
-        int tested_times = 1000;
-        int elapsed_time = test_check_mate_efficieny(tested_times);
-        cout << "TEST RESULTS: The check mate function was able to perform " << tested_times << " tests in a worst case scenario in " << elapsed_time << " microseconds or " << elapsed_time / tested_times << " microseconds per test " << endl;
+        if (!test_mate_solver()) {
+            cout << "   ERROR: The mate solver did not find the mate in 2 or did not report a missing mate" << endl;
+            ++errors;
+        }
     } catch(exception e) {
-        cout << "   ERROR: test_check_mate_efficieny threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_mate_solver threw an error: " << e.what() << endl;
         ++errors;
     }
 
+    // Testing the Monte Carlo engine
+    try {
+        if (!test_monte_carlo_finds_mate()) {
+            cout << "   ERROR: The Monte Carlo engine did not find the mate in 1" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_monte_carlo_finds_mate threw an error: " << e.what() << endl;
+        ++errors;
+    }
 
-    // Testing stalemate to ensure a stalemate can be achieved
+    // Testing the batch analysis over a thread pool
     try {
-        if (!test_stale_mate()) {
-            cout << "   ERROR: Stalemate did not detect the King + Pawn vs King stalemate condition" << endl;
+        if (!test_analyze_batch()) {
+            cout << "   ERROR: The batch analysis did not return every result in order" << endl;
             ++errors;
         }
     } catch(exception e) {
-        cout << "   ERROR: test_stale_mate threw an error: " << e.what() << endl;
+        cout << "   ERROR: test_analyze_batch threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the hash key kept up to date by make_move
+    try {
+        if (!test_incremental_hash_key()) {
+            cout << "   ERROR: The hash key kept by make_move did not match the key of the same position" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_incremental_hash_key threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing resizing and clearing the transposition table
+    try {
+        if (!test_transposition_table_resize()) {
+            cout << "   ERROR: The transposition table did not keep or forget its entries when cleared and resized" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_transposition_table_resize threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the statistics and info lines reported by a search
+    try {
+        if (!test_search_statistics()) {
+            cout << "   ERROR: The search did not report its statistics or an info line for every iteration" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_search_statistics threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the multi-PV search
+    try {
+        if (!test_multi_pv()) {
+            cout << "   ERROR: The multi-PV search did not find a separate line for each of the best moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_multi_pv threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the evaluation tuner
+    try {
+        if (!test_evaluation_tuner()) {
+            cout << "   ERROR: The evaluation tuner did not read its positions or lower their error" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_evaluation_tuner threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the tournament
+    try {
+        if (!test_tournament()) {
+            cout << "   ERROR: The tournament did not play every game or the SPRT leaned the wrong way" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_tournament threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the weak difficulties
+    try {
+        if (!test_weak_difficulty()) {
+            cout << "   ERROR: The weak difficulties went over their node limits or did not blunder the same way for the same seed" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_weak_difficulty threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing FEN loading and writing
+    try {
+        if (!test_fen()) {
+            cout << "   ERROR: A FEN did not load into the same position or come back out unchanged" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_fen threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the PGN reader
+    try {
+        if (!test_pgn_reader()) {
+            cout << "   ERROR: The PGN reader did not split out the games or play their moves" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_pgn_reader threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the PGN pipeline
+    try {
+        if (!test_pgn_pipeline()) {
+            cout << "   ERROR: The PGN pipeline did not split the file on game boundaries or hand back the same games in order" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_pgn_pipeline threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the game records
+    try {
+        if (!test_game_record()) {
+            cout << "   ERROR: Game records did not come back from the file with the same moves or took more than a byte per move" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_game_record threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the packed positions
+    try {
+        if (!test_packed_position()) {
+            cout << "   ERROR: Packed positions did not come back from the file as the same positions with their scores and results" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_packed_position threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the self-play data generator
+    try {
+        if (!test_data_generator()) {
+            cout << "   ERROR: The data generator did not write every position it reported with the result of its game" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_data_generator threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the EPD suite runner
+    try {
+        if (!test_epd_suite()) {
+            cout << "   ERROR: The EPD suite was not read with its operations or its tactics were not solved" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_epd_suite threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the position index
+    try {
+        if (!test_position_index()) {
+            cout << "   ERROR: The position index did not find the positions with the games they came from and how they ended" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_position_index threw an error: " << e.what() << endl;
+        ++errors;
+    }
+
+    // Testing the opening tree
+    try {
+        if (!test_opening_tree()) {
+            cout << "   ERROR: The opening tree did not count the moves played from each position or play from them" << endl;
+            ++errors;
+        }
+    } catch(exception e) {
+        cout << "   ERROR: test_opening_tree threw an error: " << e.what() << endl;
         ++errors;
     }
 
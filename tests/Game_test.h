@@ -3,12 +3,30 @@
 
 #include "Game.h"
 #include "Human_Player.h"
+#include "Computer_Player.h"
+#include "Move_Picker.h"
+#include "Mate_Solver.h"
+#include "Batch_Analyzer.h"
+#include "Evaluation_Tuner.h"
+#include "Tournament.h"
+#include "PGN_Reader.h"
+#include "PGN_Pipeline.h"
+#include "Game_Record.h"
+#include "Packed_Position.h"
+#include "Data_Generator.h"
+#include "EPD_Suite.h"
+#include "Position_Index.h"
+#include "Opening_Tree.h"
 #include "Chess_API_vars.h"
 
 #include <vector>
 #include <iostream> // cout, endl
 #include <cstdlib>  // rand
 #include <chrono>   // measuring time passed
+#include <fstream>  // ofstream
+#include <filesystem>   // temp_directory_path
+#include <new>          // bad_alloc
+#include <atomic>       // atomic
 
 
 // Executes all of the unit tests for the game object - if any fail it will return an integer to describe the number that failed